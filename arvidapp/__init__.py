@@ -27,7 +27,7 @@ import configparser
 import os.path
 import json
 import itertools
-from collections import defaultdict, MutableSet
+from collections import defaultdict, MutableSet, OrderedDict
 from functools import wraps
 import re
 import atexit
@@ -1280,6 +1280,7 @@ class Environment(object):
         self.includes = []
         self.prolog = []
         self.epilog = []
+        self.prefixes = OrderedDict()
 
     def add_global_annotation(self, key, value):
         self.global_annotations[key].append(value)
@@ -1328,6 +1329,10 @@ class Environment(object):
                     elif ga.name == 'arvida-uid-method':
                         s = str(ga.params[0])
                         self.add_global_annotation('uid-method', s)
+                    elif ga.name == 'arvida-prefix':
+                        prefix = unquote_string_literal(str(ga.params[0]))
+                        uri = unquote_string_literal(str(ga.params[1]))
+                        self.add_global_annotation('prefix', (prefix, uri))
 
             # Class annotations
             cls = self.name_to_class_map.get(a.full_name, None)
@@ -1433,6 +1438,12 @@ class Environment(object):
 
         self.epilog = [unquote_string_literal(s) for s in self.epilog]
 
+        # Collect prefixes, prefixed names with these prefixes are expanded by
+        # the generator
+        self.prefixes = OrderedDict()
+        for prefix, uri in self.global_annotations.get('prefix', []):
+            self.prefixes[prefix] = uri
+
         # Collect all includes
         all_includes = []
         for i in self.global_annotations.get('include', []):
@@ -126,36 +126,60 @@ DEFAULT_PATH_SUBST_LIST = (
     ('$ctx', 'ctx'))
 
 
+ELEMENT_PATH_BUFFER = '_element_path'
+
+
 def subst(str, subst_list):
     for old, new in subst_list:
         str = str.replace(old, new)
     return str
 
 
-def process_path_annotation(path_annotation_list, path_subst_list=DEFAULT_PATH_SUBST_LIST):
-    """Returns tuple (quoted_path, unquoted_path, preprocessed_path)"""
+def process_path_annotation(path_annotation_list, path_subst_list=DEFAULT_PATH_SUBST_LIST, buffer=None):
+    """Returns tuple (quoted_path, unquoted_path, preprocessed_path)
+
+    With a buffer (name of a std::string variable of the generated code) the
+    path is formatted into the buffer, which is reused by each evaluation.
+    """
     paths = [normalize_annotation_value(p) for p in path_annotation_list]
     unquoted_path = paths[-1] if paths else None
     path = arvidapp.quote_string_literal(unquoted_path) if unquoted_path else None
     pp_path = '""'
     if unquoted_path:
-        subst_list = parse_inline_template(unquoted_path)
-        pp_path = ''
-        for i in subst_list:
-            value = ''
-            if isinstance(i, TextValue):
-                value = arvidapp.quote_string_literal(i.value)
-            elif isinstance(i, SubstValue):
-                value = "(" + subst(i.value, path_subst_list) + ")"
-            if len(value):
-                if len(pp_path):
-                    pp_path = 'Arvida::RDF::joinPath(%s,%s)' % (pp_path, value)
-                else:
-                    pp_path = value
+        # Compile the template into a PathFormatter (RDFPath.hpp), a path
+        # without substitutions stays a string literal
+        subst_list = [i for i in parse_inline_template(unquoted_path) if len(i.value)]
+        if len(subst_list) == 1 and isinstance(subst_list[0], TextValue):
+            pp_path = arvidapp.quote_string_literal(subst_list[0].value)
+        elif subst_list:
+            literal_size = 0
+            segments = ''
+            for i in subst_list:
+                if isinstance(i, TextValue):
+                    literal_size += len(i.value)
+                    segments += '.literal(%s)' % arvidapp.quote_string_literal(i.value)
+                elif isinstance(i, SubstValue):
+                    segments += '.value(%s)' % subst(i.value, path_subst_list)
+            if buffer:
+                pp_path = 'Arvida::RDF::PathFormatter(%s, %d)%s.path()' % (buffer, literal_size, segments)
+            else:
+                pp_path = 'Arvida::RDF::PathFormatter(%d)%s.str()' % (literal_size, segments)
 
     return path, unquoted_path, pp_path
 
 
+def expand_prefixed_name(name, prefixes):
+    """Returns quoted IRI of quoted prefixed name, or None if the prefix is not in prefixes"""
+    unquoted_name = arvidapp.unquote_string_literal(name)
+    prefix_pos = unquoted_name.find(':')
+    if prefix_pos < 0:
+        return None
+    uri = prefixes.get(unquoted_name[:prefix_pos])
+    if uri is None:
+        return None
+    return arvidapp.quote_string_literal(uri + unquoted_name[prefix_pos + 1:])
+
+
 def cmp_to_key(mycmp):
     'Convert a cmp= function into a key= function'
 
@@ -215,7 +239,10 @@ class MemberTripleContainer(TemplateObject):
                 self.element_path_type = PathType.ABSOLUTE_PATH
             else:
                 self.absolute_element_path = False
-            self.element_path, self.unquoted_element_path, self.pp_element_path = process_path_annotation(element_paths)
+            # Paths of the elements are formatted into one buffer
+            self.element_path, self.unquoted_element_path, self.pp_element_path = process_path_annotation(
+                element_paths, buffer=ELEMENT_PATH_BUFFER)
+            self.element_path_buffer = ELEMENT_PATH_BUFFER if ELEMENT_PATH_BUFFER in self.pp_element_path else None
             if is_emptystring(self.pp_element_path):
                 self.element_path_type = PathType.NO_PATH
         else:
@@ -225,6 +252,7 @@ class MemberTripleContainer(TemplateObject):
             self.element_path = None
             self.unquoted_element_path = None
             self.pp_element_path = None
+            self.element_path_buffer = None
 
         # RdfCreateElement
         self.create_element = None
@@ -386,9 +414,10 @@ class TripleNode(TemplateObject):
 
 
 class BlankData(object):
-    def __init__(self, label, var_name):
+    def __init__(self, label, var_name, index):
         self.label = label
         self.var_name = var_name
+        self.index = index
 
 
 class Blank(TripleNode):
@@ -408,6 +437,10 @@ class Blank(TripleNode):
     def var_name(self):
         return self.data.var_name
 
+    @property
+    def index(self):
+        return self.data.index
+
     def __repr__(self):
         return 'Blank(%r, %r)' % (self.label, self.var_name)
 
@@ -632,8 +665,9 @@ class Triple(TemplateObject):
 
 
 class TemplateProcessor(object):
-    def __init__(self, template_group):
+    def __init__(self, template_group, schema_tables=False):
         self.template_group = template_group
+        self.schema_tables = schema_tables
 
     def propagate_annotation(self, cls, annotation_name, annotation_value):
         cls_annotation_value = cls.annotations.get(annotation_name, None)
@@ -714,7 +748,7 @@ class TemplateProcessor(object):
             def create_blank(elem, id_gen):
                 blank_data = cls.blanks.get(elem, None)
                 if blank_data is None:
-                    blank_data = BlankData(elem, "_b%d" % (cls.blank_id,))
+                    blank_data = BlankData(elem, "_b%d" % (cls.blank_id,), cls.blank_id)
                     cls.blanks[elem] = blank_data
                     cls.blank_id += 1
                 return Blank(blank_data, id=next(id_gen))
@@ -735,7 +769,12 @@ class TemplateProcessor(object):
                     elif "://" in elem:
                         new_triple[index] = IRI(elem, id=next(id_gen))
                     elif ":" in elem:
-                        new_triple[index] = PrefixedName(elem, id=next(id_gen))
+                        # Prefixes declared with arvida_prefix are expanded here
+                        iri = expand_prefixed_name(elem, environment.prefixes)
+                        if iri is not None:
+                            new_triple[index] = IRI(iri, id=next(id_gen))
+                        else:
+                            new_triple[index] = PrefixedName(elem, id=next(id_gen))
                     else:
                         raise Exception('Unknown element in triple annotation: %s' % elem)
                 return new_triple
@@ -768,8 +807,82 @@ class TemplateProcessor(object):
                 cls.has_element_refs |= len(mtc.member_element_triples) > 0
                 cls.mtcs.append(mtc)
 
-
-def generate_from_template(environment, template_name, template_dir):
+            # Schema tables are interpreted by the engine of RDFSchema.hpp,
+            # which does not iterate containers
+            cls.use_schema = self.schema_tables and len(cls.mtcs) > 0 and not cls.has_element_refs
+
+            # Skeleton: constant triples written for every object, i.e. the
+            # triples of writer MTCs without $that references. They are added
+            # in one operation from a precomputed table.
+            cls.skeleton_mtcs = [mtc for mtc in cls.mtcs
+                                 if mtc.is_for_writer() and not mtc.has_that_or_that_element_ref()]
+            cls.skeleton_triples = [triple for mtc in cls.skeleton_mtcs for triple in mtc.triples]
+            cls.use_skeleton = not cls.use_schema and len(cls.skeleton_triples) > 1
+
+            # Member ids for partial serialization and deserialization
+            # (Members<T>, projections, fromRDF with a member mask), one per
+            # member name. A writer MTC is written when the mask contains its
+            # id. A reader MTC is read when the mask contains its own id or
+            # the id of a later MTC which uses a blank node bound first by it.
+            # Class triples and members beyond 64 are always read and written.
+            cls.member_names = []
+            for mtc in cls.mtcs:
+                mtc.member_id = None
+                if mtc.member is None:
+                    continue
+                if mtc.member.name in cls.member_names:
+                    mtc.member_id = cls.member_names.index(mtc.member.name)
+                elif len(cls.member_names) < 64:
+                    mtc.member_id = len(cls.member_names)
+                    cls.member_names.append(mtc.member.name)
+            blank_binders = {}
+            for mtc in cls.mtcs:
+                mtc.read_mask_ids = []
+                mtc.always_read = False
+                if not mtc.is_for_reader():
+                    continue
+                if mtc.member_id is not None:
+                    mtc.read_mask_ids.append(mtc.member_id)
+                for triple in mtc.triples:
+                    for node in triple:
+                        if not node.is_blank_node():
+                            continue
+                        binder = blank_binders.setdefault(node.label, mtc)
+                        if binder is mtc or binder.member_id is None:
+                            continue
+                        if mtc.member_id is None:
+                            binder.always_read = True
+                        elif mtc.member_id not in binder.read_mask_ids:
+                            binder.read_mask_ids.append(mtc.member_id)
+            for mtc in cls.mtcs:
+                if mtc.always_read:
+                    mtc.read_mask_ids = []
+            cls.has_writer_members = any(mtc.member_id is not None and mtc.is_for_writer() for mtc in cls.mtcs)
+
+            # Members covered by the structural hash and equality (RDFHash.hpp)
+            cls.hash_mtcs = [mtc for mtc in cls.mtcs
+                             if mtc.member and mtc.is_for_writer() and mtc.has_that_or_that_element_ref()]
+            # Expressions of the object which determine its node IRI: the uid
+            # method or the substitutions of the class path and of member paths
+            # which refer to $this. Values of $that and $element are already
+            # covered by the members, $ctx does not depend on the object.
+            if cls.uid_method:
+                cls.hash_path_exprs = ['$this->%s()' % cls.uid_method[0]]
+            else:
+                paths = [cls.unquoted_path]
+                for mtc in cls.mtcs:
+                    if mtc.member and mtc.is_for_writer():
+                        paths += [mtc.unquoted_path, mtc.unquoted_element_path]
+                cls.hash_path_exprs = []
+                for path in paths:
+                    for i in parse_inline_template(path) if path else []:
+                        if (isinstance(i, SubstValue) and '$this' in i.value and
+                                not any(var in i.value for var in ('$that', '$element', '$ctx')) and
+                                i.value not in cls.hash_path_exprs):
+                            cls.hash_path_exprs.append(i.value)
+
+
+def create_template_environment(template_dir):
     loader = jinja2.FileSystemLoader(template_dir)
     tmpl_env = jinja2.Environment(loader=loader,
                                   keep_trailing_newline=True,  # newline-terminate generated files
@@ -777,9 +890,23 @@ def generate_from_template(environment, template_name, template_dir):
                                   trim_blocks=True)  # so don't need {%- -%} everywhere
 
     tmpl_env.tests['emptystring'] = is_emptystring
-    tmpl = tmpl_env.get_template(template_name)
+    return tmpl_env
+
+
+def is_generation_template(template_name, template_dir):
+    """Returns True if the template exists and defines the main macro, templates like hash only
+    define macros imported by other templates"""
+    try:
+        tmpl = create_template_environment(template_dir).get_template(template_name)
+    except jinja2.TemplateNotFound:
+        return False
+    return getattr(tmpl.module, 'main', None) is not None
+
+
+def generate_from_template(environment, template_name, template_dir, schema_tables=False):
+    tmpl = create_template_environment(template_dir).get_template(template_name)
 
-    processor = TemplateProcessor(tmpl)
+    processor = TemplateProcessor(tmpl, schema_tables=schema_tables)
 
     processor.process_environment(environment)
 
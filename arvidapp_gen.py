@@ -87,6 +87,10 @@ def main():
                              "(not just those specified on the command line)")
     parser.add_argument("--non-system-headers", action="store_true",
                         help="write dump for all non-system header files encountered")
+    parser.add_argument("--schema-tables", action="store_true",
+                        help="generate constexpr schema tables and interpret them by the"
+                             " generic engine instead of inlining the code of each member"
+                             " (classes with container elements are still inlined)")
     parser.add_argument("--dump", action="store_true",
                         help="dump parsed database")
     parser.add_argument("args", nargs="+", help=argparse.SUPPRESS)
@@ -104,6 +108,12 @@ def main():
 
     config_filename = os.path.join(tool_dir, 'arvidapp.cfg')
 
+    template_name = args.template + '.cpp'
+    template_dir = os.path.join(tool_dir, 'templates')
+    if not arvidapp.generator.is_generation_template(template_name, template_dir):
+        error("Unknown template '%s' (templates which only define macros for other templates,"
+              " like hash, cannot be selected)" % args.template)
+
     try:
         start = time.time()
         trans_unit = arvidapp.build_translation_unit(config_filename, args.compiler_command_line)
@@ -126,10 +136,8 @@ def main():
         trans_unit.cursor,
         cursor_filter=lambda c: should_process_file(c.location.file, source_files))
 
-    template_name = args.template + '.cpp'
-    template_dir = os.path.join(tool_dir, 'templates')
-
-    rendered = arvidapp.generator.generate_from_template(environment, template_name, template_dir)
+    rendered = arvidapp.generator.generate_from_template(environment, template_name, template_dir,
+                                                         schema_tables=args.schema_tables)
 
     if args.dump:
         sys.stderr.write(environment.dump() + '\n')
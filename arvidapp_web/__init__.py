@@ -164,6 +164,22 @@ ARVIDAPP_ANNOTATION_HEADER = 'arvida_pp_annotation.h'
 
 POPULATE_FILES = [
     # Dest Source
+    ('include/NTriplesParser.hpp', '{ARVIDAPP_INCLUDE_DIR}/NTriplesParser.hpp'),
+    ('include/NTriplesReader.hpp', '{ARVIDAPP_INCLUDE_DIR}/NTriplesReader.hpp'),
+    ('include/NTriplesRDFTraits.hpp', '{ARVIDAPP_INCLUDE_DIR}/NTriplesRDFTraits.hpp'),
+    ('include/JsonLdParser.hpp', '{ARVIDAPP_INCLUDE_DIR}/JsonLdParser.hpp'),
+    ('include/JsonLdRDFTraits.hpp', '{ARVIDAPP_INCLUDE_DIR}/JsonLdRDFTraits.hpp'),
+    ('include/RDFBinary.hpp', '{ARVIDAPP_INCLUDE_DIR}/RDFBinary.hpp'),
+    ('include/BinaryRDFTraits.hpp', '{ARVIDAPP_INCLUDE_DIR}/BinaryRDFTraits.hpp'),
+    ('include/RDFHash.hpp', '{ARVIDAPP_INCLUDE_DIR}/RDFHash.hpp'),
+    ('include/RDFLazy.hpp', '{ARVIDAPP_INCLUDE_DIR}/RDFLazy.hpp'),
+    ('include/RDFProjection.hpp', '{ARVIDAPP_INCLUDE_DIR}/RDFProjection.hpp'),
+    ('include/RDFStringRef.hpp', '{ARVIDAPP_INCLUDE_DIR}/RDFStringRef.hpp'),
+    ('include/RDFPath.hpp', '{ARVIDAPP_INCLUDE_DIR}/RDFPath.hpp'),
+    ('include/RDFSchema.hpp', '{ARVIDAPP_INCLUDE_DIR}/RDFSchema.hpp'),
+    ('include/RDFTerm.hpp', '{ARVIDAPP_INCLUDE_DIR}/RDFTerm.hpp'),
+    ('include/FlatRDFStore.hpp', '{ARVIDAPP_INCLUDE_DIR}/FlatRDFStore.hpp'),
+    ('include/FlatRDFTraits.hpp', '{ARVIDAPP_INCLUDE_DIR}/FlatRDFTraits.hpp'),
     ('include/RedlandRDFTraits.hpp', '{ARVIDAPP_INCLUDE_DIR}/RedlandRDFTraits.hpp'),
     ('include/SordRDFTraits.hpp', '{ARVIDAPP_INCLUDE_DIR}/SordRDFTraits.hpp'),
     ('include/arvida_pp_annotation.h', '{ARVIDAPP_INCLUDE_DIR}/arvida_pp_annotation.h'),
@@ -205,7 +221,7 @@ class Task(object):
 
     @property
     def template_backends(self):
-        return ['sord', 'redland']
+        return ['sord', 'redland', 'ntriples', 'jsonld', 'binary', 'flat']
 
     def get_str_id(self):
         return str(self.guid)
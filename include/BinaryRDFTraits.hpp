@@ -0,0 +1,549 @@
+/*  ARVIDAPP - ARVIDA C++ Preprocessor
+ *
+ *  Copyright (C) 2015-2019 German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef BINARY_RDF_TRAITS_HPP_INCLUDED
+#define BINARY_RDF_TRAITS_HPP_INCLUDED
+
+#include "NTriplesReader.hpp"
+#include "RDFBinary.hpp"
+#include "RDFProjection.hpp"
+#include "RDFPath.hpp"
+#include <memory>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <type_traits>
+#include <cstdio>
+
+// Traits for the binary template: generated code writes the binary RDF
+// format of RDFBinary.hpp without an RDF library. Nodes are dictionary keys,
+// literal values are not converted to nodes, numbers are written as raw
+// IEEE values. Generated readers are shared with the ntriples template,
+// BinaryRDFGraph converts the stream into their table of terms.
+
+namespace Arvida {
+namespace RDF {
+
+typedef std::string Node;
+typedef const std::string & NodeRef;
+
+// Output document
+//
+// Holds the buffer and the writer. Vocabulary keys are expanded once per
+// document, so the document should be reused (see clear()).
+
+class Document
+{
+public:
+
+    std::string out;
+
+    explicit Document(const Prefixes &prefixes = Prefixes())
+        : writer(out)
+        , prefixes_(prefixes)
+        , nextBlank_(0)
+    { }
+
+    BinaryRDFWriter writer;
+
+    const Prefixes & prefixes() const { return prefixes_; }
+
+    // Returns key of prefixed name or absolute IRI. Keys are cached by
+    // address, so name must be a string literal.
+    const std::string & term(const char *name)
+    {
+        std::string &result = terms_[name];
+        if (result.empty())
+        {
+            const std::string str(name);
+            const size_t colon = str.find(':');
+            Prefixes::const_iterator it = prefixes_.end();
+            if (colon != std::string::npos && str.compare(colon, 3, "://") != 0)
+                it = prefixes_.find(str.substr(0, colon));
+            const std::string iri = it != prefixes_.end() ? it->second + str.substr(colon + 1) : str;
+            result = binaryIRIKey(iri.data(), iri.size());
+        }
+        return result;
+    }
+
+    Node blank()
+    {
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "b%lu", ++nextBlank_);
+        return binaryBlankKey(buf);
+    }
+
+    // Returns false when node was already serialized into this document
+    bool insertNode(const Node &node)
+    {
+        return nodes_.insert(node).second;
+    }
+
+    // Ends the document in the stream, the next value starts a new one
+    void end()
+    {
+        writer.end();
+        nodes_.clear();
+        nextBlank_ = 0;
+    }
+
+    // Clears output and dictionary, keeps expanded keys
+    void clear()
+    {
+        out.clear();
+        writer.reset();
+        nodes_.clear();
+        nextBlank_ = 0;
+    }
+
+private:
+    Prefixes prefixes_;
+    std::unordered_map<const char *, std::string> terms_;
+    std::unordered_set<std::string> nodes_;
+    unsigned long nextBlank_;
+};
+
+struct Context
+{
+    Document &doc;
+    const std::string &base_path;
+    const std::string &path;
+    Cache *cache;
+    const void *user_data;
+    // Projection of toRDF (see RDFProjection.hpp) and depth of the object
+    // serialized with this context
+    const Projection *projection;
+    unsigned depth;
+
+    Context(Document &doc, const std::string &base_path, const std::string &path, Cache *cache = 0, const void *user_data = 0) : doc(doc), base_path(base_path), path(path), cache(cache), user_data(user_data), projection(0), depth(0) { }
+    Context(Document &doc, const std::string &path, Cache *cache = 0, const void *user_data = 0) : doc(doc), base_path(path), path(path), cache(cache), user_data(user_data), projection(0), depth(0) { }
+    Context(const Context &ctx) : doc(ctx.doc), base_path(ctx.base_path), path(ctx.path), cache(ctx.cache), user_data(ctx.user_data), projection(ctx.projection), depth(ctx.depth) { }
+    Context(const Context &ctx, const std::string &path) : doc(ctx.doc), base_path(ctx.base_path), path(path), cache(ctx.cache), user_data(ctx.user_data), projection(ctx.projection), depth(ctx.depth) { }
+};
+
+template <class T>
+inline bool isValidValue(const T &value)
+{
+    return true;
+}
+
+template < class T >
+inline bool isValidValue(const std::shared_ptr<T> &value)
+{
+    return value.operator bool();
+}
+
+// Literals
+
+template <class T>
+struct IsLiteral : std::false_type { };
+
+template <>
+struct IsLiteral<double> : std::true_type { };
+
+template <>
+struct IsLiteral<float> : std::true_type { };
+
+template <>
+struct IsLiteral<std::string> : std::true_type { };
+
+// Reference to a literal value, used as node
+template <class T>
+struct LiteralRef
+{
+    const T &value;
+
+    explicit LiteralRef(const T &value) : value(value) { }
+};
+
+inline void writeObject(BinaryRDFWriter &writer, const Node &node)
+{
+    writer.writeKey(node);
+}
+
+inline void writeObject(BinaryRDFWriter &writer, const LiteralRef<double> &literal)
+{
+    writer.writeDouble(literal.value);
+}
+
+inline void writeObject(BinaryRDFWriter &writer, const LiteralRef<float> &literal)
+{
+    writer.writeFloat(literal.value);
+}
+
+inline void writeObject(BinaryRDFWriter &writer, const LiteralRef<std::string> &literal)
+{
+    writer.writeKey(binaryStringKey(literal.value));
+}
+
+template <class O>
+inline void writeTriple(const Context &ctx, const Node &subject, const Node &predicate, const O &object)
+{
+    BinaryRDFWriter &writer = ctx.doc.writer;
+    writer.writeKey(subject);
+    writer.writeKey(predicate);
+    writeObject(writer, object);
+}
+
+// PathType
+
+enum PathType
+{
+    NO_PATH, RELATIVE_PATH, RELATIVE_TO_BASE_PATH, ABSOLUTE_PATH
+};
+
+// uidOf
+
+template<class T>
+inline std::string uidOf(const Context &ctx, const T &value)
+{
+    return value.getUid();
+}
+
+// pathOf_impl, pathTypeOf_impl
+
+template<class T>
+inline std::string pathOf_impl(const Context &ctx, const T &value)
+{
+    return uidOf(ctx, value);
+}
+
+template<class T>
+inline PathType pathTypeOf_impl(const Context &ctx, const T &value)
+{
+    return RELATIVE_TO_BASE_PATH;
+}
+
+// pathOf
+
+template<class T>
+inline std::string pathOf(const Context &ctx, const T &value)
+{
+    return pathOf_impl(ctx, value);
+}
+
+template<class T>
+inline std::string pathOf(const Context &ctx, const std::shared_ptr<T> &value)
+{
+    if (value)
+        return pathOf(ctx, *value);
+    else
+        return "";
+}
+
+template<class T>
+inline PathType pathTypeOf(const Context &ctx, const T &value)
+{
+    return pathTypeOf_impl(ctx, value);
+}
+
+template<class T>
+inline PathType pathTypeOf(const Context &ctx, const std::shared_ptr<T> &value)
+{
+    if (value)
+        return pathTypeOf(ctx, *value);
+    else
+        return NO_PATH;
+}
+
+template<>
+inline std::string pathOf(const Context &ctx, const double &value)
+{
+    return "";
+}
+
+template<>
+inline PathType pathTypeOf(const Context &ctx, const double &value)
+{
+    return NO_PATH;
+}
+
+template<>
+inline std::string pathOf(const Context &ctx, const float &value)
+{
+    return "";
+}
+
+template<>
+inline PathType pathTypeOf(const Context &ctx, const float &value)
+{
+    return NO_PATH;
+}
+
+template<>
+inline std::string pathOf(const Context &ctx, const std::string &value)
+{
+    return "";
+}
+
+template<>
+inline PathType pathTypeOf(const Context &ctx, const std::string &value)
+{
+    return NO_PATH;
+}
+
+template<class T>
+inline std::string pathOf(const Context &ctx, const std::vector<T> &value)
+{
+    return "";
+}
+
+template<class T>
+inline PathType pathTypeOf(const Context &ctx, const std::vector<T> &value)
+{
+    return RELATIVE_PATH;
+}
+
+inline std::string joinPath(const std::string &path1, const std::string path2)
+{
+    if (path2.empty())
+        return path1;
+    if (path1.empty())
+        return path2;
+
+    const char p1b = path1.back();
+    const char p2f = path2.front();
+
+    if (p1b == '/' && p2f == '/') {
+        return path1.substr(0, path1.size()-1) + path2;
+    } else if (p1b != '/' && p2f != '/') {
+        return path1 + '/' + path2;
+    } else {
+        return path1 + path2;
+    }
+}
+
+inline std::string resolvePath(const Context &ctx, PathType thatPathType, const std::string &thatPathOf,
+                               PathType memberPathType, const std::string &memberPath)
+{
+    if (thatPathType == ABSOLUTE_PATH)
+        return thatPathOf;
+    if (thatPathType == RELATIVE_TO_BASE_PATH)
+    {
+        std::string thatPath;
+        joinPathInto(thatPath, ctx.base_path, thatPathOf);
+        return thatPath;
+    }
+
+    std::string thatPath;
+    switch (memberPathType)
+    {
+        case NO_PATH:
+            thatPath = ctx.path;
+            break;
+        case RELATIVE_PATH:
+            joinPathInto(thatPath, ctx.path, memberPath);
+            break;
+        case RELATIVE_TO_BASE_PATH:
+            joinPathInto(thatPath, ctx.base_path, memberPath);
+            break;
+        case ABSOLUTE_PATH:
+            thatPath = memberPath;
+            break;
+    }
+    if (thatPathType == RELATIVE_PATH)
+        appendPath(thatPath, thatPathOf);
+    return thatPath;
+}
+
+inline Node uriNode(const std::string &uri)
+{
+    return binaryIRIKey(uri.data(), uri.size());
+}
+
+// createRDFNode
+
+template<class T>
+Node createRDFNode(const Context &ctx, const T &value, PathType memberPathType, const std::string &memberPath)
+{
+    const PathType thatPathType = pathTypeOf(ctx, value);
+    if (thatPathType == NO_PATH)
+        return ctx.doc.blank();
+    return uriNode(resolvePath(ctx, thatPathType, pathOf(ctx, value), memberPathType, memberPath));
+}
+
+template<class T>
+LiteralRef<T> createRDFNodeAndSerialize(const Context &ctx, const T &value, PathType memberPathType, const std::string &memberPath, std::true_type)
+{
+    return LiteralRef<T>(value);
+}
+
+template<class T>
+Node createRDFNodeAndSerialize(const Context &ctx, const T &value, PathType memberPathType, const std::string &memberPath, std::false_type)
+{
+    const PathType thatPathType = pathTypeOf(ctx, value);
+    if (thatPathType == NO_PATH)
+    {
+        Node thatNode(ctx.doc.blank());
+        if (!IsNestedObject<T>::value || !ctx.projection)
+            toRDF(ctx, thatNode, value);
+        else if (!projectionCut(ctx))
+        {
+            Arvida::RDF::Context thatCtx(ctx);
+            ++thatCtx.depth;
+            toRDF(thatCtx, thatNode, value);
+        }
+        return thatNode;
+    }
+    else
+    {
+        const std::string thatPath = resolvePath(ctx, thatPathType, pathOf(ctx, value), memberPathType, memberPath);
+        Arvida::RDF::Context thatCtx(ctx, thatPath);
+        ++thatCtx.depth;
+        Node thatNode(uriNode(thatPath));
+        if (!projectionCut(ctx) && ctx.doc.insertNode(thatNode))
+            toRDF(thatCtx, thatNode, value);
+        return thatNode;
+    }
+}
+
+template<class T>
+auto createRDFNodeAndSerialize(const Context &ctx, const T &value, PathType memberPathType, const std::string &memberPath)
+    -> decltype(createRDFNodeAndSerialize(ctx, value, memberPathType, memberPath, typename IsLiteral<T>::type()))
+{
+    return createRDFNodeAndSerialize(ctx, value, memberPathType, memberPath, typename IsLiteral<T>::type());
+}
+
+// toRDF
+
+template < class T >
+inline NodeRef toRDF(const Context &ctx, NodeRef thisNode, const T &value)
+{
+    return value.toRDF(ctx, thisNode);
+}
+
+template < class T >
+inline NodeRef toRDF(const Context &ctx, NodeRef thisNode, const std::shared_ptr<T> &value)
+{
+    if (value)
+        return toRDF(ctx, thisNode, *value);
+    return thisNode;
+}
+
+template < class T >
+inline NodeRef toRDF(const Context &ctx, NodeRef thisNode, const std::vector<T> &value)
+{
+    writeTriple(ctx, thisNode, ctx.doc.term("rdf:type"), ctx.doc.term("core:Container"));
+
+    for (auto it = std::begin(value); it != std::end(value); ++it)
+    {
+        const auto & _that = *it;
+        if (isValidValue(_that))
+            writeTriple(ctx, thisNode, ctx.doc.term("core:member"), createRDFNodeAndSerialize(ctx, _that, NO_PATH, ""));
+    }
+    return thisNode;
+}
+
+// Table of terms read from the stream, used by the generated readers
+
+class BinaryRDFGraph
+{
+public:
+
+    // Reads the next document of the stream, returns false on error (see
+    // error()). A document which is not ended is read up to its last
+    // complete triple.
+    bool parse(BinaryRDFReader &reader)
+    {
+        clear();
+        std::vector<TripleView> triples;
+        BinaryTermRef triple[3];
+        BinaryRDFReader::Status status;
+        while ((status = reader.next(triple)) == BinaryRDFReader::TRIPLE)
+            triples.push_back(TripleView(view(triple[0]), view(triple[1]), view(triple[2])));
+        if (status == BinaryRDFReader::ERROR)
+        {
+            error_ = reader.error();
+            return false;
+        }
+        graph_.assign(triples);
+        return true;
+    }
+
+    bool parse(const char *data, size_t size)
+    {
+        BinaryRDFReader reader;
+        reader.feed(data, size);
+        return parse(reader);
+    }
+
+    bool parse(const std::string &data)
+    {
+        return parse(data.data(), data.size());
+    }
+
+    void clear()
+    {
+        graph_.clear();
+        terms_.clear();
+        views_.clear();
+        error_.clear();
+    }
+
+    const Graph & graph() const { return graph_; }
+
+    const std::string & error() const { return error_; }
+
+private:
+
+    // Dictionary terms are formatted once
+    TermView view(const BinaryTermRef &ref)
+    {
+        if (ref.id != BinaryTermRef::NO_ID && ref.id < views_.size() && views_[ref.id].is_valid())
+            return views_[ref.id];
+        std::string term;
+        appendNTriplesTerm(term, *ref.term);
+        const TermView result(*terms_.insert(term).first);
+        if (ref.id != BinaryTermRef::NO_ID)
+        {
+            if (ref.id >= views_.size())
+                views_.resize(ref.id + 1);
+            views_[ref.id] = result;
+        }
+        return result;
+    }
+
+    Graph graph_;
+    std::unordered_set<std::string> terms_; // elements are not moved on rehash
+    std::vector<TermView> views_;
+    std::string error_;
+};
+
+// Reads value with path as subject from the parsed document
+
+template <class T>
+bool readBinaryRDF(const BinaryRDFGraph &graph, Vocabulary &vocabulary, const std::string &path, T &value, Cache *cache = 0, const void *user_data = 0)
+{
+    return readNTriples(graph.graph(), vocabulary, path, value, cache, user_data);
+}
+
+// Writes value with path as subject into the document
+
+template <class T>
+void writeBinaryRDF(Document &doc, const std::string &path, const T &value, Cache *cache = 0, const void *user_data = 0)
+{
+    Context ctx(doc, path, cache, user_data);
+    Node thisNode(uriNode(path));
+    doc.insertNode(thisNode);
+    toRDF(ctx, thisNode, value);
+}
+
+} // namespace RDF
+} // namespace Arvida
+
+#endif
@@ -0,0 +1,463 @@
+/*  ARVIDAPP - ARVIDA C++ Preprocessor
+ *
+ *  Copyright (C) 2015-2019 German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef FLAT_RDF_STORE_HPP_INCLUDED
+#define FLAT_RDF_STORE_HPP_INCLUDED
+
+#include "RDFTerm.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace Arvida
+{
+namespace RDF
+{
+namespace Flat
+{
+
+// In-memory triple store without an RDF library
+//
+// Terms are interned once into a dictionary and referenced by 32-bit ids,
+// statements are id triples kept in two sorted arrays (SPO and OPS) plus a
+// hash set for duplicate checks and fully bound lookups. Added statements
+// are collected unsorted and merged into the arrays by the next query, so
+// serialization only appends. Since queries may merge, a model shared by
+// concurrent readers must be flushed first.
+
+struct Node
+{
+    uint32_t id;
+    Term::Type type;
+
+    Node() : id(0), type(Term::NONE) { }
+
+    Node(uint32_t id, Term::Type type) : id(id), type(type) { }
+
+    bool is_valid() const { return id != 0; }
+
+    bool is_uri() const { return type == Term::URI; }
+
+    bool is_blank() const { return type == Term::BLANK; }
+
+    bool is_literal() const { return type == Term::LITERAL; }
+
+    bool operator==(const Node &other) const { return id == other.id; }
+
+    bool operator!=(const Node &other) const { return id != other.id; }
+};
+
+struct Triple
+{
+    Node subject;
+    Node predicate;
+    Node object;
+
+    Triple() { }
+
+    Triple(const Node &subject, const Node &predicate, const Node &object)
+        : subject(subject), predicate(predicate), object(object)
+    { }
+
+    bool is_valid() const
+    {
+        return subject.is_valid() && predicate.is_valid() && object.is_valid();
+    }
+};
+
+class Model
+{
+public:
+
+    explicit Model(const std::string &base_uri = std::string())
+        : base_uri_(base_uri), nextBlank_(0)
+    {
+        clearTerms();
+    }
+
+    const std::string & base_uri() const { return base_uri_; }
+
+    void add_prefix(const std::string &name, const std::string &uri)
+    {
+        prefixes_[name] = uri;
+        curies_.clear();
+    }
+
+    const std::map<std::string, std::string> & prefixes() const { return prefixes_; }
+
+    // Terms
+
+    Node intern(const Term &term)
+    {
+        if (!term.is_valid())
+            return Node();
+        const std::string key = termKey(term.type, term.value, term.datatype, term.language);
+        std::unordered_map<std::string, uint32_t>::const_iterator it = ids_.find(key);
+        if (it != ids_.end())
+            return Node(it->second, term.type);
+        const uint32_t id = static_cast<uint32_t>(terms_.size());
+        ids_.emplace(key, id);
+        terms_.push_back(term);
+        uses_.push_back(0);
+        return Node(id, term.type);
+    }
+
+    Node uri(const std::string &uri)
+    {
+        return intern(Term(Term::URI, uri));
+    }
+
+    // Expands prefixed name, returns invalid node for an unknown prefix.
+    // Results are cached by the address of name, pass string literals.
+    Node curie(const char *name)
+    {
+        std::unordered_map<const char *, Node>::const_iterator it = curies_.find(name);
+        if (it != curies_.end())
+            return it->second;
+        const Node node = curie(std::string(name));
+        curies_.emplace(name, node);
+        return node;
+    }
+
+    // Absolute IRI, cached by the address of uri like curie()
+    Node iri(const char *uri)
+    {
+        std::unordered_map<const char *, Node>::const_iterator it = curies_.find(uri);
+        if (it != curies_.end())
+            return it->second;
+        const Node node = this->uri(uri);
+        curies_.emplace(uri, node);
+        return node;
+    }
+
+    Node curie(const std::string &name)
+    {
+        const size_t colon = name.find(':');
+        if (colon == std::string::npos)
+            return Node();
+        std::map<std::string, std::string>::const_iterator it = prefixes_.find(name.substr(0, colon));
+        if (it == prefixes_.end())
+            return Node();
+        return uri(it->second + name.substr(colon + 1));
+    }
+
+    // Creates blank node with a new label
+    Node blank()
+    {
+        std::string label;
+        do
+        {
+            label = "b" + std::to_string(++nextBlank_);
+        } while (ids_.count(termKey(Term::BLANK, label, std::string(), std::string())));
+        return intern(Term(Term::BLANK, label));
+    }
+
+    Node blank(const std::string &label)
+    {
+        return intern(Term(Term::BLANK, label));
+    }
+
+    Node literal(const std::string &value, const std::string &datatype = std::string(), const std::string &language = std::string())
+    {
+        return intern(Term(Term::LITERAL, value, datatype, language));
+    }
+
+    // Returns node of an interned term, or invalid node
+    Node find(const Term &term) const
+    {
+        std::unordered_map<std::string, uint32_t>::const_iterator it =
+            ids_.find(termKey(term.type, term.value, term.datatype, term.language));
+        return it != ids_.end() ? Node(it->second, term.type) : Node();
+    }
+
+    const Term & term(const Node &node) const { return terms_[node.id]; }
+
+    size_t termCount() const { return terms_.size() - 1; }
+
+    // Statements
+
+    // Returns false for invalid nodes and statements already in the model
+    bool add_statement(const Node &subject, const Node &predicate, const Node &object)
+    {
+        if (!subject.is_valid() || !predicate.is_valid() || !object.is_valid())
+            return false;
+        const Key key = { { subject.id, predicate.id, object.id } };
+        if (!statements_.insert(key).second)
+            return false;
+        pending_.push_back(key);
+        ++uses_[subject.id];
+        ++uses_[predicate.id];
+        ++uses_[object.id];
+        return true;
+    }
+
+    // Adds count statements at once, returns the number of new statements
+    size_t add_statements(const Triple *triples, size_t count)
+    {
+        pending_.reserve(pending_.size() + count);
+        size_t added = 0;
+        for (size_t i = 0; i < count; ++i)
+            added += add_statement(triples[i].subject, triples[i].predicate, triples[i].object);
+        return added;
+    }
+
+    bool contains(const Node &subject, const Node &predicate, const Node &object) const
+    {
+        const Key key = { { subject.id, predicate.id, object.id } };
+        return statements_.count(key) != 0;
+    }
+
+    // Whether node is used in any statement
+    bool contains(const Node &node) const
+    {
+        return node.is_valid() && node.id < uses_.size() && uses_[node.id] != 0;
+    }
+
+    size_t size() const { return statements_.size(); }
+
+    bool empty() const { return statements_.empty(); }
+
+    Triple find_triple(const Node &subject, const Node &predicate, const Node &object) const
+    {
+        Triple result;
+        visit(subject, predicate, object, [&result](const Triple &triple) { result = triple; return false; });
+        return result;
+    }
+
+    std::vector<Triple> find_triples(const Node &subject, const Node &predicate, const Node &object) const
+    {
+        std::vector<Triple> result;
+        visit(subject, predicate, object, [&result](const Triple &triple) { result.push_back(triple); return true; });
+        return result;
+    }
+
+    // Calls function with matching statements until it returns false,
+    // invalid nodes match everything
+    template <class Function>
+    void visit(const Node &subject, const Node &predicate, const Node &object, Function function) const
+    {
+        if (subject.is_valid() && predicate.is_valid() && object.is_valid())
+        {
+            if (contains(subject, predicate, object))
+                function(Triple(subject, predicate, object));
+            return;
+        }
+        flush();
+        if (subject.is_valid())
+        {
+            // Prefix (s) or (s, p) of SPO, object is filtered
+            const uint32_t prefix[2] = { subject.id, predicate.id };
+            const std::pair<const Key *, const Key *> range = equalRange(spo_, prefix, predicate.is_valid() ? 2 : 1);
+            for (const Key *it = range.first; it != range.second; ++it)
+            {
+                if (object.is_valid() && it->id[2] != object.id)
+                    continue;
+                if (!function(triple(it->id[0], it->id[1], it->id[2])))
+                    return;
+            }
+        }
+        else if (object.is_valid())
+        {
+            // Prefix (o) or (o, p) of OPS
+            const uint32_t prefix[2] = { object.id, predicate.id };
+            const std::pair<const Key *, const Key *> range = equalRange(ops_, prefix, predicate.is_valid() ? 2 : 1);
+            for (const Key *it = range.first; it != range.second; ++it)
+            {
+                if (!function(triple(it->id[2], it->id[1], it->id[0])))
+                    return;
+            }
+        }
+        else
+        {
+            for (std::vector<Key>::const_iterator it = spo_.begin(); it != spo_.end(); ++it)
+            {
+                if (predicate.is_valid() && it->id[1] != predicate.id)
+                    continue;
+                if (!function(triple(it->id[0], it->id[1], it->id[2])))
+                    return;
+            }
+        }
+    }
+
+    // Merges statements added since the last query into the indices
+    void flush() const
+    {
+        if (pending_.empty())
+            return;
+        std::sort(pending_.begin(), pending_.end());
+        merge(spo_, pending_);
+        for (std::vector<Key>::iterator it = pending_.begin(); it != pending_.end(); ++it)
+            std::swap(it->id[0], it->id[2]);
+        std::sort(pending_.begin(), pending_.end());
+        merge(ops_, pending_);
+        pending_.clear();
+    }
+
+    // Removes all statements, interned terms are kept
+    void clear()
+    {
+        spo_.clear();
+        ops_.clear();
+        pending_.clear();
+        statements_.clear();
+        std::fill(uses_.begin(), uses_.end(), 0);
+    }
+
+    // Removes all statements and terms
+    void reset()
+    {
+        clear();
+        clearTerms();
+        nextBlank_ = 0;
+    }
+
+private:
+
+    struct Key
+    {
+        uint32_t id[3];
+
+        bool operator<(const Key &other) const
+        {
+            return std::lexicographical_compare(id, id + 3, other.id, other.id + 3);
+        }
+
+        bool operator==(const Key &other) const
+        {
+            return id[0] == other.id[0] && id[1] == other.id[1] && id[2] == other.id[2];
+        }
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(const Key &key) const
+        {
+            uint64_t h = key.id[0];
+            h = h * 0x9E3779B97F4A7C15ULL + key.id[1];
+            h = h * 0x9E3779B97F4A7C15ULL + key.id[2];
+            return static_cast<size_t>(h ^ (h >> 29));
+        }
+    };
+
+    // Type, value, datatype and language; neither datatype nor language
+    // contain a NUL, so the key is unique even for values that do.
+    static std::string termKey(Term::Type type, const std::string &value, const std::string &datatype, const std::string &language)
+    {
+        std::string key;
+        key.reserve(value.size() + datatype.size() + language.size() + 3);
+        key += static_cast<char>('0' + type);
+        key += value;
+        key += '\0';
+        key += datatype;
+        key += '\0';
+        key += language;
+        return key;
+    }
+
+    void clearTerms()
+    {
+        terms_.assign(1, Term());
+        uses_.assign(1, 0);
+        ids_.clear();
+        curies_.clear();
+    }
+
+    Triple triple(uint32_t subject, uint32_t predicate, uint32_t object) const
+    {
+        return Triple(Node(subject, terms_[subject].type), Node(predicate, terms_[predicate].type), Node(object, terms_[object].type));
+    }
+
+    static void merge(std::vector<Key> &index, const std::vector<Key> &sorted)
+    {
+        const size_t middle = index.size();
+        index.insert(index.end(), sorted.begin(), sorted.end());
+        std::inplace_merge(index.begin(), index.begin() + middle, index.end());
+    }
+
+    // Entries whose first length ids equal prefix
+    static std::pair<const Key *, const Key *> equalRange(const std::vector<Key> &index, const uint32_t *prefix, int length)
+    {
+        const Key *begin = index.data();
+        const Key *end = begin + index.size();
+        const Key *first = std::lower_bound(begin, end, prefix, [length](const Key &key, const uint32_t *prefix) {
+            return std::lexicographical_compare(key.id, key.id + length, prefix, prefix + length);
+        });
+        const Key *last = std::upper_bound(first, end, prefix, [length](const uint32_t *prefix, const Key &key) {
+            return std::lexicographical_compare(prefix, prefix + length, key.id, key.id + length);
+        });
+        return std::make_pair(first, last);
+    }
+
+    std::string base_uri_;
+    std::map<std::string, std::string> prefixes_;
+    std::unordered_map<const char *, Node> curies_;
+    std::vector<Term> terms_;
+    std::vector<uint32_t> uses_;
+    std::unordered_map<std::string, uint32_t> ids_;
+    uint32_t nextBlank_;
+
+    mutable std::vector<Key> spo_;
+    mutable std::vector<Key> ops_;
+    mutable std::vector<Key> pending_;
+    std::unordered_set<Key, KeyHash> statements_;
+};
+
+// All statements in SPO order, for the tools on TermTriples (diff, binary
+// format, snapshots)
+inline TermTriples toTermTriples(const Model &model)
+{
+    TermTriples result;
+    result.reserve(model.size());
+    model.visit(Node(), Node(), Node(), [&](const Triple &triple) {
+        result.emplace_back(model.term(triple.subject), model.term(triple.predicate), model.term(triple.object));
+        return true;
+    });
+    return result;
+}
+
+inline std::string toNTriples(const Model &model)
+{
+    std::string out;
+    model.visit(Node(), Node(), Node(), [&](const Triple &triple) {
+        appendNTriplesTerm(out, model.term(triple.subject));
+        out += ' ';
+        appendNTriplesTerm(out, model.term(triple.predicate));
+        out += ' ';
+        appendNTriplesTerm(out, model.term(triple.object));
+        out += " .\n";
+        return true;
+    });
+    return out;
+}
+
+// Adds statements to the model
+inline void addTermTriples(Model &model, const TermTriples &triples)
+{
+    for (TermTriples::const_iterator it = triples.begin(); it != triples.end(); ++it)
+        model.add_statement(model.intern(it->subject), model.intern(it->predicate), model.intern(it->object));
+}
+
+} // namespace Flat
+} // namespace RDF
+} // namespace Arvida
+
+#endif
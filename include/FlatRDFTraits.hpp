@@ -0,0 +1,629 @@
+/*  ARVIDAPP - ARVIDA C++ Preprocessor
+ *
+ *  Copyright (C) 2015-2019 German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef FLAT_RDF_TRAITS_HPP_INCLUDED
+#define FLAT_RDF_TRAITS_HPP_INCLUDED
+
+#include "FlatRDFStore.hpp"
+#include "RDFSchema.hpp"
+#include "RDFLazy.hpp"
+#include "RDFProjection.hpp"
+#include "RDFPath.hpp"
+#include "RDFStringRef.hpp"
+#include <cassert>
+#include <memory>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <map>
+#include <type_traits>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <boost/any.hpp>
+
+#define ARVIDA_FLAT_XSD "http://www.w3.org/2001/XMLSchema#"
+
+namespace Arvida {
+namespace RDF {
+
+typedef Flat::Node Node;
+typedef Flat::Node * NodePtr;
+typedef Flat::Node & NodeRef;
+typedef Flat::Triple Triple;
+typedef std::unordered_map<std::string, boost::any> Cache;
+typedef std::map<std::string, std::string> Prefixes;
+
+struct Context
+{
+    Flat::Model &model;
+    const std::string &base_path;
+    const std::string &path;
+    Cache *cache;
+    const void *user_data;
+    // Keeps the model alive for Lazy members read with this context,
+    // required for reading them (see unownedModel())
+    std::shared_ptr<const void> owner;
+    // Projection of toRDF (see RDFProjection.hpp) and depth of the object
+    // serialized with this context
+    const Projection *projection;
+    unsigned depth;
+
+    Context(Flat::Model &model, const std::string &base_path, const std::string &path, Cache *cache = 0, const void *user_data = 0) : model(model), base_path(base_path), path(path), cache(cache), user_data(user_data), projection(0), depth(0) { }
+    Context(Flat::Model &model, const std::string &path, Cache *cache = 0, const void *user_data = 0) : model(model), base_path(path), path(path), cache(cache), user_data(user_data), projection(0), depth(0) { }
+    Context(const Context &ctx) : model(ctx.model), base_path(ctx.base_path), path(ctx.path), cache(ctx.cache), user_data(ctx.user_data), owner(ctx.owner), projection(ctx.projection), depth(ctx.depth) { }
+    Context(const Context &ctx, const std::string &path) : model(ctx.model), base_path(ctx.base_path), path(path), cache(ctx.cache), user_data(ctx.user_data), owner(ctx.owner), projection(ctx.projection), depth(ctx.depth) { }
+};
+
+inline bool check_triple(const Flat::Model &model, const Node &subject, const Node &predicate, const Node &object)
+{
+    return model.find_triple(subject, predicate, object).is_valid();
+}
+
+inline Triple find_triple(const Flat::Model &model, const Node &subject, const Node &predicate, const Node &object)
+{
+    return model.find_triple(subject, predicate, object);
+}
+
+inline std::vector<Triple> find_triples(const Flat::Model &model, const Node &subject, const Node &predicate, const Node &object)
+{
+    return model.find_triples(subject, predicate, object);
+}
+
+inline bool isNodeExists(const Flat::Model &model, const Node &node)
+{
+    return model.contains(node);
+}
+
+// Backend of the schema engine (RDFSchema.hpp)
+
+inline Node schemaConstantNode(const Context &ctx, const SchemaNode &node)
+{
+    if (node.kind == SCHEMA_IRI)
+        return ctx.model.iri(node.value);
+    return ctx.model.curie(node.value);
+}
+
+inline Node schemaBlankNode(const Context &ctx)
+{
+    return ctx.model.blank();
+}
+
+inline void schemaAddStatement(const Context &ctx, const Node &subject, const Node &predicate, const Node &object)
+{
+    ctx.model.add_statement(subject, predicate, object);
+}
+
+inline Triple schemaFindTriple(const Context &ctx, const Node &subject, const Node &predicate, const Node &object)
+{
+    return ctx.model.find_triple(subject, predicate, object);
+}
+
+// Adds all triples of a skeleton in batches. Constant nodes need no cache,
+// the model caches prefixed names by the address of the table strings.
+inline void addSkeleton(const Context &ctx, const SchemaSkeleton &skeleton, Node &_this, Node *const *blanks)
+{
+    Flat::Triple batch[16];
+    size_t count = 0;
+    for (size_t t = 0; t < skeleton.tripleCount; ++t)
+    {
+        const SchemaTriple &triple = skeleton.triples[t];
+        const SchemaNode *nodes[] = { &triple.subject, &triple.predicate, &triple.object };
+        Node resolved[3];
+        for (int i = 0; i < 3; ++i)
+            resolved[i] = schemaSkeletonNode(*nodes[i],
+                nodes[i]->kind >= SCHEMA_PREFIXED_NAME ? schemaConstantNode(ctx, *nodes[i]) : Node(), _this, blanks);
+        batch[count].subject = resolved[0];
+        batch[count].predicate = resolved[1];
+        batch[count].object = resolved[2];
+        if (++count == 16)
+        {
+            ctx.model.add_statements(batch, count);
+            count = 0;
+        }
+    }
+    ctx.model.add_statements(batch, count);
+}
+
+// Model together with a node cache, interned terms stay in the model when
+// it is cleared.
+
+struct WorldModel
+{
+    Flat::Model model;
+    Cache cache;
+
+    explicit WorldModel(const std::string &base_uri)
+        : model(base_uri)
+    { }
+
+    WorldModel(const std::string &base_uri, const Prefixes &prefixes)
+        : model(base_uri)
+    {
+        for (Prefixes::const_iterator it = prefixes.begin(); it != prefixes.end(); ++it)
+            model.add_prefix(it->first, it->second);
+    }
+
+    void clear()
+    {
+        model.clear();
+    }
+};
+
+template <class T>
+inline bool isValidValue(const T &value)
+{
+    return true;
+}
+
+template < class T >
+inline bool isValidValue(const std::shared_ptr<T> &value)
+{
+    return value.operator bool();
+}
+
+// A pending object is not loaded, errors in it are detected when it is
+// written
+template < class T >
+inline bool isValidValue(const Lazy<T> &value)
+{
+    return value.operator bool();
+}
+
+// PathType
+
+enum PathType
+{
+    NO_PATH, RELATIVE_PATH, RELATIVE_TO_BASE_PATH, ABSOLUTE_PATH
+};
+
+// uidOf
+
+template<class T>
+inline std::string uidOf(const Context &ctx, const T &value)
+{
+    return value.getUid();
+}
+
+// pathOf_impl, pathTypeOf_impl
+
+template<class T>
+inline std::string pathOf_impl(const Context &ctx, const T &value)
+{
+    return uidOf(ctx, value);
+}
+
+template<class T>
+inline PathType pathTypeOf_impl(const Context &ctx, const T &value)
+{
+    return RELATIVE_TO_BASE_PATH;
+}
+
+// pathOf
+
+template<class T>
+inline std::string pathOf(const Context &ctx, const T &value)
+{
+    return pathOf_impl(ctx, value);
+}
+
+template<class T>
+inline std::string pathOf(const Context &ctx, const std::shared_ptr<T> &value)
+{
+    if (value)
+        return pathOf(ctx, *value);
+    else
+        return "";
+}
+
+template<class T>
+inline std::string pathOf(const Context &ctx, const Lazy<T> &value)
+{
+    return pathOf(ctx, value.get());
+}
+
+template<class T>
+inline PathType pathTypeOf(const Context &ctx, const T &value)
+{
+    return pathTypeOf_impl(ctx, value);
+}
+
+template<class T>
+inline PathType pathTypeOf(const Context &ctx, const std::shared_ptr<T> &value)
+{
+    if (value)
+        return pathTypeOf(ctx, *value);
+    else
+        return NO_PATH;
+}
+
+template<class T>
+inline PathType pathTypeOf(const Context &ctx, const Lazy<T> &value)
+{
+    return pathTypeOf(ctx, value.get());
+}
+
+template<>
+inline std::string pathOf(const Context &ctx, const double &value)
+{
+    return "";
+}
+
+template<>
+inline PathType pathTypeOf(const Context &ctx, const double &value)
+{
+    return NO_PATH; // FIXME: LITERAL_NODE ?
+}
+
+template<>
+inline std::string pathOf(const Context &ctx, const float &value)
+{
+    return "";
+}
+
+template<>
+inline PathType pathTypeOf(const Context &ctx, const float &value)
+{
+    return NO_PATH; // FIXME: LITERAL_NODE ?
+}
+
+template<>
+inline std::string pathOf(const Context &ctx, const std::string &value)
+{
+    return "";
+}
+
+template<>
+inline PathType pathTypeOf(const Context &ctx, const std::string &value)
+{
+    return NO_PATH; // FIXME: LITERAL_NODE ?
+}
+
+
+template<class T>
+inline std::string pathOf(const Context &ctx, const std::vector<T> &value)
+{
+    return "";
+}
+
+template<class T>
+inline PathType pathTypeOf(const Context &ctx, const std::vector<T> &value)
+{
+    return RELATIVE_PATH;
+}
+
+inline std::string joinPath(const std::string &path1, const std::string path2)
+{
+    if (path2.empty())
+        return path1;
+    if (path1.empty())
+        return path2;
+
+    const char p1b = path1.back();
+    const char p2f = path2.front();
+
+    if (p1b == '/' && p2f == '/') {
+        return path1.substr(0, path1.size()-1) + path2;
+    } else if (p1b != '/' && p2f != '/') {
+        return path1 + '/' + path2;
+    } else {
+        return path1 + path2;
+    }
+}
+
+inline std::string resolvePath(const Context &ctx, PathType thatPathType, const std::string &thatPathOf,
+                               PathType memberPathType, const std::string &memberPath)
+{
+    std::string thatPath;
+    if (thatPathType == ABSOLUTE_PATH)
+        thatPath = thatPathOf;
+    else if (thatPathType == RELATIVE_TO_BASE_PATH)
+        joinPathInto(thatPath, ctx.base_path, thatPathOf);
+    else {
+        switch (memberPathType)
+        {
+            case NO_PATH:
+                thatPath = ctx.path;
+                break;
+            case RELATIVE_PATH:
+                joinPathInto(thatPath, ctx.path, memberPath);
+                break;
+            case RELATIVE_TO_BASE_PATH:
+                joinPathInto(thatPath, ctx.base_path, memberPath);
+                break;
+            case ABSOLUTE_PATH:
+                thatPath = memberPath;
+                break;
+        }
+        if (thatPathType == RELATIVE_PATH)
+            appendPath(thatPath, thatPathOf);
+    }
+    return thatPath;
+}
+
+// Reference type of a container element, elements of a container which is
+// returned by value are not part of the object graph
+
+template <class ContainerRef, class Element>
+using ElementRef = typename std::conditional<std::is_reference<ContainerRef>::value,
+    Element, typename std::decay<Element>::type>::type;
+
+template <class T>
+void serializeRDFNode(const Context &ctx, NodeRef node, const T &value)
+{
+    if (!isNodeExists(ctx.model, node))
+        toRDF(ctx, node, value);
+}
+
+// createRDFNode
+
+template<class T>
+Node createRDFNode(const Context &ctx, const T &value, PathType memberPathType, const std::string &memberPath)
+{
+    const PathType thatPathType = pathTypeOf(ctx, value);
+    if (thatPathType == NO_PATH)
+        return ctx.model.blank();
+    return ctx.model.uri(resolvePath(ctx, thatPathType, pathOf(ctx, value), memberPathType, memberPath));
+}
+
+template<class ValueRef = void, class T>
+Node createRDFNodeAndSerialize(const Context &ctx, const T &value, PathType memberPathType, const std::string &memberPath)
+{
+    const PathType thatPathType = pathTypeOf(ctx, value);
+    if (thatPathType == NO_PATH)
+    {
+        Node thatNode = ctx.model.blank();
+        if (!IsNestedObject<T>::value || !ctx.projection)
+            serializeRDFNode(ctx, thatNode, value);
+        else if (!projectionCut(ctx))
+        {
+            Arvida::RDF::Context thatCtx(ctx);
+            ++thatCtx.depth;
+            serializeRDFNode(thatCtx, thatNode, value);
+        }
+        return thatNode;
+    }
+    else
+    {
+        const std::string thatPath = resolvePath(ctx, thatPathType, pathOf(ctx, value), memberPathType, memberPath);
+        Node thatNode = ctx.model.uri(thatPath);
+        if (!projectionCut(ctx))
+        {
+            Arvida::RDF::Context thatCtx(ctx, thatPath);
+            ++thatCtx.depth;
+            serializeRDFNode(thatCtx, thatNode, value);
+        }
+        return thatNode;
+    }
+}
+
+// Lexical form of shortest of the two precisions which reads back to the
+// same value
+template <class T>
+inline std::string floatingLexical(T value, int precision, int maxPrecision)
+{
+    if (std::isnan(value))
+        return "NaN";
+    if (std::isinf(value))
+        return value < 0 ? "-INF" : "INF";
+    char buf[40];
+    int length = std::snprintf(buf, sizeof(buf), "%.*g", precision, value);
+    if (static_cast<T>(std::strtod(buf, 0)) != value)
+        length = std::snprintf(buf, sizeof(buf), "%.*g", maxPrecision, value);
+    return std::string(buf, length);
+}
+
+// toRDF
+
+template < class T >
+Node toRDF(const Context &ctx, const T &value)
+{
+    Node valueNode = ctx.model.blank();
+    return toRDF(ctx, valueNode, value);
+}
+
+template < class T >
+inline NodeRef toRDF(const Context &ctx, NodeRef thisNode, const T &value)
+{
+    return value.toRDF(ctx, thisNode);
+}
+
+template < class T >
+inline NodeRef toRDF(const Context &ctx, NodeRef thisNode, const std::shared_ptr<T> &value)
+{
+    if (value)
+        return toRDF(ctx, thisNode, *value);
+    else
+    {
+        if (!thisNode.is_blank())
+            thisNode = ctx.model.blank();
+        return thisNode;
+    }
+}
+
+template < class T >
+inline NodeRef toRDF(const Context &ctx, NodeRef thisNode, const Lazy<T> &value)
+{
+    return toRDF(ctx, thisNode, value.get());
+}
+
+template < class T >
+inline NodeRef toRDF(const Context &ctx, NodeRef thisNode, const std::vector<T> &value)
+{
+    ctx.model.add_statement(thisNode, ctx.model.curie("rdf:type"), ctx.model.curie("core:Container"));
+
+    for (auto it = std::begin(value); it != std::end(value); ++it)
+    {
+        const auto & _that = *it;
+        Node memberNode = ctx.model.blank();
+        serializeRDFNode(ctx, memberNode, _that);
+        ctx.model.add_statement(thisNode, ctx.model.curie("core:member"), memberNode);
+    }
+    return thisNode;
+}
+
+template<>
+inline NodeRef toRDF(const Context &ctx, NodeRef _this, const double &value)
+{
+    _this = ctx.model.literal(floatingLexical(value, 15, 17), ARVIDA_FLAT_XSD "double");
+    return _this;
+}
+
+template<>
+inline NodeRef toRDF(const Context &ctx, NodeRef _this, const float &value)
+{
+    _this = ctx.model.literal(floatingLexical(value, 6, 9), ARVIDA_FLAT_XSD "float");
+    return _this;
+}
+
+template<>
+inline NodeRef toRDF(const Context &ctx, NodeRef _this, const std::string &value)
+{
+    _this = ctx.model.literal(value, ARVIDA_FLAT_XSD "string");
+    return _this;
+}
+
+template < class T >
+bool fromRDF(const Context &ctx, const NodeRef thisNode, T &value)
+{
+    return value.fromRDF(ctx, thisNode);
+}
+
+// Reads the members in mask (see Members<T>), specialized for annotated
+// classes. Other types are read completely.
+template < class T >
+bool fromRDF(const Context &ctx, const NodeRef thisNode, T &value, MemberMask mask)
+{
+    return fromRDF(ctx, thisNode, value);
+}
+
+template < class T >
+bool fromRDF(const Context &ctx, const NodeRef thisNode, std::shared_ptr<T> &value)
+{
+    return value ? fromRDF(ctx, thisNode, *value) : false;
+}
+
+// Node and model of a Lazy member, the owner is released after the node
+struct LazySource
+{
+    std::shared_ptr<const void> owner;
+    Flat::Model *model;
+    std::string base_path;
+    std::string path;
+    const void *user_data;
+    Node node;
+};
+
+// Owner for Context::owner of a model which the caller keeps alive as long
+// as the Lazy members read from it
+inline std::shared_ptr<const void> unownedModel(const Flat::Model &model)
+{
+    return std::shared_ptr<const void>(std::shared_ptr<const void>(), &model);
+}
+
+// Stores the node, the object is read on first access. The model is
+// referenced, so the context needs an owner (see unownedModel()).
+template < class T >
+bool fromRDF(const Context &ctx, const NodeRef thisNode, Lazy<T> &value)
+{
+    assert(ctx.owner && "Lazy members are only read with Context::owner");
+    if (!ctx.owner)
+        return false;
+    std::shared_ptr<LazySource> source = std::make_shared<LazySource>();
+    source->owner = ctx.owner;
+    source->model = &ctx.model;
+    source->base_path = ctx.base_path;
+    source->path = ctx.path;
+    source->user_data = ctx.user_data;
+    source->node = thisNode;
+    value = Lazy<T>([source](T &result) {
+        Context lazy(*source->model, source->base_path, source->path, 0, source->user_data);
+        lazy.owner = source->owner;
+        return fromRDF(lazy, source->node, result);
+    });
+    return true;
+}
+
+template < class T >
+bool parseFloating(const Context &ctx, const Node &node, T &value)
+{
+    if (!node.is_literal())
+        return false;
+    const Term &term = ctx.model.term(node);
+    if (term.datatype == ARVIDA_FLAT_XSD "integer" ||
+        term.datatype == ARVIDA_FLAT_XSD "decimal" ||
+        term.datatype == ARVIDA_FLAT_XSD "double" ||
+        term.datatype == ARVIDA_FLAT_XSD "float")
+    {
+        const char *str = term.value.c_str();
+        char *endptr;
+        value = static_cast<T>(std::strtod(str, &endptr));
+        if (endptr == str)
+            return false;
+        // Trailing whitespace is allowed (xsd whitespace collapse), other
+        // characters are not
+        while (*endptr == ' ' || *endptr == '\t' || *endptr == '\n' || *endptr == '\r')
+            ++endptr;
+        return *endptr == '\0';
+    }
+    return false;
+}
+
+template <>
+inline bool fromRDF(const Context &ctx, const NodeRef _this0, double &value)
+{
+    return parseFloating(ctx, _this0, value);
+}
+
+template <>
+inline bool fromRDF(const Context &ctx, const NodeRef _this0, float &value)
+{
+    return parseFloating(ctx, _this0, value);
+}
+
+template <>
+inline bool fromRDF(const Context &ctx, const NodeRef _this0, std::string &value)
+{
+    value = ctx.model.term(_this0).value;
+    return true;
+}
+
+// References the string of the term in the dictionary of the model, see
+// RDFStringRef.hpp
+template <>
+inline bool fromRDF(const Context &ctx, const NodeRef _this0, StringRef &value)
+{
+    value = ctx.model.term(_this0).value;
+    return true;
+}
+
+#ifdef ARVIDA_RDF_HAS_STRING_VIEW
+template <>
+inline bool fromRDF(const Context &ctx, const NodeRef _this0, std::string_view &value)
+{
+    StringRef ref;
+    if (!fromRDF(ctx, _this0, ref))
+        return false;
+    value = ref;
+    return true;
+}
+#endif
+
+} // namespace RDF
+} // namespace Arvida
+
+#endif
@@ -0,0 +1,796 @@
+/*  ARVIDAPP - ARVIDA C++ Preprocessor
+ *
+ *  Copyright (C) 2015-2019 German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef JSONLD_PARSER_HPP_INCLUDED
+#define JSONLD_PARSER_HPP_INCLUDED
+
+#include "RDFTerm.hpp"
+#include "NTriplesParser.hpp"
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include <unordered_set>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// JSON-LD reader without an RDF library
+//
+// The document is parsed into a JSON tree and its node objects are converted
+// into terms in N-Triples syntax, which are indexed by a Graph, so that the
+// generated readers of the ntriples template can be used. Supported are
+// inline contexts with prefixes, @vocab, @base and term definitions with
+// @id and @type, node objects with @graph, embedded nodes, value objects,
+// @set and @list (read as rdf:first/rdf:rest chain). Relative IRIs are
+// resolved against @base as of RFC 3986. Remote contexts and @reverse are
+// not supported.
+
+namespace Arvida
+{
+namespace RDF
+{
+
+#define ARVIDA_JSONLD_RDF_TYPE "http://www.w3.org/1999/02/22-rdf-syntax-ns#type"
+#define ARVIDA_JSONLD_RDF "http://www.w3.org/1999/02/22-rdf-syntax-ns#"
+
+// Removes "." and ".." segments from path (RFC 3986, section 5.2.4)
+inline std::string removeDotSegments(const std::string &path)
+{
+    std::string output;
+    size_t i = 0;
+    while (i < path.size())
+    {
+        if (path.compare(i, 3, "../") == 0)
+            i += 3;
+        else if (path.compare(i, 2, "./") == 0)
+            i += 2;
+        else if (path.compare(i, 3, "/./") == 0)
+            i += 2;
+        else if (path.compare(i, std::string::npos, "/.") == 0)
+        {
+            output += '/';
+            break;
+        }
+        else if (path.compare(i, 4, "/../") == 0 || path.compare(i, std::string::npos, "/..") == 0)
+        {
+            const size_t slash = output.rfind('/');
+            output.erase(slash == std::string::npos ? 0 : slash);
+            if (path.size() - i == 3)
+            {
+                output += '/';
+                break;
+            }
+            i += 3;
+        }
+        else if (path.compare(i, std::string::npos, ".") == 0 || path.compare(i, std::string::npos, "..") == 0)
+            break;
+        else
+        {
+            const size_t next = path.find('/', i + 1);
+            const size_t end = next == std::string::npos ? path.size() : next;
+            output.append(path, i, end - i);
+            i = end;
+        }
+    }
+    return output;
+}
+
+// Length of the scheme of iri including ':', 0 for relative references
+inline size_t schemeLength(const std::string &iri)
+{
+    for (size_t i = 0; i < iri.size(); ++i)
+    {
+        const char c = iri[i];
+        if (c == ':')
+            return i > 0 ? i + 1 : 0;
+        const bool alpha = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+        if (!alpha && (i == 0 || !((c >= '0' && c <= '9') || c == '+' || c == '-' || c == '.')))
+            return 0;
+    }
+    return 0;
+}
+
+// Resolves reference against base (RFC 3986, section 5.2.2). An empty base
+// leaves the reference as it is.
+inline std::string resolveIRI(const std::string &base, const std::string &reference)
+{
+    if (base.empty() || schemeLength(reference) > 0)
+        return reference;
+
+    // Split base into scheme, authority, path and query
+    const size_t scheme = schemeLength(base);
+    size_t pathStart = scheme;
+    if (base.compare(scheme, 2, "//") == 0)
+    {
+        pathStart = base.find_first_of("/?#", scheme + 2);
+        if (pathStart == std::string::npos)
+            pathStart = base.size();
+    }
+    size_t pathEnd = base.find_first_of("?#", pathStart);
+    if (pathEnd == std::string::npos)
+        pathEnd = base.size();
+    size_t queryEnd = base.find('#', pathEnd);
+    if (queryEnd == std::string::npos)
+        queryEnd = base.size();
+
+    if (reference.compare(0, 2, "//") == 0)
+    {
+        size_t end = reference.find_first_of("/?#", 2);
+        if (end == std::string::npos)
+            end = reference.size();
+        size_t refPathEnd = reference.find_first_of("?#", end);
+        if (refPathEnd == std::string::npos)
+            refPathEnd = reference.size();
+        return base.substr(0, scheme) + reference.substr(0, end) +
+            removeDotSegments(reference.substr(end, refPathEnd - end)) + reference.substr(refPathEnd);
+    }
+    std::string result = base.substr(0, pathStart);
+    if (reference.empty() || reference[0] == '#')
+        return result + base.substr(pathStart, queryEnd - pathStart) + reference;
+    if (reference[0] == '?')
+        return result + base.substr(pathStart, pathEnd - pathStart) + reference;
+
+    size_t refPathEnd = reference.find_first_of("?#");
+    if (refPathEnd == std::string::npos)
+        refPathEnd = reference.size();
+    const std::string refPath = reference.substr(0, refPathEnd);
+    if (refPath[0] == '/')
+        result += removeDotSegments(refPath);
+    else
+    {
+        // Merge with the path of base (RFC 3986, section 5.2.3)
+        std::string merged;
+        if (pathStart == pathEnd)
+            merged = (pathStart > scheme ? "/" : "") + refPath;
+        else
+        {
+            const size_t slash = base.rfind('/', pathEnd - 1);
+            merged = slash == std::string::npos || slash < pathStart ?
+                refPath : base.substr(pathStart, slash + 1 - pathStart) + refPath;
+        }
+        result += removeDotSegments(merged);
+    }
+    return result + reference.substr(refPathEnd);
+}
+
+struct JsonValue
+{
+    enum Type
+    {
+        NULL_VALUE, BOOLEAN, NUMBER, STRING, ARRAY, OBJECT
+    };
+
+    typedef std::vector<std::pair<std::string, JsonValue> > Members;
+
+    Type type;
+    std::string string; // string, lexical form of number or boolean
+    std::vector<JsonValue> array;
+    Members members;
+
+    JsonValue() : type(NULL_VALUE) { }
+
+    const JsonValue * find(const char *key) const
+    {
+        for (Members::const_iterator it = members.begin(); it != members.end(); ++it)
+        {
+            if (it->first == key)
+                return &it->second;
+        }
+        return 0;
+    }
+};
+
+class JsonLdGraph
+{
+public:
+
+    JsonLdGraph() : errorOffset_(0), nextBlank_(0) { }
+
+    // Parses document, returns false on error (see error(), errorOffset()).
+    // Terms are copied, the buffer may be released after parsing.
+    bool parse(const char *data, size_t size)
+    {
+        clear();
+        JsonValue root;
+        const char *p = data;
+        const char *end = data + size;
+        if (!parseValue(p, end, root, 0) || !expectEnd(p, end))
+        {
+            errorOffset_ = p - data;
+            return false;
+        }
+        if (!processDocument(root))
+            return false;
+        graph_.assign(triples_);
+        triples_.clear();
+        return true;
+    }
+
+    bool parse(const std::string &document)
+    {
+        return parse(document.data(), document.size());
+    }
+
+    void clear()
+    {
+        graph_.clear();
+        triples_.clear();
+        terms_.clear();
+        error_.clear();
+        errorOffset_ = 0;
+        nextBlank_ = 0;
+    }
+
+    const Graph & graph() const { return graph_; }
+
+    const std::string & error() const { return error_; }
+
+    // Offset of JSON syntax error
+    size_t errorOffset() const { return errorOffset_; }
+
+private:
+    enum { MAX_DEPTH = 256 };
+
+    struct TermDefinition
+    {
+        std::string iri;
+        std::string type;
+    };
+
+    struct ActiveContext
+    {
+        std::map<std::string, TermDefinition> terms;
+        std::string vocab;
+        std::string base;
+    };
+
+    bool fail(const char *message)
+    {
+        error_ = message;
+        return false;
+    }
+
+    // JSON
+
+    static const char * skipWhitespace(const char *p, const char *end)
+    {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r'))
+            ++p;
+        return p;
+    }
+
+    bool expectEnd(const char *&p, const char *end)
+    {
+        p = skipWhitespace(p, end);
+        return p == end || fail("unexpected data after JSON value");
+    }
+
+    bool parseValue(const char *&p, const char *end, JsonValue &value, unsigned depth)
+    {
+        p = skipWhitespace(p, end);
+        if (p == end)
+            return fail("unexpected end of document");
+        if (depth > MAX_DEPTH)
+            return fail("document is nested too deeply");
+        switch (*p)
+        {
+            case '{':
+            {
+                value.type = JsonValue::OBJECT;
+                p = skipWhitespace(p + 1, end);
+                if (p < end && *p == '}')
+                {
+                    ++p;
+                    return true;
+                }
+                while (true)
+                {
+                    p = skipWhitespace(p, end);
+                    if (p == end || *p != '"')
+                        return fail("expected member name");
+                    value.members.push_back(std::make_pair(std::string(), JsonValue()));
+                    if (!parseString(p, end, value.members.back().first))
+                        return false;
+                    p = skipWhitespace(p, end);
+                    if (p == end || *p != ':')
+                        return fail("expected ':'");
+                    ++p;
+                    if (!parseValue(p, end, value.members.back().second, depth + 1))
+                        return false;
+                    p = skipWhitespace(p, end);
+                    if (p < end && *p == ',')
+                        ++p;
+                    else if (p < end && *p == '}')
+                    {
+                        ++p;
+                        return true;
+                    }
+                    else
+                        return fail("expected ',' or '}'");
+                }
+            }
+            case '[':
+            {
+                value.type = JsonValue::ARRAY;
+                p = skipWhitespace(p + 1, end);
+                if (p < end && *p == ']')
+                {
+                    ++p;
+                    return true;
+                }
+                while (true)
+                {
+                    value.array.push_back(JsonValue());
+                    if (!parseValue(p, end, value.array.back(), depth + 1))
+                        return false;
+                    p = skipWhitespace(p, end);
+                    if (p < end && *p == ',')
+                        ++p;
+                    else if (p < end && *p == ']')
+                    {
+                        ++p;
+                        return true;
+                    }
+                    else
+                        return fail("expected ',' or ']'");
+                }
+            }
+            case '"':
+                value.type = JsonValue::STRING;
+                return parseString(p, end, value.string);
+            case 't':
+                value.type = JsonValue::BOOLEAN;
+                return parseKeyword(p, end, "true", value.string);
+            case 'f':
+                value.type = JsonValue::BOOLEAN;
+                return parseKeyword(p, end, "false", value.string);
+            case 'n':
+                value.type = JsonValue::NULL_VALUE;
+                return parseKeyword(p, end, "null", value.string);
+            default:
+                value.type = JsonValue::NUMBER;
+                return parseNumber(p, end, value.string);
+        }
+    }
+
+    bool parseKeyword(const char *&p, const char *end, const char *keyword, std::string &out)
+    {
+        const size_t length = std::strlen(keyword);
+        if (static_cast<size_t>(end - p) < length || std::memcmp(p, keyword, length) != 0)
+            return fail("invalid literal");
+        p += length;
+        out = keyword;
+        return true;
+    }
+
+    bool parseNumber(const char *&p, const char *end, std::string &out)
+    {
+        const char *start = p;
+        if (p < end && *p == '-')
+            ++p;
+        const char *digits = p;
+        while (p < end && ((*p >= '0' && *p <= '9') || *p == '.' || *p == 'e' || *p == 'E' || *p == '+' || *p == '-'))
+            ++p;
+        if (p == digits || *digits < '0' || *digits > '9')
+            return fail("invalid value");
+        out.assign(start, p - start);
+        return true;
+    }
+
+    static bool parseHex4(const char *p, const char *end, unsigned long &value)
+    {
+        if (end - p < 4)
+            return false;
+        char hex[5];
+        std::memcpy(hex, p, 4);
+        hex[4] = '\0';
+        char *endptr;
+        value = std::strtoul(hex, &endptr, 16);
+        return endptr == hex + 4;
+    }
+
+    bool parseString(const char *&p, const char *end, std::string &out)
+    {
+        ++p;
+        while (true)
+        {
+            const char *q = findEither(p, end, '"', '\\');
+            if (q == end)
+                return fail("unterminated string");
+            out.append(p, q - p);
+            p = q + 1;
+            if (*q == '"')
+                return true;
+            if (p == end)
+                return fail("unterminated string");
+            const char c = *p++;
+            switch (c)
+            {
+                case '"': out += '"'; break;
+                case '\\': out += '\\'; break;
+                case '/': out += '/'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'u':
+                {
+                    unsigned long code;
+                    if (!parseHex4(p, end, code))
+                        return fail("invalid unicode escape");
+                    p += 4;
+                    unsigned long low;
+                    if (code >= 0xD800 && code < 0xDC00 && end - p >= 6 && p[0] == '\\' && p[1] == 'u' &&
+                        parseHex4(p + 2, end, low) && low >= 0xDC00 && low < 0xE000)
+                    {
+                        code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                        p += 6;
+                    }
+                    appendUTF8(out, code);
+                    break;
+                }
+                default:
+                    return fail("invalid escape sequence");
+            }
+        }
+    }
+
+    // JSON-LD
+
+    TermView addTerm(const std::string &term)
+    {
+        return TermView(*terms_.insert(term).first);
+    }
+
+    TermView iriTerm(const std::string &iri)
+    {
+        std::string term;
+        appendNTriplesIRI(term, iri.data(), iri.size());
+        return addTerm(term);
+    }
+
+    TermView literalTerm(const std::string &lexical, const std::string &datatype, const std::string &language = std::string())
+    {
+        std::string term;
+        appendNTriplesString(term, lexical.data(), lexical.size());
+        if (!language.empty())
+        {
+            term += '@';
+            term += language;
+        }
+        else if (!datatype.empty())
+        {
+            term += "^^";
+            appendNTriplesIRI(term, datatype.data(), datatype.size());
+        }
+        return addTerm(term);
+    }
+
+    // Blank node identifiers of the document get a prefix which differs
+    // from the one of generated identifiers
+    TermView nodeTerm(const ActiveContext &ctx, const std::string &id)
+    {
+        if (id.compare(0, 2, "_:") == 0)
+            return addTerm("_:d" + id.substr(2));
+        return iriTerm(expandIRI(ctx, id, false));
+    }
+
+    TermView newBlank()
+    {
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "_:g%lu", ++nextBlank_);
+        return addTerm(buf);
+    }
+
+    static std::string expandIRI(const ActiveContext &ctx, const std::string &value, bool vocab)
+    {
+        if (vocab)
+        {
+            std::map<std::string, TermDefinition>::const_iterator it = ctx.terms.find(value);
+            if (it != ctx.terms.end())
+                return it->second.iri;
+        }
+        const size_t colon = value.find(':');
+        if (colon != std::string::npos)
+        {
+            if (value.compare(colon, 3, "://") != 0)
+            {
+                std::map<std::string, TermDefinition>::const_iterator it = ctx.terms.find(value.substr(0, colon));
+                if (it != ctx.terms.end())
+                    return it->second.iri + value.substr(colon + 1);
+            }
+            return value;
+        }
+        if (vocab)
+            return ctx.vocab.empty() ? std::string() : ctx.vocab + value;
+        return resolveIRI(ctx.base, value);
+    }
+
+    static bool isAbsolute(const std::string &iri)
+    {
+        return iri.find(':') != std::string::npos;
+    }
+
+    bool loadContext(const JsonValue &value, ActiveContext &ctx)
+    {
+        if (value.type == JsonValue::ARRAY)
+        {
+            for (size_t i = 0; i < value.array.size(); ++i)
+            {
+                if (!loadContext(value.array[i], ctx))
+                    return false;
+            }
+            return true;
+        }
+        if (value.type == JsonValue::NULL_VALUE)
+        {
+            ctx = ActiveContext();
+            return true;
+        }
+        if (value.type != JsonValue::OBJECT)
+            return fail("remote contexts are not supported");
+
+        for (JsonValue::Members::const_iterator it = value.members.begin(); it != value.members.end(); ++it)
+        {
+            const JsonValue &definition = it->second;
+            if (it->first == "@vocab")
+                ctx.vocab = definition.string;
+            else if (it->first == "@base")
+                ctx.base = definition.type == JsonValue::NULL_VALUE ?
+                    std::string() : resolveIRI(ctx.base, definition.string);
+            else if (it->first[0] == '@')
+                continue;
+            else if (definition.type == JsonValue::STRING)
+            {
+                TermDefinition &term = ctx.terms[it->first];
+                term.iri = expandIRI(ctx, definition.string, true);
+                term.type.clear();
+            }
+            else if (definition.type == JsonValue::OBJECT)
+            {
+                TermDefinition &term = ctx.terms[it->first];
+                const JsonValue *id = definition.find("@id");
+                const JsonValue *type = definition.find("@type");
+                term.iri = expandIRI(ctx, id ? id->string : it->first, true);
+                term.type = type ? type->string : std::string();
+                if (!term.type.empty() && term.type[0] != '@')
+                    term.type = expandIRI(ctx, term.type, true);
+            }
+            else if (definition.type == JsonValue::NULL_VALUE)
+                ctx.terms.erase(it->first);
+        }
+        return true;
+    }
+
+    bool processDocument(const JsonValue &root)
+    {
+        const ActiveContext ctx;
+        if (root.type == JsonValue::ARRAY)
+        {
+            for (size_t i = 0; i < root.array.size(); ++i)
+            {
+                if (!processTopLevel(root.array[i], ctx))
+                    return false;
+            }
+            return true;
+        }
+        return processTopLevel(root, ctx);
+    }
+
+    bool processTopLevel(const JsonValue &value, const ActiveContext &ctx)
+    {
+        if (value.type != JsonValue::OBJECT)
+            return fail("expected node object");
+        const JsonValue *graph = value.find("@graph");
+        if (!graph)
+        {
+            TermView subject;
+            return processNode(value, ctx, subject);
+        }
+
+        ActiveContext local(ctx);
+        const JsonValue *context = value.find("@context");
+        if (context && !loadContext(*context, local))
+            return false;
+        const std::vector<JsonValue> single(graph->type == JsonValue::ARRAY ? 0 : 1, *graph);
+        const std::vector<JsonValue> &nodes = graph->type == JsonValue::ARRAY ? graph->array : single;
+        for (size_t i = 0; i < nodes.size(); ++i)
+        {
+            TermView subject;
+            if (nodes[i].type != JsonValue::OBJECT)
+                return fail("expected node object");
+            if (!processNode(nodes[i], local, subject))
+                return false;
+        }
+        return true;
+    }
+
+    bool processNode(const JsonValue &node, const ActiveContext &ctx, TermView &subject)
+    {
+        ActiveContext local;
+        const ActiveContext *active = &ctx;
+        const JsonValue *context = node.find("@context");
+        if (context)
+        {
+            local = ctx;
+            if (!loadContext(*context, local))
+                return false;
+            active = &local;
+        }
+
+        const JsonValue *id = node.find("@id");
+        subject = id && id->type == JsonValue::STRING ? nodeTerm(*active, id->string) : newBlank();
+
+        for (JsonValue::Members::const_iterator it = node.members.begin(); it != node.members.end(); ++it)
+        {
+            const std::string &key = it->first;
+            if (key == "@type")
+            {
+                const TermView predicate = addTerm("<" ARVIDA_JSONLD_RDF_TYPE ">");
+                if (!processTypes(*active, subject, predicate, it->second))
+                    return false;
+                continue;
+            }
+            if (key == "@reverse")
+                return fail("reverse properties are not supported");
+            if (key.empty() || key[0] == '@')
+                continue;
+
+            const std::string iri = expandIRI(*active, key, true);
+            if (!isAbsolute(iri) || iri.compare(0, 2, "_:") == 0)
+                continue;
+            std::map<std::string, TermDefinition>::const_iterator term = active->terms.find(key);
+            const std::string &coercion = term != active->terms.end() ? term->second.type : std::string();
+            if (!processValue(*active, subject, iriTerm(iri), coercion, it->second))
+                return false;
+        }
+        return true;
+    }
+
+    bool processTypes(const ActiveContext &ctx, const TermView &subject, const TermView &predicate, const JsonValue &value)
+    {
+        if (value.type == JsonValue::ARRAY)
+        {
+            for (size_t i = 0; i < value.array.size(); ++i)
+            {
+                if (!processTypes(ctx, subject, predicate, value.array[i]))
+                    return false;
+            }
+            return true;
+        }
+        if (value.type != JsonValue::STRING)
+            return fail("invalid type value");
+        const TermView object = value.string.compare(0, 2, "_:") == 0 ?
+            nodeTerm(ctx, value.string) : iriTerm(expandIRI(ctx, value.string, true));
+        triples_.push_back(TripleView(subject, predicate, object));
+        return true;
+    }
+
+    bool processValue(const ActiveContext &ctx, const TermView &subject, const TermView &predicate,
+                      const std::string &coercion, const JsonValue &value)
+    {
+        TermView object;
+        switch (value.type)
+        {
+            case JsonValue::NULL_VALUE:
+                return true;
+            case JsonValue::ARRAY:
+                for (size_t i = 0; i < value.array.size(); ++i)
+                {
+                    if (!processValue(ctx, subject, predicate, coercion, value.array[i]))
+                        return false;
+                }
+                return true;
+            case JsonValue::STRING:
+                if (coercion == "@id")
+                    object = nodeTerm(ctx, value.string);
+                else if (coercion == "@vocab")
+                    object = iriTerm(expandIRI(ctx, value.string, true));
+                else
+                    object = literalTerm(value.string, coercion);
+                break;
+            case JsonValue::NUMBER:
+                object = literalTerm(value.string, coercion.empty() || coercion[0] == '@' ? numberType(value.string) : coercion);
+                break;
+            case JsonValue::BOOLEAN:
+                object = literalTerm(value.string, ARVIDA_NTRIPLES_XSD "boolean");
+                break;
+            case JsonValue::OBJECT:
+                if (const JsonValue *list = value.find("@list"))
+                {
+                    if (!processList(ctx, coercion, *list, object))
+                        return false;
+                    break;
+                }
+                if (const JsonValue *set = value.find("@set"))
+                    return processValue(ctx, subject, predicate, coercion, *set);
+                if (const JsonValue *literal = value.find("@value"))
+                {
+                    if (literal->type == JsonValue::NULL_VALUE)
+                        return true;
+                    const JsonValue *type = value.find("@type");
+                    const JsonValue *language = value.find("@language");
+                    std::string datatype;
+                    if (type)
+                        datatype = expandIRI(ctx, type->string, true);
+                    else if (literal->type == JsonValue::NUMBER)
+                        datatype = numberType(literal->string);
+                    else if (literal->type == JsonValue::BOOLEAN)
+                        datatype = ARVIDA_NTRIPLES_XSD "boolean";
+                    object = literalTerm(literal->string, datatype, language ? language->string : std::string());
+                }
+                else if (!processNode(value, ctx, object))
+                    return false;
+                break;
+        }
+        triples_.push_back(TripleView(subject, predicate, object));
+        return true;
+    }
+
+    // Converts the items of list into an rdf:first/rdf:rest chain, head is
+    // rdf:nil for an empty list
+    bool processList(const ActiveContext &ctx, const std::string &coercion, const JsonValue &list, TermView &head)
+    {
+        const std::vector<JsonValue> single(list.type == JsonValue::ARRAY ? 0 : 1, list);
+        const std::vector<JsonValue> &items = list.type == JsonValue::ARRAY ? list.array : single;
+        const TermView first = addTerm("<" ARVIDA_JSONLD_RDF "first>");
+        const TermView rest = addTerm("<" ARVIDA_JSONLD_RDF "rest>");
+        const TermView nil = addTerm("<" ARVIDA_JSONLD_RDF "nil>");
+        head = nil;
+        TermView node;
+        for (size_t i = 0; i < items.size(); ++i)
+        {
+            if (items[i].type == JsonValue::ARRAY)
+                return fail("lists of lists are not supported");
+            if (items[i].type == JsonValue::NULL_VALUE)
+                continue;
+            if (items[i].type == JsonValue::OBJECT && items[i].find("@list"))
+                return fail("lists of lists are not supported");
+            const TermView next = newBlank();
+            if (!node.is_valid())
+                head = next;
+            else
+                triples_.push_back(TripleView(node, rest, next));
+            node = next;
+            if (!processValue(ctx, node, first, coercion, items[i]))
+                return false;
+        }
+        if (node.is_valid())
+            triples_.push_back(TripleView(node, rest, nil));
+        return true;
+    }
+
+    static const char * numberType(const std::string &lexical)
+    {
+        return lexical.find_first_of(".eE") == std::string::npos ?
+            ARVIDA_NTRIPLES_XSD "integer" : ARVIDA_NTRIPLES_XSD "double";
+    }
+
+    Graph graph_;
+    std::vector<TripleView> triples_;
+    std::unordered_set<std::string> terms_; // elements are not moved on rehash
+    std::string error_;
+    size_t errorOffset_;
+    unsigned long nextBlank_;
+};
+
+} // namespace RDF
+} // namespace Arvida
+
+#endif
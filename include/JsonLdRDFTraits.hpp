@@ -0,0 +1,735 @@
+/*  ARVIDAPP - ARVIDA C++ Preprocessor
+ *
+ *  Copyright (C) 2015-2019 German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef JSONLD_RDF_TRAITS_HPP_INCLUDED
+#define JSONLD_RDF_TRAITS_HPP_INCLUDED
+
+#include "NTriplesReader.hpp"
+#include "JsonLdParser.hpp"
+#include "RDFProjection.hpp"
+#include "RDFPath.hpp"
+#include <memory>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <type_traits>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// Traits for the jsonld template: generated code writes compact JSON-LD
+// without an RDF library. Statements are collected into one node object per
+// subject, IRIs are compacted to prefixed names and the @context contains
+// the prefixes which were used. Nodes are identifiers (IRIs, prefixed names
+// or blank node identifiers), literal values are written as JSON values.
+// Generated readers are shared with the ntriples template, JsonLdParser.hpp
+// converts the document into their table of terms.
+
+namespace Arvida {
+namespace RDF {
+
+typedef std::string Node;
+typedef const std::string & NodeRef;
+
+inline void appendJsonString(std::string &out, const char *str, size_t length)
+{
+    out += '"';
+    // Characters which do not need escaping are appended in runs
+    size_t start = 0;
+    for (size_t i = 0; i < length; ++i)
+    {
+        const unsigned char c = static_cast<unsigned char>(str[i]);
+        if (c >= 0x20 && c != '"' && c != '\\')
+            continue;
+        out.append(str + start, i - start);
+        start = i + 1;
+        switch (c)
+        {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+            {
+                char buf[8];
+                std::snprintf(buf, sizeof(buf), "\\u%04X", (unsigned)c);
+                out += buf;
+            }
+        }
+    }
+    out.append(str + start, length - start);
+    out += '"';
+}
+
+inline void appendJsonString(std::string &out, const std::string &str)
+{
+    appendJsonString(out, str.data(), str.size());
+}
+
+// Output document
+//
+// Node objects are kept in order of their first statement and written by
+// write(). Terms are looked up once per document, so the document should be
+// reused (see clear()).
+
+class Document
+{
+public:
+
+    explicit Document(const Prefixes &prefixes = Prefixes())
+        : prefixes_(prefixes.begin(), prefixes.end())
+        , used_(prefixes.size(), false)
+        , xsdUsed_(false)
+        , nextBlank_(0)
+        , last_(0)
+    { }
+
+    // Returns key of prefixed name or absolute IRI, "@type" for rdf:type.
+    // Absolute IRIs are compacted like nodes (see appendNode). Terms are
+    // cached by address, so name must be a string literal.
+    const std::string & term(const char *name)
+    {
+        TermEntry &entry = terms_[name];
+        if (entry.key.empty())
+        {
+            entry.key = name;
+            entry.prefix = prefixIndex(entry.key);
+            const std::string iri = entry.prefix == NO_PREFIX ? entry.key :
+                prefixes_[entry.prefix].second + entry.key.substr(entry.key.find(':') + 1);
+            if (iri == ARVIDA_JSONLD_RDF_TYPE)
+            {
+                entry.key = "@type";
+                entry.prefix = NO_PREFIX;
+            }
+            else if (entry.prefix == NO_PREFIX)
+            {
+                entry.prefix = compactPrefix(iri);
+                if (entry.prefix != NO_PREFIX)
+                    entry.key = prefixes_[entry.prefix].first + ':' + iri.substr(prefixes_[entry.prefix].second.size());
+            }
+        }
+        if (entry.prefix != NO_PREFIX)
+            used_[entry.prefix] = true;
+        return entry.key;
+    }
+
+    Node blank()
+    {
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "_:b%lu", ++nextBlank_);
+        return Node(buf);
+    }
+
+    // Appends node as JSON string. IRIs starting with the IRI of a prefix are
+    // written as prefixed names with the longest matching prefix, unless the
+    // rest would make them look like an absolute IRI ("//"). The prefixes of
+    // written prefixed names are added to the @context.
+    void appendNode(std::string &out, const Node &node)
+    {
+        size_t prefix = prefixIndex(node);
+        if (prefix != NO_PREFIX)
+        {
+            used_[prefix] = true;
+            appendJsonString(out, node);
+            return;
+        }
+        prefix = compactPrefix(node);
+        if (prefix == NO_PREFIX)
+        {
+            appendJsonString(out, node);
+            return;
+        }
+        used_[prefix] = true;
+        const std::pair<std::string, std::string> &entry = prefixes_[prefix];
+        compacted_.assign(entry.first);
+        compacted_ += ':';
+        compacted_.append(node, entry.second.size(), std::string::npos);
+        appendJsonString(out, compacted_);
+    }
+
+    // Returns false when node was already serialized into this document
+    bool insertNode(const Node &node)
+    {
+        return serialized_.insert(node).second;
+    }
+
+    // Appends JSON value to the property of the node object of subject
+    std::string & beginValue(const Node &subject, const std::string &property)
+    {
+        NodeObject &node = nodeObject(subject);
+        for (size_t i = 0; i < node.properties.size(); ++i)
+        {
+            const std::string *key = node.properties[i].key;
+            if (key == &property || *key == property)
+                return nextValue(node.properties[i]);
+        }
+        node.properties.push_back(Property(&property));
+        return nextValue(node.properties.back());
+    }
+
+    void useXsd()
+    {
+        xsdUsed_ = true;
+    }
+
+    // Appends compact JSON-LD document
+    void write(std::string &out) const
+    {
+        out += "{\"@context\":{";
+        bool first = true;
+        for (size_t i = 0; i < prefixes_.size(); ++i)
+        {
+            if (!used_[i] && !(xsdUsed_ && prefixes_[i].first == "xsd"))
+                continue;
+            if (!first)
+                out += ',';
+            first = false;
+            appendJsonString(out, prefixes_[i].first);
+            out += ':';
+            appendJsonString(out, prefixes_[i].second);
+        }
+        if (xsdUsed_ && prefixIndex("xsd:") == NO_PREFIX)
+        {
+            if (!first)
+                out += ',';
+            out += "\"xsd\":\"" ARVIDA_NTRIPLES_XSD "\"";
+        }
+        out += "},\"@graph\":[";
+        for (size_t i = 0; i < nodes_.size(); ++i)
+        {
+            const NodeObject &node = nodes_[i];
+            if (i > 0)
+                out += ',';
+            out += "{\"@id\":";
+            out += node.json;
+            for (size_t j = 0; j < node.properties.size(); ++j)
+            {
+                const Property &property = node.properties[j];
+                out += ',';
+                appendJsonString(out, *property.key);
+                out += ':';
+                if (property.count > 1)
+                    out += '[';
+                out += property.values;
+                if (property.count > 1)
+                    out += ']';
+            }
+            out += '}';
+        }
+        out += "]}";
+    }
+
+    std::string str() const
+    {
+        std::string out;
+        write(out);
+        return out;
+    }
+
+    // Clears node objects, keeps cached terms
+    void clear()
+    {
+        nodes_.clear();
+        index_.clear();
+        serialized_.clear();
+        used_.assign(used_.size(), false);
+        xsdUsed_ = false;
+        nextBlank_ = 0;
+        last_ = 0;
+    }
+
+private:
+    static const size_t NO_PREFIX = static_cast<size_t>(-1);
+
+    struct TermEntry
+    {
+        std::string key;
+        size_t prefix;
+
+        TermEntry() : prefix(NO_PREFIX) { }
+    };
+
+    struct Property
+    {
+        const std::string *key;
+        std::string values;
+        size_t count;
+
+        explicit Property(const std::string *key) : key(key), count(0) { }
+    };
+
+    struct NodeObject
+    {
+        std::string id;
+        // id as (compacted) JSON string
+        std::string json;
+        std::vector<Property> properties;
+
+        explicit NodeObject(const std::string &id) : id(id) { }
+    };
+
+    size_t prefixIndex(const std::string &name) const
+    {
+        const size_t colon = name.find(':');
+        if (colon == std::string::npos || name.compare(colon, 3, "://") == 0)
+            return NO_PREFIX;
+        for (size_t i = 0; i < prefixes_.size(); ++i)
+        {
+            if (prefixes_[i].first.size() == colon && name.compare(0, colon, prefixes_[i].first) == 0)
+                return i;
+        }
+        return NO_PREFIX;
+    }
+
+    // Index of the longest prefix which compacts iri (see appendNode)
+    size_t compactPrefix(const std::string &iri) const
+    {
+        if (iri.compare(0, 2, "_:") == 0)
+            return NO_PREFIX;
+        size_t result = NO_PREFIX;
+        size_t length = 0;
+        for (size_t i = 0; i < prefixes_.size(); ++i)
+        {
+            const std::string &prefixIRI = prefixes_[i].second;
+            if (prefixIRI.size() <= length || prefixIRI.size() >= iri.size() ||
+                iri.compare(0, prefixIRI.size(), prefixIRI) != 0 ||
+                iri.compare(prefixIRI.size(), 2, "//") == 0)
+                continue;
+            result = i;
+            length = prefixIRI.size();
+        }
+        return result;
+    }
+
+    // Statements of one subject are usually written in a row
+    NodeObject & nodeObject(const Node &subject)
+    {
+        if (last_ < nodes_.size() && nodes_[last_].id == subject)
+            return nodes_[last_];
+        std::unordered_map<std::string, size_t>::const_iterator it = index_.find(subject);
+        if (it != index_.end())
+            last_ = it->second;
+        else
+        {
+            last_ = nodes_.size();
+            index_.insert(std::make_pair(subject, last_));
+            nodes_.push_back(NodeObject(subject));
+            appendNode(nodes_.back().json, subject);
+        }
+        return nodes_[last_];
+    }
+
+    static std::string & nextValue(Property &property)
+    {
+        if (property.count++ > 0)
+            property.values += ',';
+        return property.values;
+    }
+
+    std::vector<std::pair<std::string, std::string> > prefixes_;
+    std::vector<bool> used_;
+    bool xsdUsed_;
+    std::unordered_map<const char *, TermEntry> terms_;
+    std::vector<NodeObject> nodes_;
+    std::unordered_map<std::string, size_t> index_;
+    std::unordered_set<std::string> serialized_;
+    std::string compacted_;
+    unsigned long nextBlank_;
+    size_t last_;
+};
+
+struct Context
+{
+    Document &doc;
+    const std::string &base_path;
+    const std::string &path;
+    Cache *cache;
+    const void *user_data;
+    // Projection of toRDF (see RDFProjection.hpp) and depth of the object
+    // serialized with this context
+    const Projection *projection;
+    unsigned depth;
+
+    Context(Document &doc, const std::string &base_path, const std::string &path, Cache *cache = 0, const void *user_data = 0) : doc(doc), base_path(base_path), path(path), cache(cache), user_data(user_data), projection(0), depth(0) { }
+    Context(Document &doc, const std::string &path, Cache *cache = 0, const void *user_data = 0) : doc(doc), base_path(path), path(path), cache(cache), user_data(user_data), projection(0), depth(0) { }
+    Context(const Context &ctx) : doc(ctx.doc), base_path(ctx.base_path), path(ctx.path), cache(ctx.cache), user_data(ctx.user_data), projection(ctx.projection), depth(ctx.depth) { }
+    Context(const Context &ctx, const std::string &path) : doc(ctx.doc), base_path(ctx.base_path), path(path), cache(ctx.cache), user_data(ctx.user_data), projection(ctx.projection), depth(ctx.depth) { }
+};
+
+template <class T>
+inline bool isValidValue(const T &value)
+{
+    return true;
+}
+
+template < class T >
+inline bool isValidValue(const std::shared_ptr<T> &value)
+{
+    return value.operator bool();
+}
+
+// Literals
+
+template <class T>
+struct IsLiteral : std::false_type { };
+
+template <>
+struct IsLiteral<double> : std::true_type { };
+
+template <>
+struct IsLiteral<float> : std::true_type { };
+
+template <>
+struct IsLiteral<std::string> : std::true_type { };
+
+// Reference to a literal value, used as node
+template <class T>
+struct LiteralRef
+{
+    const T &value;
+
+    explicit LiteralRef(const T &value) : value(value) { }
+};
+
+// Finite values are written as JSON numbers with the shortest of the two
+// precisions which reads back to the same value. JSON-LD maps numbers
+// without fraction to xsd:integer, which the generated readers accept.
+template <class T>
+inline void appendJsonNumber(const Context &ctx, std::string &out, T value, int precision, int maxPrecision, const char *datatype)
+{
+    char buf[40];
+    if (std::isnan(value) || std::isinf(value))
+    {
+        ctx.doc.useXsd();
+        out += "{\"@value\":";
+        out += std::isnan(value) ? "\"NaN\"" : value < 0 ? "\"-INF\"" : "\"INF\"";
+        out += ",\"@type\":\"";
+        out += datatype;
+        out += "\"}";
+    }
+    else
+    {
+        int length = std::snprintf(buf, sizeof(buf), "%.*g", precision, value);
+        if (static_cast<T>(std::strtod(buf, 0)) != value)
+            length = std::snprintf(buf, sizeof(buf), "%.*g", maxPrecision, value);
+        out.append(buf, length);
+    }
+}
+
+inline void appendValue(const Context &ctx, std::string &out, const std::string &property, const Node &node)
+{
+    if (property == "@type")
+        ctx.doc.appendNode(out, node);
+    else
+    {
+        out += "{\"@id\":";
+        ctx.doc.appendNode(out, node);
+        out += '}';
+    }
+}
+
+inline void appendValue(const Context &ctx, std::string &out, const std::string &property, const LiteralRef<double> &literal)
+{
+    appendJsonNumber(ctx, out, literal.value, 15, 17, "xsd:double");
+}
+
+inline void appendValue(const Context &ctx, std::string &out, const std::string &property, const LiteralRef<float> &literal)
+{
+    appendJsonNumber(ctx, out, literal.value, 6, 9, "xsd:float");
+}
+
+inline void appendValue(const Context &ctx, std::string &out, const std::string &property, const LiteralRef<std::string> &literal)
+{
+    appendJsonString(out, literal.value);
+}
+
+template <class O>
+inline void writeTriple(const Context &ctx, const Node &subject, const std::string &predicate, const O &object)
+{
+    appendValue(ctx, ctx.doc.beginValue(subject, predicate), predicate, object);
+}
+
+// PathType
+
+enum PathType
+{
+    NO_PATH, RELATIVE_PATH, RELATIVE_TO_BASE_PATH, ABSOLUTE_PATH
+};
+
+// uidOf
+
+template<class T>
+inline std::string uidOf(const Context &ctx, const T &value)
+{
+    return value.getUid();
+}
+
+// pathOf_impl, pathTypeOf_impl
+
+template<class T>
+inline std::string pathOf_impl(const Context &ctx, const T &value)
+{
+    return uidOf(ctx, value);
+}
+
+template<class T>
+inline PathType pathTypeOf_impl(const Context &ctx, const T &value)
+{
+    return RELATIVE_TO_BASE_PATH;
+}
+
+// pathOf
+
+template<class T>
+inline std::string pathOf(const Context &ctx, const T &value)
+{
+    return pathOf_impl(ctx, value);
+}
+
+template<class T>
+inline std::string pathOf(const Context &ctx, const std::shared_ptr<T> &value)
+{
+    if (value)
+        return pathOf(ctx, *value);
+    else
+        return "";
+}
+
+template<class T>
+inline PathType pathTypeOf(const Context &ctx, const T &value)
+{
+    return pathTypeOf_impl(ctx, value);
+}
+
+template<class T>
+inline PathType pathTypeOf(const Context &ctx, const std::shared_ptr<T> &value)
+{
+    if (value)
+        return pathTypeOf(ctx, *value);
+    else
+        return NO_PATH;
+}
+
+template<>
+inline std::string pathOf(const Context &ctx, const double &value)
+{
+    return "";
+}
+
+template<>
+inline PathType pathTypeOf(const Context &ctx, const double &value)
+{
+    return NO_PATH;
+}
+
+template<>
+inline std::string pathOf(const Context &ctx, const float &value)
+{
+    return "";
+}
+
+template<>
+inline PathType pathTypeOf(const Context &ctx, const float &value)
+{
+    return NO_PATH;
+}
+
+template<>
+inline std::string pathOf(const Context &ctx, const std::string &value)
+{
+    return "";
+}
+
+template<>
+inline PathType pathTypeOf(const Context &ctx, const std::string &value)
+{
+    return NO_PATH;
+}
+
+template<class T>
+inline std::string pathOf(const Context &ctx, const std::vector<T> &value)
+{
+    return "";
+}
+
+template<class T>
+inline PathType pathTypeOf(const Context &ctx, const std::vector<T> &value)
+{
+    return RELATIVE_PATH;
+}
+
+inline std::string joinPath(const std::string &path1, const std::string path2)
+{
+    if (path2.empty())
+        return path1;
+    if (path1.empty())
+        return path2;
+
+    const char p1b = path1.back();
+    const char p2f = path2.front();
+
+    if (p1b == '/' && p2f == '/') {
+        return path1.substr(0, path1.size()-1) + path2;
+    } else if (p1b != '/' && p2f != '/') {
+        return path1 + '/' + path2;
+    } else {
+        return path1 + path2;
+    }
+}
+
+inline std::string resolvePath(const Context &ctx, PathType thatPathType, const std::string &thatPathOf,
+                               PathType memberPathType, const std::string &memberPath)
+{
+    if (thatPathType == ABSOLUTE_PATH)
+        return thatPathOf;
+    if (thatPathType == RELATIVE_TO_BASE_PATH)
+    {
+        std::string thatPath;
+        joinPathInto(thatPath, ctx.base_path, thatPathOf);
+        return thatPath;
+    }
+
+    std::string thatPath;
+    switch (memberPathType)
+    {
+        case NO_PATH:
+            thatPath = ctx.path;
+            break;
+        case RELATIVE_PATH:
+            joinPathInto(thatPath, ctx.path, memberPath);
+            break;
+        case RELATIVE_TO_BASE_PATH:
+            joinPathInto(thatPath, ctx.base_path, memberPath);
+            break;
+        case ABSOLUTE_PATH:
+            thatPath = memberPath;
+            break;
+    }
+    if (thatPathType == RELATIVE_PATH)
+        appendPath(thatPath, thatPathOf);
+    return thatPath;
+}
+
+// createRDFNode
+
+template<class T>
+Node createRDFNode(const Context &ctx, const T &value, PathType memberPathType, const std::string &memberPath)
+{
+    const PathType thatPathType = pathTypeOf(ctx, value);
+    if (thatPathType == NO_PATH)
+        return ctx.doc.blank();
+    return resolvePath(ctx, thatPathType, pathOf(ctx, value), memberPathType, memberPath);
+}
+
+template<class T>
+LiteralRef<T> createRDFNodeAndSerialize(const Context &ctx, const T &value, PathType memberPathType, const std::string &memberPath, std::true_type)
+{
+    return LiteralRef<T>(value);
+}
+
+template<class T>
+Node createRDFNodeAndSerialize(const Context &ctx, const T &value, PathType memberPathType, const std::string &memberPath, std::false_type)
+{
+    const PathType thatPathType = pathTypeOf(ctx, value);
+    if (thatPathType == NO_PATH)
+    {
+        Node thatNode(ctx.doc.blank());
+        if (!IsNestedObject<T>::value || !ctx.projection)
+            toRDF(ctx, thatNode, value);
+        else if (!projectionCut(ctx))
+        {
+            Arvida::RDF::Context thatCtx(ctx);
+            ++thatCtx.depth;
+            toRDF(thatCtx, thatNode, value);
+        }
+        return thatNode;
+    }
+    else
+    {
+        const std::string thatPath = resolvePath(ctx, thatPathType, pathOf(ctx, value), memberPathType, memberPath);
+        Arvida::RDF::Context thatCtx(ctx, thatPath);
+        ++thatCtx.depth;
+        Node thatNode(thatPath);
+        if (!projectionCut(ctx) && ctx.doc.insertNode(thatNode))
+            toRDF(thatCtx, thatNode, value);
+        return thatNode;
+    }
+}
+
+template<class T>
+auto createRDFNodeAndSerialize(const Context &ctx, const T &value, PathType memberPathType, const std::string &memberPath)
+    -> decltype(createRDFNodeAndSerialize(ctx, value, memberPathType, memberPath, typename IsLiteral<T>::type()))
+{
+    return createRDFNodeAndSerialize(ctx, value, memberPathType, memberPath, typename IsLiteral<T>::type());
+}
+
+// toRDF
+
+template < class T >
+inline NodeRef toRDF(const Context &ctx, NodeRef thisNode, const T &value)
+{
+    return value.toRDF(ctx, thisNode);
+}
+
+template < class T >
+inline NodeRef toRDF(const Context &ctx, NodeRef thisNode, const std::shared_ptr<T> &value)
+{
+    if (value)
+        return toRDF(ctx, thisNode, *value);
+    return thisNode;
+}
+
+template < class T >
+inline NodeRef toRDF(const Context &ctx, NodeRef thisNode, const std::vector<T> &value)
+{
+    writeTriple(ctx, thisNode, ctx.doc.term("rdf:type"), ctx.doc.term("core:Container"));
+
+    for (auto it = std::begin(value); it != std::end(value); ++it)
+    {
+        const auto & _that = *it;
+        if (isValidValue(_that))
+            writeTriple(ctx, thisNode, ctx.doc.term("core:member"), createRDFNodeAndSerialize(ctx, _that, NO_PATH, ""));
+    }
+    return thisNode;
+}
+
+// Reads value with path as subject from the parsed document
+
+template <class T>
+bool readJsonLd(const JsonLdGraph &graph, Vocabulary &vocabulary, const std::string &path, T &value, Cache *cache = 0, const void *user_data = 0)
+{
+    return readNTriples(graph.graph(), vocabulary, path, value, cache, user_data);
+}
+
+// Writes value with path as subject into the document
+
+template <class T>
+void writeJsonLd(Document &doc, const std::string &path, const T &value, Cache *cache = 0, const void *user_data = 0)
+{
+    Context ctx(doc, path, cache, user_data);
+    Node thisNode(path);
+    doc.insertNode(thisNode);
+    toRDF(ctx, thisNode, value);
+}
+
+} // namespace RDF
+} // namespace Arvida
+
+#endif
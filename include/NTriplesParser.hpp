@@ -0,0 +1,628 @@
+/*  ARVIDAPP - ARVIDA C++ Preprocessor
+ *
+ *  Copyright (C) 2015-2019 German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef NTRIPLES_PARSER_HPP_INCLUDED
+#define NTRIPLES_PARSER_HPP_INCLUDED
+
+#include "RDFTerm.hpp"
+#include <deque>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstring>
+#include <cstdint>
+#include <cstdlib>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ARVIDA_NTRIPLES_SSE2 1
+#include <emmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+namespace Arvida
+{
+namespace RDF
+{
+
+#define ARVIDA_NTRIPLES_XSD "http://www.w3.org/2001/XMLSchema#"
+
+// Term in N-Triples syntax referencing the parsed buffer, e.g. <http://a>,
+// _:b1 or "1.5"^^<http://www.w3.org/2001/XMLSchema#double>
+
+struct TermView
+{
+    const char *data;
+    size_t size;
+
+    TermView() : data(0), size(0) { }
+
+    TermView(const char *data, size_t size) : data(data), size(size) { }
+
+    explicit TermView(const std::string &str) : data(str.data()), size(str.size()) { }
+
+    bool is_valid() const { return data != 0; }
+
+    bool is_uri() const { return size > 0 && data[0] == '<'; }
+
+    bool is_blank() const { return size > 0 && data[0] == '_'; }
+
+    bool is_literal() const { return size > 0 && data[0] == '"'; }
+
+    std::string to_string() const { return std::string(data, size); }
+
+    bool operator==(const TermView &other) const
+    {
+        return size == other.size && (size == 0 || std::memcmp(data, other.data, size) == 0);
+    }
+
+    bool operator!=(const TermView &other) const
+    {
+        return !(*this == other);
+    }
+
+    // IRI without brackets, escapes are kept
+    TermView iri() const
+    {
+        return is_uri() ? TermView(data + 1, size - 2) : TermView();
+    }
+
+    // Lexical form of literal without quotes, escapes are kept
+    TermView lexical() const
+    {
+        if (!is_literal())
+            return TermView();
+        size_t end = size;
+        while (end > 1 && data[end - 1] != '"')
+            --end;
+        return TermView(data + 1, end - 2);
+    }
+
+    // Datatype term of literal, e.g. <http://www.w3.org/2001/XMLSchema#double>
+    TermView datatype() const
+    {
+        const TermView lex = lexical();
+        if (!lex.is_valid())
+            return TermView();
+        const char *p = lex.data + lex.size + 1;
+        const char *end = data + size;
+        if (end - p > 2 && p[0] == '^' && p[1] == '^')
+            return TermView(p + 2, end - p - 2);
+        return TermView();
+    }
+};
+
+struct TermViewHash
+{
+    size_t operator()(const TermView &term) const
+    {
+        uint64_t h = 14695981039346656037ULL;
+        for (size_t i = 0; i < term.size; ++i)
+        {
+            h ^= static_cast<unsigned char>(term.data[i]);
+            h *= 1099511628211ULL;
+        }
+        return static_cast<size_t>(h);
+    }
+};
+
+struct TripleView
+{
+    TermView subject;
+    TermView predicate;
+    TermView object;
+
+    TripleView() { }
+
+    TripleView(const TermView &subject, const TermView &predicate, const TermView &object)
+        : subject(subject), predicate(predicate), object(object)
+    { }
+
+    bool is_valid() const
+    {
+        return subject.is_valid() && predicate.is_valid() && object.is_valid();
+    }
+};
+
+// Appends UTF-8 encoding of code point
+inline void appendUTF8(std::string &out, unsigned long c)
+{
+    if (c < 0x80)
+        out += static_cast<char>(c);
+    else if (c < 0x800)
+    {
+        out += static_cast<char>(0xC0 | (c >> 6));
+        out += static_cast<char>(0x80 | (c & 0x3F));
+    }
+    else if (c < 0x10000)
+    {
+        out += static_cast<char>(0xE0 | (c >> 12));
+        out += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (c & 0x3F));
+    }
+    else
+    {
+        out += static_cast<char>(0xF0 | (c >> 18));
+        out += static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (c & 0x3F));
+    }
+}
+
+// Appends string with N-Triples escape sequences resolved
+inline void appendUnescaped(std::string &out, const TermView &str)
+{
+    const char *p = str.data;
+    const char *end = str.data + str.size;
+    while (p < end)
+    {
+        const char *backslash = static_cast<const char *>(std::memchr(p, '\\', end - p));
+        if (!backslash)
+        {
+            out.append(p, end - p);
+            return;
+        }
+        out.append(p, backslash - p);
+        p = backslash + 1;
+        if (p == end)
+            return;
+        const char c = *p++;
+        switch (c)
+        {
+            case 't': out += '\t'; break;
+            case 'b': out += '\b'; break;
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 'f': out += '\f'; break;
+            case 'u':
+            case 'U':
+            {
+                const size_t digits = c == 'u' ? 4 : 8;
+                if (static_cast<size_t>(end - p) < digits)
+                    return;
+                const std::string hex(p, digits);
+                appendUTF8(out, std::strtoul(hex.c_str(), 0, 16));
+                p += digits;
+                break;
+            }
+            default: out += c;
+        }
+    }
+}
+
+// Delimiter scanning
+
+#if defined(ARVIDA_NTRIPLES_SSE2)
+
+inline unsigned countTrailingZeros(unsigned mask)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return index;
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+#endif
+
+// Returns first occurrence of a or b in [p, end), or end
+inline const char * findEither(const char *p, const char *end, char a, char b)
+{
+#if defined(ARVIDA_NTRIPLES_SSE2)
+    const __m128i va = _mm_set1_epi8(a);
+    const __m128i vb = _mm_set1_epi8(b);
+    for (; end - p >= 16; p += 16)
+    {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        const unsigned mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, va), _mm_cmpeq_epi8(chunk, vb)));
+        if (mask)
+            return p + countTrailingZeros(mask);
+    }
+#endif
+    for (; p < end; ++p)
+    {
+        if (*p == a || *p == b)
+            return p;
+    }
+    return end;
+}
+
+// Returns first character in [p, end) which is not space or tab, or end
+inline const char * skipSpace(const char *p, const char *end)
+{
+#if defined(ARVIDA_NTRIPLES_SSE2)
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    for (; end - p >= 16; p += 16)
+    {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        const unsigned mask = ~_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(chunk, tab))) & 0xFFFF;
+        if (mask)
+            return p + countTrailingZeros(mask);
+    }
+#endif
+    while (p < end && (*p == ' ' || *p == '\t'))
+        ++p;
+    return p;
+}
+
+// Table of triples queried by the generated readers (Graph, MappedGraph)
+
+class TripleSource
+{
+public:
+
+    virtual ~TripleSource() { }
+
+    // Invalid terms are wildcards
+    virtual TripleView find_triple(const TermView &subject, const TermView &predicate, const TermView &object) const = 0;
+
+    virtual std::vector<TripleView> find_triples(const TermView &subject, const TermView &predicate, const TermView &object) const = 0;
+};
+
+// Graph
+//
+// Parses N-Triples into a table of triple views referencing the input
+// buffer. Triples are grouped by subject, so the triples of one subject are
+// adjacent and found with a single lookup. The input buffer must outlive
+// the graph.
+//
+// Terms are compared by their bytes. IRIs and literals with escape sequences
+// which differ from the form written by appendNTriplesTerm (e.g. \u0041
+// instead of A) are converted into that form and kept by the graph, so
+// equal terms compare equal regardless of their escapes.
+//
+// The subject and object indexes are built by parse() and assign(), lookups
+// do not modify the graph, so threads may read one graph concurrently.
+
+class Graph : public TripleSource
+{
+public:
+
+    Graph() : line_(0) { }
+
+    Graph(const Graph &) = delete;
+    Graph & operator=(const Graph &) = delete;
+
+    Graph(Graph &&) = default;
+    Graph & operator=(Graph &&) = default;
+
+    // Parses document, returns false on syntax error (see error(), errorLine())
+    bool parse(const char *data, size_t size)
+    {
+        clear();
+        std::vector<TripleView> parsed;
+        const char *p = data;
+        const char *end = data + size;
+        while (p < end)
+        {
+            ++line_;
+            p = skipSpace(p, end);
+            if (p == end)
+                break;
+            if (*p == '\n' || *p == '\r' || *p == '#')
+            {
+                p = nextLine(p, end);
+                continue;
+            }
+            TripleView triple;
+            if (!parseTerm(p, end, triple.subject) || triple.subject.is_literal())
+                return fail("invalid subject");
+            p = skipSpace(p, end);
+            if (!parseTerm(p, end, triple.predicate) || !triple.predicate.is_uri())
+                return fail("invalid predicate");
+            p = skipSpace(p, end);
+            if (!parseTerm(p, end, triple.object))
+                return fail("invalid object");
+            normalize(triple.subject);
+            normalize(triple.predicate);
+            normalize(triple.object);
+            p = skipSpace(p, end);
+            if (p == end || *p != '.')
+                return fail("expected '.'");
+            p = skipSpace(p + 1, end);
+            if (p != end && *p != '\n' && *p != '\r' && *p != '#')
+                return fail("unexpected character after '.'");
+            p = nextLine(p, end);
+            parsed.push_back(triple);
+        }
+        index(parsed);
+        return true;
+    }
+
+    bool parse(const std::string &document)
+    {
+        return parse(document.data(), document.size());
+    }
+
+    // Indexes triples whose terms are owned by the caller (e.g. the parser
+    // of another syntax), the terms must outlive the graph
+    void assign(const std::vector<TripleView> &triples)
+    {
+        clear();
+        index(triples);
+    }
+
+    void clear()
+    {
+        triples_.clear();
+        subjects_.clear();
+        objects_.clear();
+        objectTriples_.clear();
+        normalized_.clear();
+        error_.clear();
+        line_ = 0;
+    }
+
+    const std::string & error() const { return error_; }
+
+    size_t errorLine() const { return error_.empty() ? 0 : line_; }
+
+    size_t size() const { return triples_.size(); }
+
+    const std::vector<TripleView> & triples() const { return triples_; }
+
+    // Invalid terms are wildcards
+    virtual TripleView find_triple(const TermView &subject, const TermView &predicate, const TermView &object) const
+    {
+        TripleView result;
+        visit(subject, predicate, object, [&result](const TripleView &triple) { result = triple; return false; });
+        return result;
+    }
+
+    virtual std::vector<TripleView> find_triples(const TermView &subject, const TermView &predicate, const TermView &object) const
+    {
+        std::vector<TripleView> result;
+        visit(subject, predicate, object, [&result](const TripleView &triple) { result.push_back(triple); return true; });
+        return result;
+    }
+
+private:
+
+    typedef std::pair<uint32_t, uint32_t> Range;
+
+    static const char * nextLine(const char *p, const char *end)
+    {
+        const char *eol = static_cast<const char *>(std::memchr(p, '\n', end - p));
+        return eol ? eol + 1 : end;
+    }
+
+    bool fail(const char *message)
+    {
+        error_ = message;
+        triples_.clear();
+        return false;
+    }
+
+    static bool parseTerm(const char *&p, const char *end, TermView &term)
+    {
+        const char *begin = p;
+        if (p == end)
+            return false;
+        if (*p == '<')
+        {
+            p = findEither(p + 1, end, '>', '\n');
+            if (p == end || *p != '>')
+                return false;
+            ++p;
+        }
+        else if (*p == '_')
+        {
+            if (end - p < 3 || p[1] != ':')
+                return false;
+            p += 2;
+            while (p < end && *p != ' ' && *p != '\t' && *p != '\n' && *p != '\r' && *p != '<' && *p != '"')
+                ++p;
+            // A label does not end with '.', it terminates the triple
+            while (p - begin > 2 && p[-1] == '.')
+                --p;
+            if (p - begin == 2)
+                return false;
+        }
+        else if (*p == '"')
+        {
+            for (++p;;)
+            {
+                p = findEither(p, end, '"', '\\');
+                if (p == end)
+                    return false;
+                if (*p == '"')
+                    break;
+                p += 2;
+            }
+            ++p;
+            if (p < end && *p == '@')
+            {
+                while (p < end && *p != ' ' && *p != '\t' && *p != '.' && *p != '\n' && *p != '\r')
+                    ++p;
+            }
+            else if (end - p > 2 && p[0] == '^' && p[1] == '^' && p[2] == '<')
+            {
+                p = findEither(p + 3, end, '>', '\n');
+                if (p == end || *p != '>')
+                    return false;
+                ++p;
+            }
+        }
+        else
+            return false;
+        term = TermView(begin, p - begin);
+        return true;
+    }
+
+    // Replaces a term with escape sequences by the form written by
+    // appendNTriplesTerm, unless it is already in this form
+    void normalize(TermView &term)
+    {
+        if (term.is_blank() || !std::memchr(term.data, '\\', term.size))
+            return;
+        std::string normalized;
+        std::string unescaped;
+        if (term.is_uri())
+        {
+            appendUnescaped(unescaped, term.iri());
+            appendNTriplesIRI(normalized, unescaped.data(), unescaped.size());
+        }
+        else
+        {
+            const TermView lexical = term.lexical();
+            appendUnescaped(unescaped, lexical);
+            appendNTriplesString(normalized, unescaped.data(), unescaped.size());
+            const TermView datatype = term.datatype();
+            if (datatype.is_valid())
+            {
+                unescaped.clear();
+                appendUnescaped(unescaped, datatype.iri());
+                normalized += "^^";
+                appendNTriplesIRI(normalized, unescaped.data(), unescaped.size());
+            }
+            else
+            {
+                const char *suffix = lexical.data + lexical.size + 1;
+                normalized.append(suffix, term.data + term.size - suffix);
+            }
+        }
+        if (normalized.size() == term.size && std::memcmp(normalized.data(), term.data, term.size) == 0)
+            return;
+        normalized_.push_back(std::move(normalized));
+        term = TermView(normalized_.back());
+    }
+
+    // Groups triples by subject with a counting sort over subject ids
+    void index(const std::vector<TripleView> &parsed)
+    {
+        std::vector<uint32_t> ids(parsed.size());
+        std::vector<uint32_t> counts;
+        std::unordered_map<TermView, uint32_t, TermViewHash> subjectIds;
+        subjectIds.reserve(parsed.size() / 4 + 1);
+        for (size_t i = 0; i < parsed.size(); ++i)
+        {
+            auto ins = subjectIds.insert(std::make_pair(parsed[i].subject, static_cast<uint32_t>(counts.size())));
+            if (ins.second)
+                counts.push_back(0);
+            ids[i] = ins.first->second;
+            ++counts[ids[i]];
+        }
+
+        std::vector<uint32_t> offsets(counts.size() + 1, 0);
+        for (size_t s = 0; s < counts.size(); ++s)
+            offsets[s + 1] = offsets[s] + counts[s];
+
+        triples_.resize(parsed.size());
+        std::vector<uint32_t> next(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < parsed.size(); ++i)
+            triples_[next[ids[i]]++] = parsed[i];
+
+        subjects_.reserve(subjectIds.size());
+        for (auto it = subjectIds.begin(); it != subjectIds.end(); ++it)
+            subjects_.insert(std::make_pair(TermView(triples_[offsets[it->second]].subject),
+                                            Range(offsets[it->second], offsets[it->second + 1])));
+        indexObjects();
+    }
+
+    // Groups the positions of triples_ by object like index(). The index is
+    // built with the graph instead of on the first lookup without subject,
+    // so lookups do not modify the graph and a const graph can be shared
+    // between reader threads.
+    void indexObjects()
+    {
+        std::vector<uint32_t> ids(triples_.size());
+        std::vector<uint32_t> counts;
+        std::unordered_map<TermView, uint32_t, TermViewHash> objectIds;
+        objectIds.reserve(triples_.size() / 2 + 1);
+        for (size_t i = 0; i < triples_.size(); ++i)
+        {
+            auto ins = objectIds.insert(std::make_pair(triples_[i].object, static_cast<uint32_t>(counts.size())));
+            if (ins.second)
+                counts.push_back(0);
+            ids[i] = ins.first->second;
+            ++counts[ids[i]];
+        }
+
+        std::vector<uint32_t> offsets(counts.size() + 1, 0);
+        for (size_t o = 0; o < counts.size(); ++o)
+            offsets[o + 1] = offsets[o] + counts[o];
+
+        objectTriples_.resize(triples_.size());
+        std::vector<uint32_t> next(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < triples_.size(); ++i)
+            objectTriples_[next[ids[i]]++] = static_cast<uint32_t>(i);
+
+        objects_.reserve(objectIds.size());
+        for (auto it = objectIds.begin(); it != objectIds.end(); ++it)
+            objects_.insert(std::make_pair(it->first, Range(offsets[it->second], offsets[it->second + 1])));
+    }
+
+    static bool matches(const TripleView &triple, const TermView &predicate, const TermView &object)
+    {
+        return (!predicate.is_valid() || triple.predicate == predicate) &&
+               (!object.is_valid() || triple.object == object);
+    }
+
+    // Calls visitor for matching triples until it returns false
+    template <class Visitor>
+    void visit(const TermView &subject, const TermView &predicate, const TermView &object, Visitor visitor) const
+    {
+        if (subject.is_valid())
+        {
+            auto it = subjects_.find(subject);
+            if (it == subjects_.end())
+                return;
+            for (uint32_t i = it->second.first; i < it->second.second; ++i)
+            {
+                if (matches(triples_[i], predicate, object) && !visitor(triples_[i]))
+                    return;
+            }
+        }
+        else if (object.is_valid())
+        {
+            auto it = objects_.find(object);
+            if (it == objects_.end())
+                return;
+            for (uint32_t i = it->second.first; i < it->second.second; ++i)
+            {
+                const TripleView &triple = triples_[objectTriples_[i]];
+                if (matches(triple, predicate, object) && !visitor(triple))
+                    return;
+            }
+        }
+        else
+        {
+            for (size_t i = 0; i < triples_.size(); ++i)
+            {
+                if (matches(triples_[i], predicate, object) && !visitor(triples_[i]))
+                    return;
+            }
+        }
+    }
+
+    std::vector<TripleView> triples_;
+    std::unordered_map<TermView, Range, TermViewHash> subjects_;
+    std::unordered_map<TermView, Range, TermViewHash> objects_;
+    std::vector<uint32_t> objectTriples_;
+    std::deque<std::string> normalized_;
+    std::string error_;
+    size_t line_;
+};
+
+} // namespace RDF
+} // namespace Arvida
+
+#endif
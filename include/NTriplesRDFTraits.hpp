@@ -0,0 +1,467 @@
+/*  ARVIDAPP - ARVIDA C++ Preprocessor
+ *
+ *  Copyright (C) 2015-2019 German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef NTRIPLES_RDF_TRAITS_HPP_INCLUDED
+#define NTRIPLES_RDF_TRAITS_HPP_INCLUDED
+
+#include "RDFTerm.hpp"
+#include "NTriplesReader.hpp"
+#include "RDFProjection.hpp"
+#include "RDFPath.hpp"
+#include <memory>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <type_traits>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// Traits for the ntriples template: generated code writes N-Triples directly
+// into a byte buffer without an RDF library. Nodes are terms in N-Triples
+// syntax, literal values are not converted to nodes but appended in place.
+// Generated readers are shared with other templates (see NTriplesReader.hpp).
+
+namespace Arvida {
+namespace RDF {
+
+typedef std::string Node;
+typedef const std::string & NodeRef;
+
+// Output document
+//
+// Holds the buffer and the vocabulary. Vocabulary terms are expanded once
+// per document, so the document should be reused (see clear()).
+
+class Document
+{
+public:
+
+    std::string out;
+
+    explicit Document(const Prefixes &prefixes = Prefixes())
+        : vocabulary_(prefixes)
+        , nextBlank_(0)
+    { }
+
+    const Prefixes & prefixes() const { return vocabulary_.prefixes(); }
+
+    const std::string & term(const char *name)
+    {
+        return vocabulary_.term(name);
+    }
+
+    Node blank()
+    {
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "_:b%lu", ++nextBlank_);
+        return Node(buf);
+    }
+
+    // Returns false when node was already serialized into this document
+    bool insertNode(const Node &node)
+    {
+        return nodes_.insert(node).second;
+    }
+
+    // Clears output, keeps expanded terms
+    void clear()
+    {
+        out.clear();
+        nodes_.clear();
+        nextBlank_ = 0;
+    }
+
+private:
+    Vocabulary vocabulary_;
+    std::unordered_set<std::string> nodes_;
+    unsigned long nextBlank_;
+};
+
+struct Context
+{
+    Document &doc;
+    const std::string &base_path;
+    const std::string &path;
+    Cache *cache;
+    const void *user_data;
+    // Projection of toRDF (see RDFProjection.hpp) and depth of the object
+    // serialized with this context
+    const Projection *projection;
+    unsigned depth;
+
+    Context(Document &doc, const std::string &base_path, const std::string &path, Cache *cache = 0, const void *user_data = 0) : doc(doc), base_path(base_path), path(path), cache(cache), user_data(user_data), projection(0), depth(0) { }
+    Context(Document &doc, const std::string &path, Cache *cache = 0, const void *user_data = 0) : doc(doc), base_path(path), path(path), cache(cache), user_data(user_data), projection(0), depth(0) { }
+    Context(const Context &ctx) : doc(ctx.doc), base_path(ctx.base_path), path(ctx.path), cache(ctx.cache), user_data(ctx.user_data), projection(ctx.projection), depth(ctx.depth) { }
+    Context(const Context &ctx, const std::string &path) : doc(ctx.doc), base_path(ctx.base_path), path(path), cache(ctx.cache), user_data(ctx.user_data), projection(ctx.projection), depth(ctx.depth) { }
+};
+
+template <class T>
+inline bool isValidValue(const T &value)
+{
+    return true;
+}
+
+template < class T >
+inline bool isValidValue(const std::shared_ptr<T> &value)
+{
+    return value.operator bool();
+}
+
+// Literals
+
+template <class T>
+struct IsLiteral : std::false_type { };
+
+template <>
+struct IsLiteral<double> : std::true_type { };
+
+template <>
+struct IsLiteral<float> : std::true_type { };
+
+template <>
+struct IsLiteral<std::string> : std::true_type { };
+
+// Reference to a literal value, used as node
+template <class T>
+struct LiteralRef
+{
+    const T &value;
+
+    explicit LiteralRef(const T &value) : value(value) { }
+};
+
+// Writes shortest of the two precisions which reads back to the same value
+template <class T>
+inline void appendFloatingLiteral(std::string &out, T value, int precision, int maxPrecision, const char *datatype)
+{
+    char buf[40];
+    if (std::isnan(value))
+        out += "\"NaN\"";
+    else if (std::isinf(value))
+        out += value < 0 ? "\"-INF\"" : "\"INF\"";
+    else
+    {
+        int length = std::snprintf(buf, sizeof(buf), "\"%.*g\"", precision, value);
+        if (static_cast<T>(std::strtod(buf + 1, 0)) != value)
+            length = std::snprintf(buf, sizeof(buf), "\"%.*g\"", maxPrecision, value);
+        out.append(buf, length);
+    }
+    out += datatype;
+}
+
+inline void appendTerm(std::string &out, const Node &node)
+{
+    out += node;
+}
+
+inline void appendTerm(std::string &out, const LiteralRef<double> &literal)
+{
+    appendFloatingLiteral(out, literal.value, 15, 17, "^^<" ARVIDA_NTRIPLES_XSD "double>");
+}
+
+inline void appendTerm(std::string &out, const LiteralRef<float> &literal)
+{
+    appendFloatingLiteral(out, literal.value, 6, 9, "^^<" ARVIDA_NTRIPLES_XSD "float>");
+}
+
+inline void appendTerm(std::string &out, const LiteralRef<std::string> &literal)
+{
+    appendNTriplesString(out, literal.value.data(), literal.value.size());
+    out += "^^<" ARVIDA_NTRIPLES_XSD "string>";
+}
+
+template <class S, class P, class O>
+inline void writeTriple(const Context &ctx, const S &subject, const P &predicate, const O &object)
+{
+    std::string &out = ctx.doc.out;
+    appendTerm(out, subject);
+    out += ' ';
+    appendTerm(out, predicate);
+    out += ' ';
+    appendTerm(out, object);
+    out += " .\n";
+}
+
+// PathType
+
+enum PathType
+{
+    NO_PATH, RELATIVE_PATH, RELATIVE_TO_BASE_PATH, ABSOLUTE_PATH
+};
+
+// uidOf
+
+template<class T>
+inline std::string uidOf(const Context &ctx, const T &value)
+{
+    return value.getUid();
+}
+
+// pathOf_impl, pathTypeOf_impl
+
+template<class T>
+inline std::string pathOf_impl(const Context &ctx, const T &value)
+{
+    return uidOf(ctx, value);
+}
+
+template<class T>
+inline PathType pathTypeOf_impl(const Context &ctx, const T &value)
+{
+    return RELATIVE_TO_BASE_PATH;
+}
+
+// pathOf
+
+template<class T>
+inline std::string pathOf(const Context &ctx, const T &value)
+{
+    return pathOf_impl(ctx, value);
+}
+
+template<class T>
+inline std::string pathOf(const Context &ctx, const std::shared_ptr<T> &value)
+{
+    if (value)
+        return pathOf(ctx, *value);
+    else
+        return "";
+}
+
+template<class T>
+inline PathType pathTypeOf(const Context &ctx, const T &value)
+{
+    return pathTypeOf_impl(ctx, value);
+}
+
+template<class T>
+inline PathType pathTypeOf(const Context &ctx, const std::shared_ptr<T> &value)
+{
+    if (value)
+        return pathTypeOf(ctx, *value);
+    else
+        return NO_PATH;
+}
+
+template<>
+inline std::string pathOf(const Context &ctx, const double &value)
+{
+    return "";
+}
+
+template<>
+inline PathType pathTypeOf(const Context &ctx, const double &value)
+{
+    return NO_PATH;
+}
+
+template<>
+inline std::string pathOf(const Context &ctx, const float &value)
+{
+    return "";
+}
+
+template<>
+inline PathType pathTypeOf(const Context &ctx, const float &value)
+{
+    return NO_PATH;
+}
+
+template<>
+inline std::string pathOf(const Context &ctx, const std::string &value)
+{
+    return "";
+}
+
+template<>
+inline PathType pathTypeOf(const Context &ctx, const std::string &value)
+{
+    return NO_PATH;
+}
+
+template<class T>
+inline std::string pathOf(const Context &ctx, const std::vector<T> &value)
+{
+    return "";
+}
+
+template<class T>
+inline PathType pathTypeOf(const Context &ctx, const std::vector<T> &value)
+{
+    return RELATIVE_PATH;
+}
+
+inline std::string joinPath(const std::string &path1, const std::string path2)
+{
+    if (path2.empty())
+        return path1;
+    if (path1.empty())
+        return path2;
+
+    const char p1b = path1.back();
+    const char p2f = path2.front();
+
+    if (p1b == '/' && p2f == '/') {
+        return path1.substr(0, path1.size()-1) + path2;
+    } else if (p1b != '/' && p2f != '/') {
+        return path1 + '/' + path2;
+    } else {
+        return path1 + path2;
+    }
+}
+
+inline std::string resolvePath(const Context &ctx, PathType thatPathType, const std::string &thatPathOf,
+                               PathType memberPathType, const std::string &memberPath)
+{
+    if (thatPathType == ABSOLUTE_PATH)
+        return thatPathOf;
+    if (thatPathType == RELATIVE_TO_BASE_PATH)
+    {
+        std::string thatPath;
+        joinPathInto(thatPath, ctx.base_path, thatPathOf);
+        return thatPath;
+    }
+
+    std::string thatPath;
+    switch (memberPathType)
+    {
+        case NO_PATH:
+            thatPath = ctx.path;
+            break;
+        case RELATIVE_PATH:
+            joinPathInto(thatPath, ctx.path, memberPath);
+            break;
+        case RELATIVE_TO_BASE_PATH:
+            joinPathInto(thatPath, ctx.base_path, memberPath);
+            break;
+        case ABSOLUTE_PATH:
+            thatPath = memberPath;
+            break;
+    }
+    if (thatPathType == RELATIVE_PATH)
+        appendPath(thatPath, thatPathOf);
+    return thatPath;
+}
+
+inline Node uriNode(const std::string &uri)
+{
+    Node node;
+    appendNTriplesIRI(node, uri.data(), uri.size());
+    return node;
+}
+
+// createRDFNode
+
+template<class T>
+Node createRDFNode(const Context &ctx, const T &value, PathType memberPathType, const std::string &memberPath)
+{
+    const PathType thatPathType = pathTypeOf(ctx, value);
+    if (thatPathType == NO_PATH)
+        return ctx.doc.blank();
+    return uriNode(resolvePath(ctx, thatPathType, pathOf(ctx, value), memberPathType, memberPath));
+}
+
+template<class T>
+LiteralRef<T> createRDFNodeAndSerialize(const Context &ctx, const T &value, PathType memberPathType, const std::string &memberPath, std::true_type)
+{
+    return LiteralRef<T>(value);
+}
+
+template<class T>
+Node createRDFNodeAndSerialize(const Context &ctx, const T &value, PathType memberPathType, const std::string &memberPath, std::false_type)
+{
+    const PathType thatPathType = pathTypeOf(ctx, value);
+    if (thatPathType == NO_PATH)
+    {
+        Node thatNode(ctx.doc.blank());
+        if (!IsNestedObject<T>::value || !ctx.projection)
+            toRDF(ctx, thatNode, value);
+        else if (!projectionCut(ctx))
+        {
+            Arvida::RDF::Context thatCtx(ctx);
+            ++thatCtx.depth;
+            toRDF(thatCtx, thatNode, value);
+        }
+        return thatNode;
+    }
+    else
+    {
+        const std::string thatPath = resolvePath(ctx, thatPathType, pathOf(ctx, value), memberPathType, memberPath);
+        Arvida::RDF::Context thatCtx(ctx, thatPath);
+        ++thatCtx.depth;
+        Node thatNode(uriNode(thatPath));
+        if (!projectionCut(ctx) && ctx.doc.insertNode(thatNode))
+            toRDF(thatCtx, thatNode, value);
+        return thatNode;
+    }
+}
+
+template<class T>
+auto createRDFNodeAndSerialize(const Context &ctx, const T &value, PathType memberPathType, const std::string &memberPath)
+    -> decltype(createRDFNodeAndSerialize(ctx, value, memberPathType, memberPath, typename IsLiteral<T>::type()))
+{
+    return createRDFNodeAndSerialize(ctx, value, memberPathType, memberPath, typename IsLiteral<T>::type());
+}
+
+// toRDF
+
+template < class T >
+inline NodeRef toRDF(const Context &ctx, NodeRef thisNode, const T &value)
+{
+    return value.toRDF(ctx, thisNode);
+}
+
+template < class T >
+inline NodeRef toRDF(const Context &ctx, NodeRef thisNode, const std::shared_ptr<T> &value)
+{
+    if (value)
+        return toRDF(ctx, thisNode, *value);
+    return thisNode;
+}
+
+template < class T >
+inline NodeRef toRDF(const Context &ctx, NodeRef thisNode, const std::vector<T> &value)
+{
+    writeTriple(ctx, thisNode, ctx.doc.term("rdf:type"), ctx.doc.term("core:Container"));
+
+    for (auto it = std::begin(value); it != std::end(value); ++it)
+    {
+        const auto & _that = *it;
+        if (isValidValue(_that))
+            writeTriple(ctx, thisNode, ctx.doc.term("core:member"), createRDFNodeAndSerialize(ctx, _that, NO_PATH, ""));
+    }
+    return thisNode;
+}
+
+// Writes value with path as subject into the document
+
+template <class T>
+void writeNTriples(Document &doc, const std::string &path, const T &value, Cache *cache = 0, const void *user_data = 0)
+{
+    Context ctx(doc, path, cache, user_data);
+    Node thisNode(uriNode(path));
+    doc.insertNode(thisNode);
+    toRDF(ctx, thisNode, value);
+}
+
+} // namespace RDF
+} // namespace Arvida
+
+#endif
@@ -0,0 +1,258 @@
+/*  ARVIDAPP - ARVIDA C++ Preprocessor
+ *
+ *  Copyright (C) 2015-2019 German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef NTRIPLES_READER_HPP_INCLUDED
+#define NTRIPLES_READER_HPP_INCLUDED
+
+#include "RDFTerm.hpp"
+#include "NTriplesParser.hpp"
+#include "RDFSchema.hpp"
+#include "RDFStringRef.hpp"
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <map>
+#include <type_traits>
+#include <cstdlib>
+#include <cstring>
+#include <boost/any.hpp>
+
+// Generated readers of templates without an RDF library (ntriples, jsonld,
+// binary). They work on terms in N-Triples syntax held by a TripleSource:
+// a Graph parsed from N-Triples or built by the parser of another syntax, or
+// a MappedGraph snapshot file.
+
+namespace Arvida {
+namespace RDF {
+
+typedef std::unordered_map<std::string, boost::any> Cache;
+typedef std::map<std::string, std::string> Prefixes;
+
+// Vocabulary
+//
+// Terms of prefixed names and IRIs used in annotations, expanded once and
+// then copied into the output or compared with parsed terms.
+
+class Vocabulary
+{
+public:
+
+    explicit Vocabulary(const Prefixes &prefixes = Prefixes())
+        : prefixes_(prefixes)
+    { }
+
+    const Prefixes & prefixes() const { return prefixes_; }
+
+    // Returns term of prefixed name or absolute IRI. Expanded terms are
+    // cached by address, so name must be a string literal.
+    const std::string & term(const char *name)
+    {
+        std::string &result = terms_[name];
+        if (result.empty())
+        {
+            const std::string str(name);
+            const size_t colon = str.find(':');
+            Prefixes::const_iterator it = prefixes_.end();
+            if (colon != std::string::npos && str.compare(colon, 3, "://") != 0)
+                it = prefixes_.find(str.substr(0, colon));
+            if (it != prefixes_.end())
+            {
+                const std::string iri = it->second + str.substr(colon + 1);
+                appendNTriplesIRI(result, iri.data(), iri.size());
+            }
+            else
+                appendNTriplesIRI(result, str.data(), str.size());
+        }
+        return result;
+    }
+
+    // Keeps str until the vocabulary is destroyed, e.g. an unescaped literal
+    // read into a StringRef
+    const std::string & keep(std::string &&str)
+    {
+        strings_.push_back(std::move(str));
+        return strings_.back();
+    }
+
+private:
+    Prefixes prefixes_;
+    std::unordered_map<const char *, std::string> terms_;
+    std::deque<std::string> strings_;
+};
+
+struct ReadContext
+{
+    const TripleSource &graph;
+    Vocabulary &vocabulary;
+    const std::string &base_path;
+    const std::string &path;
+    Cache *cache;
+    const void *user_data;
+
+    ReadContext(const TripleSource &graph, Vocabulary &vocabulary, const std::string &path, Cache *cache = 0, const void *user_data = 0) : graph(graph), vocabulary(vocabulary), base_path(path), path(path), cache(cache), user_data(user_data) { }
+    ReadContext(const ReadContext &ctx) : graph(ctx.graph), vocabulary(ctx.vocabulary), base_path(ctx.base_path), path(ctx.path), cache(ctx.cache), user_data(ctx.user_data) { }
+
+    TermView term(const char *name) const
+    {
+        return TermView(vocabulary.term(name));
+    }
+};
+
+inline bool isLiteralType(const TermView &node, const char *datatype)
+{
+    const TermView type = node.datatype();
+    const size_t length = std::strlen(datatype);
+    return type.size == length + 2 && std::memcmp(type.data + 1, datatype, length) == 0;
+}
+
+template < class T >
+bool fromRDF(const ReadContext &ctx, const TermView &thisNode, T &value)
+{
+    return value.fromRDF(ctx, thisNode);
+}
+
+// Reads the members in mask (see Members<T>), specialized for annotated
+// classes. Other types are read completely.
+template < class T >
+bool fromRDF(const ReadContext &ctx, const TermView &thisNode, T &value, MemberMask mask)
+{
+    return fromRDF(ctx, thisNode, value);
+}
+
+template < class T >
+bool fromRDF_alloc(const ReadContext &ctx, const TermView &thisNode, std::shared_ptr<T> &value, std::true_type)
+{
+    if (!value)
+        value = std::make_shared<T>();
+    return fromRDF(ctx, thisNode, *value);
+}
+
+template < class T >
+bool fromRDF_alloc(const ReadContext &ctx, const TermView &thisNode, std::shared_ptr<T> &value, std::false_type)
+{
+    return value ? fromRDF(ctx, thisNode, *value) : false;
+}
+
+// Empty pointers to default constructible types are allocated
+template < class T >
+bool fromRDF(const ReadContext &ctx, const TermView &thisNode, std::shared_ptr<T> &value)
+{
+    return fromRDF_alloc(ctx, thisNode, value, typename std::is_default_constructible<T>::type());
+}
+
+template < class T >
+bool parseFloating(const TermView &node, T &value)
+{
+    if (isLiteralType(node, ARVIDA_NTRIPLES_XSD "integer") ||
+        isLiteralType(node, ARVIDA_NTRIPLES_XSD "decimal") ||
+        isLiteralType(node, ARVIDA_NTRIPLES_XSD "double") ||
+        isLiteralType(node, ARVIDA_NTRIPLES_XSD "float"))
+    {
+        const TermView lexical = node.lexical();
+        char buf[64];
+        if (lexical.size >= sizeof(buf))
+            return false;
+        std::memcpy(buf, lexical.data, lexical.size);
+        buf[lexical.size] = '\0';
+        char *endptr;
+        value = static_cast<T>(std::strtod(buf, &endptr));
+        if (endptr == buf)
+            return false;
+        // Trailing whitespace is allowed (xsd whitespace collapse), other
+        // characters are not
+        while (*endptr == ' ' || *endptr == '\t' || *endptr == '\n' || *endptr == '\r')
+            ++endptr;
+        return *endptr == '\0';
+    }
+    return false;
+}
+
+template <>
+inline bool fromRDF(const ReadContext &ctx, const TermView &_this0, double &value)
+{
+    return parseFloating(_this0, value);
+}
+
+template <>
+inline bool fromRDF(const ReadContext &ctx, const TermView &_this0, float &value)
+{
+    return parseFloating(_this0, value);
+}
+
+template <>
+inline bool fromRDF(const ReadContext &ctx, const TermView &_this0, std::string &value)
+{
+    value.clear();
+    if (_this0.is_literal())
+        appendUnescaped(value, _this0.lexical());
+    else if (_this0.is_uri())
+        appendUnescaped(value, _this0.iri());
+    else
+        value = _this0.to_string();
+    return true;
+}
+
+// References the lexical form (or IRI) in the parsed buffer, see
+// RDFStringRef.hpp. Strings with escapes are unescaped into the vocabulary.
+template <>
+inline bool fromRDF(const ReadContext &ctx, const TermView &_this0, StringRef &value)
+{
+    TermView str = _this0;
+    if (_this0.is_literal())
+        str = _this0.lexical();
+    else if (_this0.is_uri())
+        str = _this0.iri();
+    if (str.size > 0 && std::memchr(str.data, '\\', str.size))
+    {
+        std::string unescaped;
+        appendUnescaped(unescaped, str);
+        value = ctx.vocabulary.keep(std::move(unescaped));
+    }
+    else
+        value = StringRef(str.data, str.size);
+    return true;
+}
+
+#ifdef ARVIDA_RDF_HAS_STRING_VIEW
+template <>
+inline bool fromRDF(const ReadContext &ctx, const TermView &_this0, std::string_view &value)
+{
+    StringRef ref;
+    if (!fromRDF(ctx, _this0, ref))
+        return false;
+    value = ref;
+    return true;
+}
+#endif
+
+// Reads value with path as subject from the parsed document
+
+template <class T>
+bool readNTriples(const TripleSource &graph, Vocabulary &vocabulary, const std::string &path, T &value, Cache *cache = 0, const void *user_data = 0)
+{
+    ReadContext ctx(graph, vocabulary, path, cache, user_data);
+    std::string thisNode;
+    appendNTriplesIRI(thisNode, path.data(), path.size());
+    return fromRDF(ctx, TermView(thisNode), value);
+}
+
+} // namespace RDF
+} // namespace Arvida
+
+#endif
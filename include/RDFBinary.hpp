@@ -0,0 +1,721 @@
+/*  ARVIDAPP - ARVIDA C++ Preprocessor
+ *
+ *  Copyright (C) 2015-2019 German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef RDF_BINARY_HPP_INCLUDED
+#define RDF_BINARY_HPP_INCLUDED
+
+#include "RDFTerm.hpp"
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Arvida
+{
+namespace RDF
+{
+
+// Binary RDF format
+//
+// A document starts with the magic bytes "ARDF" and the format version,
+// followed by triples. Each term of a triple is a varint reference: 0 ends
+// the document, 1 introduces a new term definition and n >= 2 refers to the
+// dictionary term with id n - 2. A definition starts with a kind byte:
+//
+//   IRI      namespace reference (0: new namespace string follows,
+//            n: namespace n - 1) and local name
+//   BLANK    label
+//   STRING   lexical form of a literal without datatype and language
+//   LANG     lexical form and language tag
+//   TYPED    datatype term reference and lexical form
+//   DOUBLE   xsd:double as 8 bytes IEEE 754, little endian
+//   FLOAT    xsd:float as 4 bytes IEEE 754, little endian
+//   INTEGER  xsd:integer as zigzag varint
+//
+// Strings are a varint length followed by the bytes. Numeric literals are
+// written in place, all other terms get the next dictionary id. Numbers are
+// only written in binary when their lexical form is the canonical one, so
+// all terms read back unchanged.
+
+#define ARVIDA_BINARY_RDF_MAGIC "ARDF"
+#define ARVIDA_BINARY_RDF_VERSION 1
+#define ARVIDA_BINARY_RDF_XSD "http://www.w3.org/2001/XMLSchema#"
+
+enum BinaryTermKind
+{
+    BINARY_IRI = 'I',
+    BINARY_BLANK = 'B',
+    BINARY_STRING = 'S',
+    BINARY_LANG = 'L',
+    BINARY_TYPED = 'T',
+    BINARY_DOUBLE = 'D',
+    BINARY_FLOAT = 'F',
+    BINARY_INTEGER = 'N'
+};
+
+// Encoding primitives
+
+inline void appendVarint(std::string &out, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        out += static_cast<char>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    out += static_cast<char>(value);
+}
+
+inline void appendBinaryString(std::string &out, const char *str, size_t length)
+{
+    appendVarint(out, length);
+    out.append(str, length);
+}
+
+inline void appendLittleEndian(std::string &out, uint64_t value, unsigned bytes)
+{
+    for (unsigned i = 0; i < bytes; ++i)
+        out += static_cast<char>((value >> (8 * i)) & 0xFF);
+}
+
+inline uint64_t zigzagEncode(int64_t value)
+{
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+inline int64_t zigzagDecode(uint64_t value)
+{
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+enum VarintStatus
+{
+    VARINT_OK, VARINT_INCOMPLETE, VARINT_OVERFLOW
+};
+
+// Reads unsigned LEB128 value. Values of more than 64 bits are invalid,
+// so at most 10 bytes are read.
+inline VarintStatus readVarint(const char *&p, const char *end, uint64_t &value)
+{
+    value = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7)
+    {
+        if (p == end)
+            return VARINT_INCOMPLETE;
+        const unsigned char c = static_cast<unsigned char>(*p++);
+        // The 10th byte holds bit 63 only
+        if (shift == 63 && c > 1)
+            return VARINT_OVERFLOW;
+        value |= static_cast<uint64_t>(c & 0x7F) << shift;
+        if (!(c & 0x80))
+            return VARINT_OK;
+    }
+    return VARINT_OVERFLOW;
+}
+
+// Lexical forms of numbers, shortest precision which reads back the value
+
+template <class T>
+inline void appendCanonicalFloating(std::string &out, T value, int precision, int maxPrecision)
+{
+    if (std::isnan(value))
+        out += "NaN";
+    else if (std::isinf(value))
+        out += value < 0 ? "-INF" : "INF";
+    else
+    {
+        char buf[40];
+        int length = std::snprintf(buf, sizeof(buf), "%.*g", precision, value);
+        if (static_cast<T>(std::strtod(buf, 0)) != value)
+            length = std::snprintf(buf, sizeof(buf), "%.*g", maxPrecision, value);
+        out.append(buf, length);
+    }
+}
+
+inline void appendCanonicalInteger(std::string &out, int64_t value)
+{
+    char buf[24];
+    out.append(buf, std::snprintf(buf, sizeof(buf), "%lld", static_cast<long long>(value)));
+}
+
+inline bool parseCanonicalDouble(const std::string &lexical, double &value)
+{
+    if (lexical.empty() || lexical.size() > 32)
+        return false;
+    value = std::strtod(lexical.c_str(), 0);
+    std::string canonical;
+    appendCanonicalFloating(canonical, value, 15, 17);
+    return canonical == lexical;
+}
+
+inline bool parseCanonicalFloat(const std::string &lexical, float &value)
+{
+    if (lexical.empty() || lexical.size() > 32)
+        return false;
+    value = static_cast<float>(std::strtod(lexical.c_str(), 0));
+    std::string canonical;
+    appendCanonicalFloating(canonical, value, 6, 9);
+    return canonical == lexical;
+}
+
+inline bool parseCanonicalInteger(const std::string &lexical, int64_t &value)
+{
+    if (lexical.empty() || lexical.size() > 18)
+        return false;
+    value = std::strtoll(lexical.c_str(), 0, 10);
+    std::string canonical;
+    appendCanonicalInteger(canonical, value);
+    return canonical == lexical;
+}
+
+// Dictionary keys
+//
+// A key is the kind byte followed by the data of the term. Keys do not
+// depend on the stream, so they are used as nodes by generated code.
+
+inline std::string binaryIRIKey(const char *iri, size_t length)
+{
+    std::string key(1, static_cast<char>(BINARY_IRI));
+    key.append(iri, length);
+    return key;
+}
+
+inline std::string binaryBlankKey(const std::string &label)
+{
+    return static_cast<char>(BINARY_BLANK) + label;
+}
+
+inline std::string binaryStringKey(const std::string &lexical)
+{
+    return static_cast<char>(BINARY_STRING) + lexical;
+}
+
+// Returns key of term, canonical numbers are not looked up in the
+// dictionary but written in place (see BinaryRDFWriter::writeTerm())
+inline std::string binaryKey(const Term &term)
+{
+    std::string key;
+    switch (term.type)
+    {
+        case Term::URI:
+            return binaryIRIKey(term.value.data(), term.value.size());
+        case Term::BLANK:
+            return binaryBlankKey(term.value);
+        case Term::LITERAL:
+            if (!term.language.empty())
+            {
+                key += static_cast<char>(BINARY_LANG);
+                appendBinaryString(key, term.value.data(), term.value.size());
+                key += term.language;
+            }
+            else if (term.datatype.empty())
+                return binaryStringKey(term.value);
+            else
+            {
+                key += static_cast<char>(BINARY_TYPED);
+                appendBinaryString(key, term.datatype.data(), term.datatype.size());
+                key += term.value;
+            }
+            break;
+        case Term::NONE:
+            break;
+    }
+    return key;
+}
+
+// Writer
+//
+// Appends to a string which may be drained (e.g. sent and cleared) between
+// triples, the dictionary is kept until reset().
+
+class BinaryRDFWriter
+{
+public:
+
+    explicit BinaryRDFWriter(std::string &out)
+        : out_(out)
+        , started_(false)
+    { }
+
+    std::string & out() { return out_; }
+
+    // Appends reference to the term with the given key
+    void writeKey(const std::string &key)
+    {
+        begin();
+        std::unordered_map<std::string, uint64_t>::const_iterator it = ids_.find(key);
+        if (it != ids_.end())
+        {
+            appendVarint(out_, it->second + 2);
+            return;
+        }
+        out_ += '\1';
+        const char *data = key.data() + 1;
+        const size_t size = key.size() - 1;
+        const char kind = key[0];
+        if (kind == BINARY_IRI)
+            writeIRIDefinition(data, size);
+        else if (kind == BINARY_TYPED)
+        {
+            const char *p = data;
+            uint64_t length = 0;
+            readVarint(p, data + size, length);
+            // Datatype is defined first, its id precedes the id of the literal
+            out_ += kind;
+            writeKey(binaryIRIKey(p, length));
+            appendBinaryString(out_, p + length, data + size - p - length);
+        }
+        else if (kind == BINARY_LANG)
+        {
+            const char *p = data;
+            uint64_t length = 0;
+            readVarint(p, data + size, length);
+            out_ += kind;
+            out_.append(data, p + length - data);
+            appendBinaryString(out_, p + length, data + size - p - length);
+        }
+        else
+        {
+            out_ += kind;
+            appendBinaryString(out_, data, size);
+        }
+        ids_.insert(std::make_pair(key, ids_.size()));
+    }
+
+    void writeDouble(double value)
+    {
+        begin();
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        out_ += '\1';
+        out_ += static_cast<char>(BINARY_DOUBLE);
+        appendLittleEndian(out_, bits, 8);
+    }
+
+    void writeFloat(float value)
+    {
+        begin();
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        out_ += '\1';
+        out_ += static_cast<char>(BINARY_FLOAT);
+        appendLittleEndian(out_, bits, 4);
+    }
+
+    void writeInteger(int64_t value)
+    {
+        begin();
+        out_ += '\1';
+        out_ += static_cast<char>(BINARY_INTEGER);
+        appendVarint(out_, zigzagEncode(value));
+    }
+
+    void writeTerm(const Term &term)
+    {
+        if (term.is_literal() && term.language.empty())
+        {
+            double d;
+            float f;
+            int64_t i;
+            if (term.datatype == ARVIDA_BINARY_RDF_XSD "double" && parseCanonicalDouble(term.value, d))
+                return writeDouble(d);
+            if (term.datatype == ARVIDA_BINARY_RDF_XSD "float" && parseCanonicalFloat(term.value, f))
+                return writeFloat(f);
+            if (term.datatype == ARVIDA_BINARY_RDF_XSD "integer" && parseCanonicalInteger(term.value, i))
+                return writeInteger(i);
+        }
+        writeKey(binaryKey(term));
+    }
+
+    void writeTriple(const TermTriple &triple)
+    {
+        writeTerm(triple.subject);
+        writeTerm(triple.predicate);
+        writeTerm(triple.object);
+    }
+
+    // Ends the document, the next triple starts a new one
+    void end()
+    {
+        begin();
+        out_ += '\0';
+        reset();
+    }
+
+    // Clears the dictionary, the next triple starts a new document
+    void reset()
+    {
+        ids_.clear();
+        namespaces_.clear();
+        started_ = false;
+    }
+
+    size_t dictionarySize() const { return ids_.size(); }
+
+private:
+
+    void begin()
+    {
+        if (started_)
+            return;
+        out_ += ARVIDA_BINARY_RDF_MAGIC;
+        out_ += static_cast<char>(ARVIDA_BINARY_RDF_VERSION);
+        started_ = true;
+    }
+
+    // IRIs are split after the last '#' or '/' into namespace and local name
+    void writeIRIDefinition(const char *iri, size_t length)
+    {
+        size_t split = length;
+        while (split > 0 && iri[split - 1] != '#' && iri[split - 1] != '/')
+            --split;
+        out_ += static_cast<char>(BINARY_IRI);
+        const std::string ns(iri, split);
+        std::unordered_map<std::string, uint64_t>::const_iterator it = namespaces_.find(ns);
+        if (it != namespaces_.end())
+            appendVarint(out_, it->second + 1);
+        else
+        {
+            appendVarint(out_, 0);
+            appendBinaryString(out_, iri, split);
+            namespaces_.insert(std::make_pair(ns, namespaces_.size()));
+        }
+        appendBinaryString(out_, iri + split, length - split);
+    }
+
+    std::string &out_;
+    bool started_;
+    std::unordered_map<std::string, uint64_t> ids_;
+    std::unordered_map<std::string, uint64_t> namespaces_;
+};
+
+// Term of a triple read from the stream. Dictionary terms stay valid until
+// the reader is reset, numeric literals (id == NO_ID) until the next triple.
+
+struct BinaryTermRef
+{
+    static const uint64_t NO_ID = ~static_cast<uint64_t>(0);
+
+    const Term *term;
+    uint64_t id;
+
+    BinaryTermRef() : term(0), id(NO_ID) { }
+};
+
+// Streaming reader
+//
+// Data may be fed in chunks of any size, next() returns NEED_DATA until a
+// complete triple is available. After the end of a document the next one
+// may follow in the same stream.
+
+class BinaryRDFReader
+{
+public:
+
+    enum Status
+    {
+        TRIPLE, NEED_DATA, END_OF_DOCUMENT, ERROR
+    };
+
+    BinaryRDFReader() : pos_(0), header_(false) { }
+
+    void feed(const char *data, size_t size)
+    {
+        if (pos_ > 0 && pos_ >= buffer_.size() / 2)
+        {
+            buffer_.erase(0, pos_);
+            pos_ = 0;
+        }
+        buffer_.append(data, size);
+    }
+
+    void feed(const std::string &data)
+    {
+        feed(data.data(), data.size());
+    }
+
+    Status next(BinaryTermRef (&triple)[3])
+    {
+        if (!error_.empty())
+            return ERROR;
+        const char *begin = buffer_.data() + pos_;
+        const char *end = buffer_.data() + buffer_.size();
+        const char *p = begin;
+        if (!header_)
+        {
+            const size_t length = sizeof(ARVIDA_BINARY_RDF_MAGIC) - 1;
+            if (static_cast<size_t>(end - p) < length + 1)
+                return NEED_DATA;
+            if (std::memcmp(p, ARVIDA_BINARY_RDF_MAGIC, length) != 0 || p[length] != ARVIDA_BINARY_RDF_VERSION)
+                return fail("invalid header");
+            p += length + 1;
+            header_ = true;
+            pos_ = p - buffer_.data();
+        }
+        if (p == end)
+            return NEED_DATA;
+        if (*p == '\0')
+        {
+            pos_ = p + 1 - buffer_.data();
+            reset(false);
+            return END_OF_DOCUMENT;
+        }
+
+        const size_t terms = terms_.size();
+        const size_t namespaces = namespaces_.size();
+        for (int i = 0; i < 3; ++i)
+        {
+            const Status status = readTerm(p, end, triple[i], inline_[i]);
+            if (status != TRIPLE)
+            {
+                // Incomplete triple, the definitions are read again later
+                terms_.resize(terms);
+                namespaces_.resize(namespaces);
+                return status;
+            }
+        }
+        if (!triple[0].term->is_uri() && !triple[0].term->is_blank())
+            return fail("invalid subject");
+        if (!triple[1].term->is_uri())
+            return fail("invalid predicate");
+        pos_ = p - buffer_.data();
+        return TRIPLE;
+    }
+
+    Status next(TermTriple &triple)
+    {
+        BinaryTermRef refs[3];
+        const Status status = next(refs);
+        if (status == TRIPLE)
+        {
+            triple.subject = *refs[0].term;
+            triple.predicate = *refs[1].term;
+            triple.object = *refs[2].term;
+        }
+        return status;
+    }
+
+    // True when all data fed so far was consumed
+    bool empty() const { return pos_ == buffer_.size(); }
+
+    const std::string & error() const { return error_; }
+
+    void clear()
+    {
+        buffer_.clear();
+        pos_ = 0;
+        error_.clear();
+        reset(false);
+    }
+
+private:
+
+    Status fail(const char *message)
+    {
+        error_ = message;
+        return ERROR;
+    }
+
+    void reset(bool header)
+    {
+        header_ = header;
+        terms_.clear();
+        namespaces_.clear();
+    }
+
+    Status readNumber(const char *&p, const char *end, uint64_t &value)
+    {
+        switch (readVarint(p, end, value))
+        {
+            case VARINT_OK:
+                return TRIPLE;
+            case VARINT_INCOMPLETE:
+                return NEED_DATA;
+            default:
+                return fail("invalid number");
+        }
+    }
+
+    Status readString(const char *&p, const char *end, std::string &str)
+    {
+        uint64_t length;
+        const Status status = readNumber(p, end, length);
+        if (status != TRIPLE)
+            return status;
+        if (static_cast<uint64_t>(end - p) < length)
+            return NEED_DATA;
+        str.assign(p, length);
+        p += length;
+        return TRIPLE;
+    }
+
+    Status readTerm(const char *&p, const char *end, BinaryTermRef &ref, Term &scratch)
+    {
+        uint64_t value;
+        Status status = readNumber(p, end, value);
+        if (status != TRIPLE)
+            return status;
+        if (value >= 2)
+        {
+            if (value - 2 >= terms_.size())
+                return fail("invalid term reference");
+            ref.id = value - 2;
+            ref.term = &terms_[value - 2];
+            return TRIPLE;
+        }
+        if (value == 0)
+            return fail("unexpected end of document");
+        if (p == end)
+            return NEED_DATA;
+
+        const char kind = *p++;
+        Term term;
+        switch (kind)
+        {
+            case BINARY_IRI:
+            {
+                uint64_t ns;
+                status = readNumber(p, end, ns);
+                if (status != TRIPLE)
+                    return status;
+                std::string local;
+                if (ns == 0)
+                {
+                    std::string str;
+                    status = readString(p, end, str);
+                    if (status != TRIPLE)
+                        return status;
+                    namespaces_.push_back(str);
+                    ns = namespaces_.size();
+                }
+                if (ns - 1 >= namespaces_.size())
+                    return fail("invalid namespace reference");
+                status = readString(p, end, local);
+                if (status != TRIPLE)
+                    return status;
+                term = Term(Term::URI, namespaces_[ns - 1] + local);
+                break;
+            }
+            case BINARY_BLANK:
+                term.type = Term::BLANK;
+                status = readString(p, end, term.value);
+                if (status != TRIPLE)
+                    return status;
+                break;
+            case BINARY_STRING:
+                term.type = Term::LITERAL;
+                status = readString(p, end, term.value);
+                if (status != TRIPLE)
+                    return status;
+                break;
+            case BINARY_LANG:
+                term.type = Term::LITERAL;
+                status = readString(p, end, term.value);
+                if (status == TRIPLE)
+                    status = readString(p, end, term.language);
+                if (status != TRIPLE)
+                    return status;
+                break;
+            case BINARY_TYPED:
+            {
+                BinaryTermRef datatype;
+                Term unused;
+                status = readTerm(p, end, datatype, unused);
+                if (status != TRIPLE)
+                    return status;
+                if (!datatype.term->is_uri())
+                    return fail("invalid datatype");
+                term.type = Term::LITERAL;
+                term.datatype = datatype.term->value;
+                status = readString(p, end, term.value);
+                if (status != TRIPLE)
+                    return status;
+                break;
+            }
+            case BINARY_DOUBLE:
+            case BINARY_FLOAT:
+            {
+                const unsigned bytes = kind == BINARY_DOUBLE ? 8 : 4;
+                if (static_cast<size_t>(end - p) < bytes)
+                    return NEED_DATA;
+                uint64_t bits = 0;
+                for (unsigned i = 0; i < bytes; ++i)
+                    bits |= static_cast<uint64_t>(static_cast<unsigned char>(p[i])) << (8 * i);
+                p += bytes;
+                scratch.type = Term::LITERAL;
+                scratch.value.clear();
+                scratch.language.clear();
+                if (kind == BINARY_DOUBLE)
+                {
+                    double d;
+                    std::memcpy(&d, &bits, sizeof(d));
+                    appendCanonicalFloating(scratch.value, d, 15, 17);
+                    scratch.datatype = ARVIDA_BINARY_RDF_XSD "double";
+                }
+                else
+                {
+                    const uint32_t bits32 = static_cast<uint32_t>(bits);
+                    float f;
+                    std::memcpy(&f, &bits32, sizeof(f));
+                    appendCanonicalFloating(scratch.value, f, 6, 9);
+                    scratch.datatype = ARVIDA_BINARY_RDF_XSD "float";
+                }
+                ref.id = BinaryTermRef::NO_ID;
+                ref.term = &scratch;
+                return TRIPLE;
+            }
+            case BINARY_INTEGER:
+            {
+                uint64_t bits;
+                status = readNumber(p, end, bits);
+                if (status != TRIPLE)
+                    return status;
+                scratch.type = Term::LITERAL;
+                scratch.value.clear();
+                scratch.language.clear();
+                appendCanonicalInteger(scratch.value, zigzagDecode(bits));
+                scratch.datatype = ARVIDA_BINARY_RDF_XSD "integer";
+                ref.id = BinaryTermRef::NO_ID;
+                ref.term = &scratch;
+                return TRIPLE;
+            }
+            default:
+                return fail("invalid term kind");
+        }
+        ref.id = terms_.size();
+        terms_.push_back(term);
+        ref.term = &terms_.back();
+        return TRIPLE;
+    }
+
+    std::string buffer_;
+    size_t pos_;
+    bool header_;
+    std::deque<Term> terms_; // elements are not moved by push_back
+    std::vector<std::string> namespaces_;
+    Term inline_[3];
+    std::string error_;
+};
+
+} // namespace RDF
+} // namespace Arvida
+
+#endif
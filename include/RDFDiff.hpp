@@ -0,0 +1,295 @@
+/*  ARVIDAPP - ARVIDA C++ Preprocessor
+ *
+ *  Copyright (C) 2015-2019 German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef RDF_DIFF_HPP_INCLUDED
+#define RDF_DIFF_HPP_INCLUDED
+
+#include "RDFTerm.hpp"
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <utility>
+#include <unordered_map>
+#include <cstdint>
+#include <cstdio>
+
+namespace Arvida
+{
+namespace RDF
+{
+
+// Hashing
+
+inline uint64_t hashBytes(const char *data, size_t length, uint64_t h = 14695981039346656037ULL)
+{
+    for (size_t i = 0; i < length; ++i)
+    {
+        h ^= static_cast<unsigned char>(data[i]);
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+inline uint64_t hashCombine(uint64_t seed, uint64_t value)
+{
+    value *= 0x9E3779B97F4A7C15ULL;
+    value ^= value >> 32;
+    return (seed ^ value) * 0xBF58476D1CE4E5B9ULL + (seed >> 29);
+}
+
+// Canonical blank node labeling
+//
+// Generated code emits blank nodes with a fixed structure relative to
+// named nodes (e.g. $this vom:quantityValue _:2), but with run dependent
+// identifiers. Blank nodes are relabeled by iterative refinement of a
+// hash over their edges, so the same object graph always produces the
+// same labels.
+
+inline void canonicalizeBlanks(TermTriples &triples)
+{
+    const size_t noBlank = static_cast<size_t>(-1);
+
+    std::unordered_map<std::string, size_t> blankIndex;
+    std::vector<size_t> subjectBlank(triples.size(), noBlank);
+    std::vector<size_t> objectBlank(triples.size(), noBlank);
+    std::vector<uint64_t> subjectHash(triples.size(), 0);
+    std::vector<uint64_t> predicateHash(triples.size(), 0);
+    std::vector<uint64_t> objectHash(triples.size(), 0);
+
+    std::string buf;
+    for (size_t i = 0; i < triples.size(); ++i)
+    {
+        const TermTriple &t = triples[i];
+        if (t.subject.is_blank())
+        {
+            auto ins = blankIndex.insert(std::make_pair(t.subject.value, blankIndex.size()));
+            subjectBlank[i] = ins.first->second;
+        }
+        else
+        {
+            buf.clear();
+            appendNTriplesTerm(buf, t.subject);
+            subjectHash[i] = hashBytes(buf.data(), buf.size());
+        }
+        if (t.object.is_blank())
+        {
+            auto ins = blankIndex.insert(std::make_pair(t.object.value, blankIndex.size()));
+            objectBlank[i] = ins.first->second;
+        }
+        else
+        {
+            buf.clear();
+            appendNTriplesTerm(buf, t.object);
+            objectHash[i] = hashBytes(buf.data(), buf.size());
+        }
+        buf.clear();
+        appendNTriplesTerm(buf, t.predicate);
+        predicateHash[i] = hashBytes(buf.data(), buf.size());
+    }
+
+    const size_t numBlanks = blankIndex.size();
+    if (numBlanks == 0)
+        return;
+
+    std::vector<std::vector<uint64_t> > signatures(numBlanks);
+
+    // Refines colors until the partition of blank nodes gets no finer
+    auto refine = [&](std::vector<uint64_t> &colors, bool useOutgoing)
+    {
+        size_t numColors = 0;
+        for (size_t round = 0; round <= numBlanks; ++round)
+        {
+            for (size_t b = 0; b < numBlanks; ++b)
+                signatures[b].clear();
+
+            for (size_t i = 0; i < triples.size(); ++i)
+            {
+                const uint64_t s = subjectBlank[i] != noBlank ? colors[subjectBlank[i]] : subjectHash[i];
+                const uint64_t o = objectBlank[i] != noBlank ? colors[objectBlank[i]] : objectHash[i];
+                if (useOutgoing && subjectBlank[i] != noBlank)
+                    signatures[subjectBlank[i]].push_back(hashCombine(hashCombine(1, predicateHash[i]), o));
+                if (objectBlank[i] != noBlank)
+                    signatures[objectBlank[i]].push_back(hashCombine(hashCombine(2, predicateHash[i]), s));
+            }
+
+            std::vector<uint64_t> next(numBlanks);
+            for (size_t b = 0; b < numBlanks; ++b)
+            {
+                std::sort(signatures[b].begin(), signatures[b].end());
+                uint64_t h = colors[b];
+                for (size_t j = 0; j < signatures[b].size(); ++j)
+                    h = hashCombine(h, signatures[b][j]);
+                next[b] = h;
+            }
+
+            std::vector<uint64_t> distinct(next);
+            std::sort(distinct.begin(), distinct.end());
+            const size_t nextNumColors = std::unique(distinct.begin(), distinct.end()) - distinct.begin();
+            colors.swap(next);
+            if (nextNumColors == numColors)
+                break;
+            numColors = nextNumColors;
+        }
+    };
+
+    // Blank nodes are labeled by the path they are reached from named
+    // nodes, so changing literals of a blank node keeps its label. Only
+    // blank nodes which are not distinguishable by incoming edges are
+    // labeled by their content.
+    std::vector<uint64_t> incoming(numBlanks, 0x424C414E4BULL);
+    refine(incoming, false);
+
+    std::vector<uint64_t> colors(incoming);
+    refine(colors, true);
+
+    {
+        std::vector<uint64_t> sorted(incoming);
+        std::sort(sorted.begin(), sorted.end());
+        for (size_t b = 0; b < numBlanks; ++b)
+        {
+            auto range = std::equal_range(sorted.begin(), sorted.end(), incoming[b]);
+            if (range.second - range.first == 1)
+                colors[b] = incoming[b];
+        }
+    }
+
+    // Blank nodes that could not be distinguished are structurally
+    // equivalent, they are numbered in order of their first use.
+    std::vector<size_t> order(numBlanks);
+    for (size_t b = 0; b < numBlanks; ++b)
+        order[b] = b;
+    std::stable_sort(order.begin(), order.end(), [&colors](size_t a, size_t b) { return colors[a] < colors[b]; });
+
+    std::vector<std::string> labels(numBlanks);
+    char label[40];
+    size_t tie = 0;
+    for (size_t k = 0; k < numBlanks; ++k)
+    {
+        const size_t b = order[k];
+        tie = (k > 0 && colors[order[k - 1]] == colors[b]) ? tie + 1 : 0;
+        if (tie == 0)
+            std::snprintf(label, sizeof(label), "c%016llx", (unsigned long long)colors[b]);
+        else
+            std::snprintf(label, sizeof(label), "c%016llx_%u", (unsigned long long)colors[b], (unsigned)tie);
+        labels[b] = label;
+    }
+
+    for (size_t i = 0; i < triples.size(); ++i)
+    {
+        if (subjectBlank[i] != noBlank)
+            triples[i].subject.value = labels[subjectBlank[i]];
+        if (objectBlank[i] != noBlank)
+            triples[i].object.value = labels[objectBlank[i]];
+    }
+}
+
+// Patch
+
+struct Patch
+{
+    TermTriples deletes;
+    TermTriples adds;
+
+    bool empty() const
+    {
+        return deletes.empty() && adds.empty();
+    }
+
+    // Writes patch in RDF Patch format: a transaction of D (delete) and
+    // A (add) rows with terms in N-Triples syntax.
+    void write(std::string &out) const
+    {
+        if (empty())
+            return;
+        out += "TX .\n";
+        for (size_t i = 0; i < deletes.size(); ++i)
+        {
+            out += "D ";
+            appendNTriplesTriple(out, deletes[i]);
+        }
+        for (size_t i = 0; i < adds.size(); ++i)
+        {
+            out += "A ";
+            appendNTriplesTriple(out, adds[i]);
+        }
+        out += "TC .\n";
+    }
+
+    std::string to_string() const
+    {
+        std::string result;
+        write(result);
+        return result;
+    }
+};
+
+// diff
+
+inline void sortTriples(const TermTriples &triples, std::vector<std::pair<std::string, size_t> > &keyed)
+{
+    keyed.clear();
+    keyed.reserve(triples.size());
+    for (size_t i = 0; i < triples.size(); ++i)
+    {
+        keyed.push_back(std::make_pair(std::string(), i));
+        appendNTriplesTriple(keyed.back().first, triples[i]);
+    }
+    std::sort(keyed.begin(), keyed.end());
+    keyed.erase(std::unique(keyed.begin(), keyed.end(),
+                            [](const std::pair<std::string, size_t> &a, const std::pair<std::string, size_t> &b)
+                            { return a.first == b.first; }),
+                keyed.end());
+}
+
+// Computes patch which transforms graph 'from' to graph 'to'.
+// Both graphs are canonicalized in place.
+inline Patch diff(TermTriples &from, TermTriples &to)
+{
+    canonicalizeBlanks(from);
+    canonicalizeBlanks(to);
+
+    std::vector<std::pair<std::string, size_t> > fromKeys, toKeys;
+    sortTriples(from, fromKeys);
+    sortTriples(to, toKeys);
+
+    Patch patch;
+    size_t i = 0, j = 0;
+    while (i < fromKeys.size() || j < toKeys.size())
+    {
+        if (j == toKeys.size() || (i < fromKeys.size() && fromKeys[i].first < toKeys[j].first))
+        {
+            patch.deletes.push_back(from[fromKeys[i].second]);
+            ++i;
+        }
+        else if (i == fromKeys.size() || toKeys[j].first < fromKeys[i].first)
+        {
+            patch.adds.push_back(to[toKeys[j].second]);
+            ++j;
+        }
+        else
+        {
+            ++i;
+            ++j;
+        }
+    }
+    return patch;
+}
+
+} // namespace RDF
+} // namespace Arvida
+
+#endif
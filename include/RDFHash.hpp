@@ -0,0 +1,145 @@
+/*  ARVIDAPP - ARVIDA C++ Preprocessor
+ *
+ *  Copyright (C) 2015-2019 German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef RDF_HASH_HPP_INCLUDED
+#define RDF_HASH_HPP_INCLUDED
+
+#include "RDFPath.hpp"
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace Arvida
+{
+namespace RDF
+{
+
+// Structural hash and equality
+//
+// The generated code specializes hashValue and equalValue for each annotated
+// class over the members which toRDF writes, i.e. the members referenced by
+// $that or an element of $that in a triple annotation, and over the values
+// which determine the node IRI of an object: its uid method or the $this
+// substitutions of path templates. Objects which are equal serialize to the
+// same statements (up to blank node labels), so callers can skip the
+// serialization of unchanged objects or memoize output in an unordered_map
+// keyed by ValueHash/ValueEqual.
+
+inline void combineHash(size_t &seed, size_t hash)
+{
+    seed ^= hash + static_cast<size_t>(0x9e3779b97f4a7c15ULL) + (seed << 6) + (seed >> 2);
+}
+
+template <class T>
+inline size_t hashScalar(const T &value, std::false_type)
+{
+    return std::hash<T>()(value);
+}
+
+template <class T>
+inline size_t hashScalar(const T &value, std::true_type)
+{
+    typedef typename std::underlying_type<T>::type Underlying;
+    return std::hash<Underlying>()(static_cast<Underlying>(value));
+}
+
+// Scalars, enums and strings, specialized for annotated classes
+template <class T>
+inline size_t hashValue(const T &value)
+{
+    return hashScalar(value, std::is_enum<T>());
+}
+
+template <class T>
+inline bool equalValue(const T &a, const T &b)
+{
+    return a == b;
+}
+
+template <class T>
+inline size_t hashValue(const std::shared_ptr<T> &value)
+{
+    return value ? hashValue(*value) : 0;
+}
+
+template <class T>
+inline bool equalValue(const std::shared_ptr<T> &a, const std::shared_ptr<T> &b)
+{
+    if (a == b)
+        return true;
+    return a && b && equalValue(*a, *b);
+}
+
+template <class T, class Allocator>
+inline size_t hashValue(const std::vector<T, Allocator> &value)
+{
+    size_t seed = value.size();
+    for (typename std::vector<T, Allocator>::const_iterator it = value.begin(); it != value.end(); ++it)
+        combineHash(seed, hashValue(*it));
+    return seed;
+}
+
+template <class T, class Allocator>
+inline bool equalValue(const std::vector<T, Allocator> &a, const std::vector<T, Allocator> &b)
+{
+    if (a.size() != b.size())
+        return false;
+    for (size_t i = 0; i < a.size(); ++i)
+        if (!equalValue(a[i], b[i]))
+            return false;
+    return true;
+}
+
+// Values substituted into path templates are compared by their formatted
+// form, as they only matter for the IRI
+
+template <class T>
+inline size_t hashPathValue(const T &value)
+{
+    std::string str;
+    appendPathValue(str, value);
+    return std::hash<std::string>()(str);
+}
+
+template <class A, class B>
+inline bool equalPathValue(const A &a, const B &b)
+{
+    std::string strA, strB;
+    appendPathValue(strA, a);
+    appendPathValue(strB, b);
+    return strA == strB;
+}
+
+template <class T>
+struct ValueHash
+{
+    size_t operator()(const T &value) const { return hashValue(value); }
+};
+
+template <class T>
+struct ValueEqual
+{
+    bool operator()(const T &a, const T &b) const { return equalValue(a, b); }
+};
+
+} // namespace RDF
+} // namespace Arvida
+
+#endif
@@ -0,0 +1,119 @@
+/*  ARVIDAPP - ARVIDA C++ Preprocessor
+ *
+ *  Copyright (C) 2015-2019 German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef RDF_LAZY_HPP_INCLUDED
+#define RDF_LAZY_HPP_INCLUDED
+
+#include "RDFHash.hpp"
+#include <functional>
+#include <memory>
+#include <utility>
+
+namespace Arvida
+{
+namespace RDF
+{
+
+// Lazily deserialized member
+//
+// Use Lazy<T> instead of std::shared_ptr<T> as type of a member (or as
+// element type of a container member). fromRDF of the traits headers does
+// not read the object, it stores a loader with the node and the model, and
+// the object is read on first access. Copies share the loaded object.
+// Loading is not thread-safe, and errors in the referenced object are only
+// detected when it is loaded (get() then returns an empty pointer).
+
+template <class T>
+class Lazy
+{
+public:
+    typedef std::function<bool (T &value)> Loader;
+
+    Lazy() { }
+
+    Lazy(std::shared_ptr<T> value) : state_(std::make_shared<State>())
+    {
+        state_->value = std::move(value);
+    }
+
+    explicit Lazy(Loader loader) : state_(std::make_shared<State>())
+    {
+        state_->loader = std::move(loader);
+    }
+
+    bool is_loaded() const { return !state_ || !state_->loader; }
+
+    // Reads the object when it is not loaded yet, returns whether there is one
+    bool load() const
+    {
+        if (!state_)
+            return false;
+        if (state_->loader)
+        {
+            Loader loader;
+            std::swap(loader, state_->loader);
+            std::shared_ptr<T> value = std::make_shared<T>();
+            if (loader(*value))
+                state_->value = std::move(value);
+        }
+        return state_->value.operator bool();
+    }
+
+    const std::shared_ptr<T> & get() const
+    {
+        static const std::shared_ptr<T> empty;
+        return load() ? state_->value : empty;
+    }
+
+    T & operator*() const { return *get(); }
+
+    T * operator->() const { return get().get(); }
+
+    // True for pending objects without loading them
+    explicit operator bool() const
+    {
+        return state_ && (state_->loader || state_->value);
+    }
+
+    void reset() { state_.reset(); }
+
+private:
+    struct State
+    {
+        std::shared_ptr<T> value;
+        Loader loader;
+    };
+
+    std::shared_ptr<State> state_;
+};
+
+template <class T>
+inline size_t hashValue(const Lazy<T> &value)
+{
+    return hashValue(value.get());
+}
+
+template <class T>
+inline bool equalValue(const Lazy<T> &a, const Lazy<T> &b)
+{
+    return equalValue(a.get(), b.get());
+}
+
+} // namespace RDF
+} // namespace Arvida
+
+#endif
@@ -0,0 +1,525 @@
+/*  ARVIDAPP - ARVIDA C++ Preprocessor
+ *
+ *  Copyright (C) 2015-2019 German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef RDF_MAPPED_GRAPH_HPP_INCLUDED
+#define RDF_MAPPED_GRAPH_HPP_INCLUDED
+
+#include "RDFTerm.hpp"
+#include "NTriplesParser.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define ARVIDA_MAPPED_GRAPH_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Arvida
+{
+namespace RDF
+{
+
+// Graph snapshot file
+//
+// The file is used in place after mapping it read-only into memory, so
+// opening a snapshot costs a page-in and a range check of the offsets and
+// term ids instead of a parse. Sections are aligned to 8 bytes and in host
+// byte order:
+//
+//   header      MappedGraphHeader
+//   offsets     uint64_t[terms + 1], start of each term in the term data
+//   term data   terms in N-Triples syntax, sorted bytewise
+//   SPO, POS, OSP
+//               uint32_t[3 * triples], term ids of the triples in the
+//               order of the index, sorted
+//
+// Term ids are positions in the sorted dictionary, terms are found by
+// binary search and every query is answered by a range of one index.
+
+#define ARVIDA_MAPPED_GRAPH_MAGIC "ARDFMAP1"
+#define ARVIDA_MAPPED_GRAPH_BYTE_ORDER 0x01020304u
+
+struct MappedGraphHeader
+{
+    char magic[8];
+    uint32_t byteOrder;
+    uint32_t reserved;
+    uint64_t terms;
+    uint64_t triples;
+    uint64_t offsets;
+    uint64_t termData;
+    uint64_t index[3];
+    uint64_t size;
+};
+
+enum MappedGraphIndex
+{
+    INDEX_SPO, INDEX_POS, INDEX_OSP
+};
+
+// Converts a term in N-Triples syntax
+inline Term toTerm(const TermView &view)
+{
+    Term term;
+    if (view.is_uri())
+    {
+        term.type = Term::URI;
+        appendUnescaped(term.value, view.iri());
+    }
+    else if (view.is_blank())
+    {
+        term.type = Term::BLANK;
+        term.value.assign(view.data + 2, view.size - 2);
+    }
+    else if (view.is_literal())
+    {
+        term.type = Term::LITERAL;
+        const TermView lexical = view.lexical();
+        appendUnescaped(term.value, lexical);
+        const TermView datatype = view.datatype();
+        const char *suffix = lexical.data + lexical.size + 1;
+        if (datatype.is_valid())
+            appendUnescaped(term.datatype, datatype.iri());
+        else if (suffix < view.data + view.size && *suffix == '@')
+            term.language.assign(suffix + 1, view.data + view.size - suffix - 1);
+    }
+    return term;
+}
+
+namespace MappedGraphDetail
+{
+
+inline bool termLess(const TermView &a, const TermView &b)
+{
+    const int cmp = std::memcmp(a.data, b.data, std::min(a.size, b.size));
+    return cmp < 0 || (cmp == 0 && a.size < b.size);
+}
+
+struct IdTriple
+{
+    uint32_t id[3];
+
+    bool operator<(const IdTriple &other) const
+    {
+        return std::lexicographical_compare(id, id + 3, other.id, other.id + 3);
+    }
+
+    bool operator==(const IdTriple &other) const
+    {
+        return std::equal(id, id + 3, other.id);
+    }
+};
+
+// Positions of subject, predicate and object in the entries of each index
+static const int ORDER[3][3] = { { 0, 1, 2 }, { 2, 0, 1 }, { 1, 2, 0 } };
+
+// Triple position stored at each entry position of each index
+static const int FIELD[3][3] = { { 0, 1, 2 }, { 1, 2, 0 }, { 2, 0, 1 } };
+
+inline void pad(std::string &out)
+{
+    while (out.size() % 8)
+        out += '\0';
+}
+
+} // namespace MappedGraphDetail
+
+// Writes snapshot of triples with terms in N-Triples syntax, e.g.
+// Graph::triples(). Duplicate triples are removed.
+inline bool writeMappedGraph(const std::string &fileName, const std::vector<TripleView> &triples)
+{
+    using namespace MappedGraphDetail;
+
+    std::vector<TermView> terms;
+    terms.reserve(triples.size() * 3);
+    for (size_t i = 0; i < triples.size(); ++i)
+    {
+        terms.push_back(triples[i].subject);
+        terms.push_back(triples[i].predicate);
+        terms.push_back(triples[i].object);
+    }
+    std::sort(terms.begin(), terms.end(), termLess);
+    terms.erase(std::unique(terms.begin(), terms.end()), terms.end());
+    if (terms.size() >= UINT32_MAX)
+        return false;
+
+    std::unordered_map<TermView, uint32_t, TermViewHash> ids;
+    ids.reserve(terms.size());
+    for (size_t i = 0; i < terms.size(); ++i)
+        ids[terms[i]] = static_cast<uint32_t>(i);
+
+    std::vector<IdTriple> spo(triples.size());
+    for (size_t i = 0; i < triples.size(); ++i)
+    {
+        spo[i].id[0] = ids[triples[i].subject];
+        spo[i].id[1] = ids[triples[i].predicate];
+        spo[i].id[2] = ids[triples[i].object];
+    }
+    std::sort(spo.begin(), spo.end());
+    spo.erase(std::unique(spo.begin(), spo.end()), spo.end());
+
+    MappedGraphHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, ARVIDA_MAPPED_GRAPH_MAGIC, sizeof(header.magic));
+    header.byteOrder = ARVIDA_MAPPED_GRAPH_BYTE_ORDER;
+    header.terms = terms.size();
+    header.triples = spo.size();
+
+    std::string out(sizeof(header), '\0');
+    header.offsets = out.size();
+    uint64_t offset = 0;
+    for (size_t i = 0; i <= terms.size(); ++i)
+    {
+        out.append(reinterpret_cast<const char *>(&offset), sizeof(offset));
+        if (i < terms.size())
+            offset += terms[i].size;
+    }
+    header.termData = out.size();
+    for (size_t i = 0; i < terms.size(); ++i)
+        out.append(terms[i].data, terms[i].size);
+    pad(out);
+
+    std::vector<IdTriple> entries(spo.size());
+    for (int index = INDEX_SPO; index <= INDEX_OSP; ++index)
+    {
+        for (size_t i = 0; i < spo.size(); ++i)
+        {
+            for (int k = 0; k < 3; ++k)
+                entries[i].id[ORDER[index][k]] = spo[i].id[k];
+        }
+        if (index != INDEX_SPO)
+            std::sort(entries.begin(), entries.end());
+        header.index[index] = out.size();
+        out.append(reinterpret_cast<const char *>(entries.data()), entries.size() * sizeof(IdTriple));
+        pad(out);
+    }
+    header.size = out.size();
+    std::memcpy(&out[0], &header, sizeof(header));
+
+    std::ofstream file(fileName.c_str(), std::ios::binary | std::ios::trunc);
+    file.write(out.data(), out.size());
+    return static_cast<bool>(file.flush());
+}
+
+inline bool writeMappedGraph(const std::string &fileName, const TermTriples &triples)
+{
+    std::vector<std::string> terms(triples.size() * 3);
+    std::vector<TripleView> views(triples.size());
+    for (size_t i = 0; i < triples.size(); ++i)
+    {
+        appendNTriplesTerm(terms[3 * i], triples[i].subject);
+        appendNTriplesTerm(terms[3 * i + 1], triples[i].predicate);
+        appendNTriplesTerm(terms[3 * i + 2], triples[i].object);
+        views[i] = TripleView(TermView(terms[3 * i]), TermView(terms[3 * i + 1]), TermView(terms[3 * i + 2]));
+    }
+    return writeMappedGraph(fileName, views);
+}
+
+// Read-only graph on a snapshot file. Term views point into the mapping
+// and stay valid until the graph is closed.
+
+class MappedGraph : public TripleSource
+{
+public:
+
+    static const uint32_t NO_ID = UINT32_MAX;
+
+    MappedGraph()
+        : data_(0), size_(0), header_(0), offsets_(0), termData_(0)
+    {
+        index_[0] = index_[1] = index_[2] = 0;
+    }
+
+    explicit MappedGraph(const std::string &fileName) : MappedGraph()
+    {
+        open(fileName);
+    }
+
+    MappedGraph(const MappedGraph &) = delete;
+    MappedGraph & operator=(const MappedGraph &) = delete;
+
+    ~MappedGraph()
+    {
+        close();
+    }
+
+    bool open(const std::string &fileName)
+    {
+        close();
+#if defined(ARVIDA_MAPPED_GRAPH_MMAP)
+        const int fd = ::open(fileName.c_str(), O_RDONLY);
+        if (fd < 0)
+            return fail("cannot open file");
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(MappedGraphHeader)))
+        {
+            ::close(fd);
+            return fail("invalid file size");
+        }
+        void *data = ::mmap(0, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (data == MAP_FAILED)
+            return fail("cannot map file");
+        data_ = static_cast<const char *>(data);
+        size_ = st.st_size;
+#else
+        std::ifstream file(fileName.c_str(), std::ios::binary | std::ios::ate);
+        if (!file)
+            return fail("cannot open file");
+        size_ = static_cast<size_t>(file.tellg());
+        buffer_.resize((size_ + 7) / 8);
+        file.seekg(0);
+        if (!file.read(reinterpret_cast<char *>(buffer_.data()), size_))
+            return fail("cannot read file");
+        data_ = reinterpret_cast<const char *>(buffer_.data());
+#endif
+        return validate();
+    }
+
+    void close()
+    {
+#if defined(ARVIDA_MAPPED_GRAPH_MMAP)
+        if (data_)
+            ::munmap(const_cast<char *>(data_), size_);
+#else
+        buffer_.clear();
+#endif
+        data_ = 0;
+        size_ = 0;
+        header_ = 0;
+        offsets_ = 0;
+        termData_ = 0;
+        index_[0] = index_[1] = index_[2] = 0;
+    }
+
+    bool is_open() const { return header_ != 0; }
+
+    const std::string & error() const { return error_; }
+
+    size_t size() const { return header_ ? header_->triples : 0; }
+
+    size_t termCount() const { return header_ ? header_->terms : 0; }
+
+    TermView term(uint32_t id) const
+    {
+        return TermView(termData_ + offsets_[id], offsets_[id + 1] - offsets_[id]);
+    }
+
+    // Returns id of term or NO_ID
+    uint32_t find_term(const TermView &term) const
+    {
+        size_t first = 0;
+        size_t count = termCount();
+        while (count > 0)
+        {
+            const size_t step = count / 2;
+            if (MappedGraphDetail::termLess(this->term(first + step), term))
+            {
+                first += step + 1;
+                count -= step + 1;
+            }
+            else
+                count = step;
+        }
+        return first < termCount() && this->term(first) == term ? static_cast<uint32_t>(first) : NO_ID;
+    }
+
+    virtual TripleView find_triple(const TermView &subject, const TermView &predicate, const TermView &object) const
+    {
+        TripleView result;
+        visit(subject, predicate, object, [&result](const TripleView &triple) { result = triple; return false; });
+        return result;
+    }
+
+    virtual std::vector<TripleView> find_triples(const TermView &subject, const TermView &predicate, const TermView &object) const
+    {
+        std::vector<TripleView> result;
+        visit(subject, predicate, object, [&result](const TripleView &triple) { result.push_back(triple); return true; });
+        return result;
+    }
+
+    // Calls function with matching triples until it returns false
+    template <class Function>
+    void visit(const TermView &subject, const TermView &predicate, const TermView &object, Function function) const
+    {
+        using MappedGraphDetail::ORDER;
+        using MappedGraphDetail::FIELD;
+
+        if (!is_open())
+            return;
+        const TermView terms[3] = { subject, predicate, object };
+        uint32_t ids[3];
+        for (int i = 0; i < 3; ++i)
+        {
+            ids[i] = terms[i].is_valid() ? find_term(terms[i]) : NO_ID;
+            if (terms[i].is_valid() && ids[i] == NO_ID)
+                return;
+        }
+
+        const bool s = subject.is_valid(), p = predicate.is_valid(), o = object.is_valid();
+        int index = INDEX_SPO;
+        if (s && !p && o)
+            index = INDEX_OSP;
+        else if (!s && p)
+            index = INDEX_POS;
+        else if (!s && o)
+            index = INDEX_OSP;
+
+        // Bound terms form a prefix of the entries of the chosen index
+        uint32_t key[3];
+        int length = 0;
+        while (length < 3 && ids[FIELD[index][length]] != NO_ID)
+        {
+            key[length] = ids[FIELD[index][length]];
+            ++length;
+        }
+
+        const uint32_t *entries = index_[index];
+        const std::pair<size_t, size_t> range = equalRange(entries, key, length);
+        for (size_t i = range.first; i < range.second; ++i)
+        {
+            const uint32_t *entry = entries + 3 * i;
+            const TripleView triple(term(entry[ORDER[index][0]]), term(entry[ORDER[index][1]]), term(entry[ORDER[index][2]]));
+            if (!function(triple))
+                return;
+        }
+    }
+
+private:
+
+    bool fail(const char *message)
+    {
+        error_ = message;
+        close();
+        return false;
+    }
+
+    // Checks that all offsets and term ids of the file are in range, so
+    // that a corrupt file cannot make queries read outside the mapping.
+    // The order of terms and index entries is not checked.
+    bool validate()
+    {
+        const MappedGraphHeader *header = reinterpret_cast<const MappedGraphHeader *>(data_);
+        if (std::memcmp(header->magic, ARVIDA_MAPPED_GRAPH_MAGIC, sizeof(header->magic)) != 0)
+            return fail("invalid magic");
+        if (header->byteOrder != ARVIDA_MAPPED_GRAPH_BYTE_ORDER)
+            return fail("file has different byte order");
+        if (header->size != size_ || header->terms >= UINT32_MAX || header->triples > size_ / 12 ||
+            header->offsets % 8 != 0 || header->offsets > size_ ||
+            (header->terms + 1) * 8 > size_ - header->offsets)
+            return fail("invalid header");
+        const uint64_t *offsets = reinterpret_cast<const uint64_t *>(data_ + header->offsets);
+        if (header->termData > size_)
+            return fail("invalid term data");
+        const uint64_t termDataSize = size_ - header->termData;
+        for (uint64_t i = 0; i < header->terms; ++i)
+        {
+            if (offsets[i] > offsets[i + 1])
+                return fail("invalid term offset");
+        }
+        if (offsets[header->terms] > termDataSize)
+            return fail("invalid term data");
+        for (int i = 0; i < 3; ++i)
+        {
+            if (header->index[i] % 4 != 0 || header->index[i] > size_ ||
+                header->triples * 12 > size_ - header->index[i])
+                return fail("invalid index");
+            const uint32_t *entries = reinterpret_cast<const uint32_t *>(data_ + header->index[i]);
+            for (uint64_t k = 0; k < header->triples * 3; ++k)
+            {
+                if (entries[k] >= header->terms)
+                    return fail("invalid term id in index");
+            }
+            index_[i] = entries;
+        }
+        header_ = header;
+        offsets_ = offsets;
+        termData_ = data_ + header->termData;
+        error_.clear();
+        return true;
+    }
+
+    // Range of entries whose first length ids equal key
+    std::pair<size_t, size_t> equalRange(const uint32_t *entries, const uint32_t *key, int length) const
+    {
+        const size_t triples = size();
+        size_t first = 0;
+        // Lower bound
+        size_t count = triples;
+        while (count > 0)
+        {
+            const size_t step = count / 2;
+            if (comparePrefix(entries + 3 * (first + step), key, length) < 0)
+            {
+                first += step + 1;
+                count -= step + 1;
+            }
+            else
+                count = step;
+        }
+        // Upper bound
+        size_t upper = first;
+        count = triples - first;
+        while (count > 0)
+        {
+            const size_t step = count / 2;
+            if (comparePrefix(entries + 3 * (upper + step), key, length) <= 0)
+            {
+                upper += step + 1;
+                count -= step + 1;
+            }
+            else
+                count = step;
+        }
+        return std::make_pair(first, upper);
+    }
+
+    static int comparePrefix(const uint32_t *entry, const uint32_t *key, int length)
+    {
+        for (int k = 0; k < length; ++k)
+        {
+            if (entry[k] != key[k])
+                return entry[k] < key[k] ? -1 : 1;
+        }
+        return 0;
+    }
+
+    const char *data_;
+    size_t size_;
+#if !defined(ARVIDA_MAPPED_GRAPH_MMAP)
+    std::vector<uint64_t> buffer_;
+#endif
+    const MappedGraphHeader *header_;
+    const uint64_t *offsets_;
+    const char *termData_;
+    const uint32_t *index_[3];
+    std::string error_;
+};
+
+} // namespace RDF
+} // namespace Arvida
+
+#endif
@@ -0,0 +1,231 @@
+/*  ARVIDAPP - ARVIDA C++ Preprocessor
+ *
+ *  Copyright (C) 2015-2019 German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef RDF_PATH_HPP_INCLUDED
+#define RDF_PATH_HPP_INCLUDED
+
+#include "RDFStringRef.hpp"
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace Arvida
+{
+namespace RDF
+{
+
+// Appends segment to path like joinPath of the traits headers: exactly one
+// '/' is between path and segment, empty paths and segments are not joined.
+inline void appendPath(std::string &path, const char *segment, size_t size)
+{
+    if (size == 0)
+        return;
+    if (!path.empty())
+    {
+        const bool slash1 = path[path.size() - 1] == '/';
+        const bool slash2 = segment[0] == '/';
+        if (slash1 && slash2)
+        {
+            ++segment;
+            --size;
+        }
+        else if (!slash1 && !slash2)
+            path += '/';
+    }
+    path.append(segment, size);
+}
+
+inline void appendPath(std::string &path, const std::string &segment)
+{
+    appendPath(path, segment.data(), segment.size());
+}
+
+// Substituted values of path templates. Strings are appended as they are,
+// characters as one character, bool as 1 or 0, integers in decimal and
+// floating point numbers with the precision needed to read them back, all
+// without a stream. Other types must be convertible to std::string.
+
+template <class T>
+struct IsPathInteger : std::integral_constant<bool,
+    std::is_integral<T>::value &&
+    !std::is_same<T, bool>::value &&
+    !std::is_same<T, char>::value &&
+    !std::is_same<T, signed char>::value &&
+    !std::is_same<T, unsigned char>::value>
+{ };
+
+inline void appendPathValue(std::string &path, const std::string &value)
+{
+    appendPath(path, value);
+}
+
+inline void appendPathValue(std::string &path, const char *value)
+{
+    const StringRef ref(value);
+    appendPath(path, ref.data(), ref.size());
+}
+
+inline void appendPathValue(std::string &path, const StringRef &value)
+{
+    appendPath(path, value.data(), value.size());
+}
+
+inline void appendPathValue(std::string &path, char value)
+{
+    appendPath(path, &value, 1);
+}
+
+inline void appendPathValue(std::string &path, signed char value)
+{
+    appendPathValue(path, static_cast<char>(value));
+}
+
+inline void appendPathValue(std::string &path, unsigned char value)
+{
+    appendPathValue(path, static_cast<char>(value));
+}
+
+inline void appendPathValue(std::string &path, bool value)
+{
+    appendPath(path, value ? "1" : "0", 1);
+}
+
+template <class T>
+inline typename std::enable_if<IsPathInteger<T>::value && std::is_signed<T>::value>::type
+appendPathValue(std::string &path, T value)
+{
+    char buf[32];
+    const int size = std::snprintf(buf, sizeof(buf), "%lld", static_cast<long long>(value));
+    appendPath(path, buf, static_cast<size_t>(size));
+}
+
+template <class T>
+inline typename std::enable_if<IsPathInteger<T>::value && !std::is_signed<T>::value>::type
+appendPathValue(std::string &path, T value)
+{
+    char buf[32];
+    const int size = std::snprintf(buf, sizeof(buf), "%llu", static_cast<unsigned long long>(value));
+    appendPath(path, buf, static_cast<size_t>(size));
+}
+
+// Floating point numbers are formatted with the shortest of two precisions
+// which reads back to the same value (like appendFloatingLiteral of
+// NTriplesRDFTraits.hpp), so different values give different paths
+template <class T>
+inline void appendPathFloating(std::string &path, T value, int precision, int maxPrecision)
+{
+    char buf[40];
+    int size = std::snprintf(buf, sizeof(buf), "%.*g", precision, value);
+    if (static_cast<T>(std::strtod(buf, 0)) != value)
+        size = std::snprintf(buf, sizeof(buf), "%.*g", maxPrecision, value);
+    appendPath(path, buf, static_cast<size_t>(size));
+}
+
+inline void appendPathValue(std::string &path, float value)
+{
+    appendPathFloating(path, value, 6, 9);
+}
+
+inline void appendPathValue(std::string &path, double value)
+{
+    appendPathFloating(path, value, 15, 17);
+}
+
+inline void appendPathValue(std::string &path, long double value)
+{
+    appendPathFloating(path, static_cast<double>(value), 15, 17);
+}
+
+template <class T>
+inline typename std::enable_if<!std::is_arithmetic<T>::value>::type
+appendPathValue(std::string &path, const T &value)
+{
+    const std::string &str = value;
+    appendPath(path, str);
+}
+
+// Formatter of a path template
+//
+// The generator compiles a path annotation like
+// "http://example.com/{deviceID}/head" into a chain of literal() and
+// value() calls. Literal segments are joined with their length known at
+// compile time, and the buffer is reserved for all literals at once.
+// str() moves the formatted path out of the formatter. A formatter
+// constructed with a buffer of the caller clears it and formats into it,
+// path() references the buffer. The generated code formats the paths of
+// container elements into one buffer, so its memory is reused for all
+// elements.
+
+class PathFormatter
+{
+public:
+    explicit PathFormatter(size_t literalSize)
+        : path_(&own_)
+    {
+        own_.reserve(literalSize + 32);
+    }
+
+    PathFormatter(std::string &buffer, size_t literalSize)
+        : path_(&buffer)
+    {
+        buffer.clear();
+        buffer.reserve(literalSize + 32);
+    }
+
+    PathFormatter(const PathFormatter &) = delete;
+
+    PathFormatter & operator=(const PathFormatter &) = delete;
+
+    template <size_t N>
+    PathFormatter & literal(const char (&segment)[N])
+    {
+        appendPath(*path_, segment, N - 1);
+        return *this;
+    }
+
+    template <class T>
+    PathFormatter & value(const T &value)
+    {
+        appendPathValue(*path_, value);
+        return *this;
+    }
+
+    const std::string & path() const { return *path_; }
+
+    std::string str() { return std::move(*path_); }
+
+private:
+    std::string own_;
+    std::string *path_;
+};
+
+// Joins base and path into result, reusing the buffer of result
+inline const std::string & joinPathInto(std::string &result, const std::string &base, const std::string &path)
+{
+    result.reserve(base.size() + path.size() + 1);
+    result.assign(base);
+    appendPath(result, path);
+    return result;
+}
+
+} // namespace RDF
+} // namespace Arvida
+
+#endif
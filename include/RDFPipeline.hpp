@@ -0,0 +1,344 @@
+/*  ARVIDAPP - ARVIDA C++ Preprocessor
+ *
+ *  Copyright (C) 2015-2019 German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef RDF_PIPELINE_HPP_INCLUDED
+#define RDF_PIPELINE_HPP_INCLUDED
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <cstddef>
+
+namespace Arvida
+{
+namespace RDF
+{
+
+// Bounded lock-free multi-producer/multi-consumer queue
+// (D. Vyukov's bounded MPMC queue). Capacity is rounded up to a power of two.
+
+template <class T>
+class BoundedQueue
+{
+public:
+
+    explicit BoundedQueue(size_t capacity)
+        : mask_(roundUp(capacity) - 1)
+        , cells_(new Cell[mask_ + 1])
+        , enqueuePos_(0)
+        , dequeuePos_(0)
+    {
+        for (size_t i = 0; i <= mask_; ++i)
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    BoundedQueue(const BoundedQueue &) = delete;
+    BoundedQueue & operator=(const BoundedQueue &) = delete;
+
+    size_t capacity() const { return mask_ + 1; }
+
+    // Approximate number of queued elements
+    size_t size() const
+    {
+        const size_t enq = enqueuePos_.load(std::memory_order_relaxed);
+        const size_t deq = dequeuePos_.load(std::memory_order_relaxed);
+        return enq > deq ? enq - deq : 0;
+    }
+
+    template <class U>
+    bool try_push(U &&value)
+    {
+        Cell *cell;
+        size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            cell = &cells_[pos & mask_];
+            const size_t seq = cell->sequence.load(std::memory_order_acquire);
+            const std::ptrdiff_t dif = (std::ptrdiff_t)seq - (std::ptrdiff_t)pos;
+            if (dif == 0)
+            {
+                if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (dif < 0)
+                return false;
+            else
+                pos = enqueuePos_.load(std::memory_order_relaxed);
+        }
+        cell->value = std::forward<U>(value);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_pop(T &value)
+    {
+        Cell *cell;
+        size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            cell = &cells_[pos & mask_];
+            const size_t seq = cell->sequence.load(std::memory_order_acquire);
+            const std::ptrdiff_t dif = (std::ptrdiff_t)seq - (std::ptrdiff_t)(pos + 1);
+            if (dif == 0)
+            {
+                if (dequeuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (dif < 0)
+                return false;
+            else
+                pos = dequeuePos_.load(std::memory_order_relaxed);
+        }
+        value = std::move(cell->value);
+        cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    static size_t roundUp(size_t n)
+    {
+        size_t result = 2;
+        while (result < n)
+            result <<= 1;
+        return result;
+    }
+
+    const size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+    alignas(64) std::atomic<size_t> enqueuePos_;
+    alignas(64) std::atomic<size_t> dequeuePos_;
+};
+
+// Asynchronous serialization pipeline
+//
+// The producer submits copies (snapshots) of annotated objects, background
+// workers pass them to a sink which runs the generated toRDF code and
+// writes the result. Submitting never takes a lock, when the queue is full
+// the drop policy decides what happens.
+
+enum DropPolicy
+{
+    DROP_NEWEST,  // reject the submitted snapshot
+    DROP_OLDEST,  // discard the oldest queued snapshot
+    BLOCK         // wait until workers free a slot (backpressure)
+};
+
+struct PipelineStats
+{
+    size_t submitted;
+    size_t dropped;
+    size_t processed;
+    size_t failed;
+    size_t depth;
+    size_t capacity;
+};
+
+template <class T>
+class SerializationPipeline
+{
+public:
+
+    typedef std::function<void (const T &)> Sink;
+    typedef std::function<Sink ()> SinkFactory;
+
+    // Each worker gets its own sink created by sinkFactory, so sinks do not
+    // need to be thread-safe (e.g. every sink can own its RDF world).
+    SerializationPipeline(const SinkFactory &sinkFactory, size_t capacity,
+                          DropPolicy policy = DROP_NEWEST, unsigned numWorkers = 1)
+        : queue_(capacity)
+        , policy_(policy)
+        , running_(true)
+        , submitted_(0)
+        , dropped_(0)
+        , processed_(0)
+        , failed_(0)
+    {
+        if (numWorkers == 0)
+            numWorkers = 1;
+        try
+        {
+            for (unsigned i = 0; i < numWorkers; ++i)
+                workers_.emplace_back(&SerializationPipeline::run, this, sinkFactory());
+        }
+        catch (...)
+        {
+            // Started workers must be joined before they are destroyed
+            stop();
+            throw;
+        }
+    }
+
+    SerializationPipeline(const SerializationPipeline &) = delete;
+    SerializationPipeline & operator=(const SerializationPipeline &) = delete;
+
+    ~SerializationPipeline()
+    {
+        stop();
+    }
+
+    // Returns false when the snapshot was dropped or the pipeline is stopped.
+    // Snapshots submitted after stop() are rejected without counting them.
+    bool submit(const T &value)
+    {
+        return push(value);
+    }
+
+    bool submit(T &&value)
+    {
+        return push(std::move(value));
+    }
+
+    size_t depth() const { return queue_.size(); }
+
+    size_t capacity() const { return queue_.capacity(); }
+
+    DropPolicy policy() const { return policy_; }
+
+    // True when the queue is filled up to given fraction, producers can use
+    // this to lower their submission rate
+    bool congested(double fraction = 0.75) const
+    {
+        return queue_.size() >= static_cast<size_t>(fraction * queue_.capacity());
+    }
+
+    PipelineStats stats() const
+    {
+        PipelineStats s;
+        s.submitted = submitted_.load(std::memory_order_relaxed);
+        s.dropped = dropped_.load(std::memory_order_relaxed);
+        s.processed = processed_.load(std::memory_order_relaxed);
+        s.failed = failed_.load(std::memory_order_relaxed);
+        s.depth = queue_.size();
+        s.capacity = queue_.capacity();
+        return s;
+    }
+
+    bool running() const { return running_.load(std::memory_order_acquire); }
+
+    // Waits until all submitted snapshots are processed, returns at once when
+    // the pipeline is stopped
+    void flush()
+    {
+        while (running() &&
+               processed_.load(std::memory_order_acquire) + failed_.load(std::memory_order_acquire) +
+               dropped_.load(std::memory_order_acquire) < submitted_.load(std::memory_order_acquire))
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+
+    // Processes remaining snapshots and stops workers. Snapshots which a
+    // concurrent submit() queued after the workers finished are dropped.
+    void stop()
+    {
+        if (!running_.exchange(false))
+            return;
+        for (size_t i = 0; i < workers_.size(); ++i)
+            workers_[i].join();
+        workers_.clear();
+        T value;
+        while (queue_.try_pop(value))
+            dropped_.fetch_add(1, std::memory_order_release);
+    }
+
+private:
+
+    template <class U>
+    bool push(U &&value)
+    {
+        if (!running())
+            return false;
+        submitted_.fetch_add(1, std::memory_order_relaxed);
+        for (;;)
+        {
+            if (queue_.try_push(std::forward<U>(value)))
+                return true;
+            switch (policy_)
+            {
+                case DROP_NEWEST:
+                    dropped_.fetch_add(1, std::memory_order_release);
+                    return false;
+                case DROP_OLDEST:
+                {
+                    T oldest;
+                    if (queue_.try_pop(oldest))
+                        dropped_.fetch_add(1, std::memory_order_release);
+                    break;
+                }
+                case BLOCK:
+                    if (!running())
+                    {
+                        dropped_.fetch_add(1, std::memory_order_release);
+                        return false;
+                    }
+                    std::this_thread::yield();
+                    break;
+            }
+        }
+    }
+
+    void run(Sink sink)
+    {
+        T value;
+        unsigned idle = 0;
+        for (;;)
+        {
+            if (queue_.try_pop(value))
+            {
+                idle = 0;
+                try
+                {
+                    sink(value);
+                    processed_.fetch_add(1, std::memory_order_release);
+                }
+                catch (...)
+                {
+                    failed_.fetch_add(1, std::memory_order_release);
+                }
+            }
+            else if (!running_.load(std::memory_order_acquire))
+                break;
+            else if (++idle < 64)
+                std::this_thread::yield();
+            else
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+
+    BoundedQueue<T> queue_;
+    const DropPolicy policy_;
+    std::atomic<bool> running_;
+    std::atomic<size_t> submitted_;
+    std::atomic<size_t> dropped_;
+    std::atomic<size_t> processed_;
+    std::atomic<size_t> failed_;
+    std::vector<std::thread> workers_;
+};
+
+} // namespace RDF
+} // namespace Arvida
+
+#endif
@@ -0,0 +1,164 @@
+/*  ARVIDAPP - ARVIDA C++ Preprocessor
+ *
+ *  Copyright (C) 2015-2019 German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef RDF_POOL_HPP_INCLUDED
+#define RDF_POOL_HPP_INCLUDED
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <utility>
+
+namespace Arvida
+{
+namespace RDF
+{
+
+// Thread-safe pool of reusable objects, e.g. WorldModel of the traits
+// headers. Objects are reset when they are returned, e.g. the model is
+// cleared while the world with its prefixes is kept.
+
+template <class T>
+class ResourcePool
+{
+public:
+    typedef std::function<std::unique_ptr<T> ()> Factory;
+    typedef std::function<void (T &)> Reset;
+
+    class Lease
+    {
+    public:
+        Lease() : pool_(0) { }
+
+        Lease(Lease &&other) : pool_(other.pool_), value_(std::move(other.value_))
+        {
+            other.pool_ = 0;
+        }
+
+        Lease & operator=(Lease &&other)
+        {
+            if (this != &other)
+            {
+                release();
+                pool_ = other.pool_;
+                value_ = std::move(other.value_);
+                other.pool_ = 0;
+            }
+            return *this;
+        }
+
+        Lease(const Lease &) = delete;
+        Lease & operator=(const Lease &) = delete;
+
+        ~Lease()
+        {
+            release();
+        }
+
+        T * get() const { return value_.get(); }
+
+        T & operator*() const { return *value_; }
+
+        T * operator->() const { return value_.get(); }
+
+        explicit operator bool() const { return value_.operator bool(); }
+
+        // Returns the object to the pool
+        void release()
+        {
+            if (pool_ && value_)
+                pool_->giveBack(std::move(value_));
+            pool_ = 0;
+            value_.reset();
+        }
+
+    private:
+        friend class ResourcePool;
+
+        Lease(ResourcePool *pool, std::unique_ptr<T> value) : pool_(pool), value_(std::move(value)) { }
+
+        ResourcePool *pool_;
+        std::unique_ptr<T> value_;
+    };
+
+    // maxIdle limits the number of objects kept for reuse, 0 means no limit
+    ResourcePool(const Factory &factory, const Reset &reset, size_t preallocate = 0, size_t maxIdle = 0)
+        : factory_(factory)
+        , reset_(reset)
+        , maxIdle_(maxIdle)
+    {
+        for (size_t i = 0; i < preallocate; ++i)
+            idle_.push_back(factory_());
+    }
+
+    // Uses T::clear() to reset returned objects
+    explicit ResourcePool(const Factory &factory, size_t preallocate = 0, size_t maxIdle = 0)
+        : ResourcePool(factory, [](T &value) { value.clear(); }, preallocate, maxIdle)
+    { }
+
+    ResourcePool(const ResourcePool &) = delete;
+    ResourcePool & operator=(const ResourcePool &) = delete;
+
+    Lease checkout()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!idle_.empty())
+            {
+                std::unique_ptr<T> value(std::move(idle_.back()));
+                idle_.pop_back();
+                return Lease(this, std::move(value));
+            }
+        }
+        return Lease(this, factory_());
+    }
+
+    size_t idle() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return idle_.size();
+    }
+
+private:
+
+    void giveBack(std::unique_ptr<T> value)
+    {
+        try
+        {
+            reset_(*value);
+        }
+        catch (...)
+        {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (maxIdle_ == 0 || idle_.size() < maxIdle_)
+            idle_.push_back(std::move(value));
+    }
+
+    Factory factory_;
+    Reset reset_;
+    const size_t maxIdle_;
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<T> > idle_;
+};
+
+} // namespace RDF
+} // namespace Arvida
+
+#endif
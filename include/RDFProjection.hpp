@@ -0,0 +1,107 @@
+/*  ARVIDAPP - ARVIDA C++ Preprocessor
+ *
+ *  Copyright (C) 2015-2019 German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef RDF_PROJECTION_HPP_INCLUDED
+#define RDF_PROJECTION_HPP_INCLUDED
+
+#include "RDFSchema.hpp"
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_map>
+
+namespace Arvida
+{
+namespace RDF
+{
+
+// Projection of toRDF
+//
+// Set as Context::projection, the generated toRDF writes only the writer
+// members in the mask of the class (see Members<T>, classes without a mask
+// are written completely). Class triples are always written. Objects nested
+// deeper than maxDepth are not serialized, only their node (the URI from
+// the path annotation or a blank node) is referenced. The object passed to
+// toRDF has depth 0, so maxDepth 0 writes no nested objects. A container
+// and its elements are one level.
+
+class Projection
+{
+public:
+    static const unsigned UNLIMITED = ~0u;
+
+    explicit Projection(unsigned maxDepth = UNLIMITED) : maxDepth_(maxDepth) { }
+
+    template <class T>
+    Projection & members(MemberMask mask)
+    {
+        masks_[std::type_index(typeid(T))] = mask;
+        return *this;
+    }
+
+    template <class T>
+    MemberMask mask() const
+    {
+        if (masks_.empty())
+            return ~MemberMask(0);
+        std::unordered_map<std::type_index, MemberMask>::const_iterator it = masks_.find(std::type_index(typeid(T)));
+        return it != masks_.end() ? it->second : ~MemberMask(0);
+    }
+
+    unsigned maxDepth() const { return maxDepth_; }
+
+    void setMaxDepth(unsigned maxDepth) { maxDepth_ = maxDepth; }
+
+    // Whether objects nested in an object at depth are only referenced
+    bool cut(unsigned depth) const { return depth >= maxDepth_; }
+
+private:
+    unsigned maxDepth_;
+    std::unordered_map<std::type_index, MemberMask> masks_;
+};
+
+// IsNestedObject: values which are a level of depth and are cut, i.e. all
+// values which are not serialized into a literal. Specialize for custom
+// literal types.
+
+template <class T>
+struct IsNestedObject : std::is_class<T> { };
+
+template <>
+struct IsNestedObject<std::string> : std::false_type { };
+
+template <class T>
+struct IsNestedObject<std::shared_ptr<T> > : IsNestedObject<T> { };
+
+template <class T>
+inline MemberMask projectionMask(const Projection *projection)
+{
+    return projection ? projection->mask<T>() : ~MemberMask(0);
+}
+
+template <class Context>
+inline bool projectionCut(const Context &ctx)
+{
+    return ctx.projection && ctx.projection->cut(ctx.depth);
+}
+
+} // namespace RDF
+} // namespace Arvida
+
+#endif
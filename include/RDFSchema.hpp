@@ -0,0 +1,280 @@
+/*  ARVIDAPP - ARVIDA C++ Preprocessor
+ *
+ *  Copyright (C) 2015-2019 German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef RDF_SCHEMA_HPP_INCLUDED
+#define RDF_SCHEMA_HPP_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Arvida
+{
+namespace RDF
+{
+
+// Schema tables
+//
+// With --schema-tables the generator describes the triple annotations of
+// each class as constexpr tables (Schema<T>::get()) and toRDF/fromRDF run
+// the engine below on them instead of inlined code. Only reading and
+// writing a member value is generated per member, as accessor functions
+// of SchemaWriters<T> and SchemaReaders<T>. The tables are also available
+// as reflection data, the schema template generates only them.
+
+// Member ids
+//
+// Members<T> defines an id (bit) for each annotated member of T, named like
+// the member, and ALL_MEMBERS. fromRDF(ctx, node, value, mask) reads only the
+// members in mask, the triples of other members are not looked up. A member
+// is also read when a requested member uses a blank node bound by it, class
+// triples (e.g. rdf:type) are always checked. toRDF writes the members in the
+// mask of the projection of the context (see RDFProjection.hpp).
+
+typedef uint64_t MemberMask;
+
+template <class T>
+struct Members;
+
+enum SchemaNodeKind
+{
+    SCHEMA_THIS,          // $this, the node of the object
+    SCHEMA_THAT,          // $that, the node of the member value
+    SCHEMA_BLANK,         // _:label of the class, value is the label
+    SCHEMA_PREFIXED_NAME,
+    SCHEMA_IRI
+};
+
+// Same values as PathType of the traits headers
+enum SchemaPathType
+{
+    SCHEMA_NO_PATH, SCHEMA_RELATIVE_PATH, SCHEMA_RELATIVE_TO_BASE_PATH, SCHEMA_ABSOLUTE_PATH
+};
+
+struct SchemaNode
+{
+    SchemaNodeKind kind;
+    const char *value;
+    int blank;            // index of blank node in the class
+};
+
+struct SchemaTriple
+{
+    SchemaNode subject;
+    SchemaNode predicate;
+    SchemaNode object;
+};
+
+// Triples of one annotated member, or of the class when name is null.
+// Reader triples are in the order in which the reader looks them up.
+struct SchemaMember
+{
+    const char *name;
+    SchemaPathType pathType;
+    const char *path;     // path annotation, null when there is none
+    const SchemaTriple *triples;
+    size_t tripleCount;
+    bool reader;
+    bool writer;
+    MemberMask readMask;  // members requiring this one, 0 when always read
+    MemberMask writeMask; // member selecting this one, 0 when always written
+};
+
+struct SchemaClass
+{
+    const char *name;
+    SchemaPathType pathType;
+    const char *path;
+    const SchemaMember *members;
+    size_t memberCount;
+    size_t blankCount;
+};
+
+template <class T>
+struct Schema;
+
+// Constant triples which every object of a class writes regardless of its
+// member values (no $that), e.g. rdf:type statements and the wiring of blank
+// nodes. Generated for the classes with at least two such triples.
+struct SchemaSkeleton
+{
+    const char *name;     // class name, key of resolved nodes in caches
+    const SchemaTriple *triples;
+    size_t tripleCount;
+};
+
+template <class T>
+struct Skeleton;
+
+// Generated accessors, indexed like the members of the schema. An
+// accessor is null when the member has no $that node.
+
+template <class Context, class Node>
+using SchemaWriter = bool (*)(const Context &ctx, const void *object, Node &that);
+
+template <class Context, class Node>
+using SchemaReader = bool (*)(const Context &ctx, Node &that, void *object);
+
+template <class T>
+struct SchemaWriters;
+
+template <class T>
+struct SchemaReaders;
+
+// Engine
+//
+// The traits headers provide the backend operations, found by argument
+// dependent lookup on their Context:
+//
+//   Node schemaConstantNode(const Context &ctx, const SchemaNode &node)
+//   Node schemaBlankNode(const Context &ctx)
+//   void schemaAddStatement(const Context &ctx, const Node &s, const Node &p, const Node &o)
+//   Triple schemaFindTriple(const Context &ctx, const Node &s, const Node &p, const Node &o)
+
+template <class Context, class Node>
+Node schemaWriterNode(const Context &ctx, const SchemaNode &node, Node &_this, Node &that, std::vector<Node> &blanks)
+{
+    switch (node.kind)
+    {
+        case SCHEMA_THIS:
+            return _this;
+        case SCHEMA_THAT:
+            return that;
+        case SCHEMA_BLANK:
+            return blanks[node.blank];
+        default:
+            return schemaConstantNode(ctx, node);
+    }
+}
+
+// Writes the statements of the writer members in mask, members whose value
+// is not valid (empty pointers) are skipped
+template <class Context, class Node>
+Node & toRDFSchema(const Context &ctx, Node &_this, const void *object, const SchemaClass &schema,
+                   const SchemaWriter<Context, Node> *writers, MemberMask mask = ~MemberMask(0))
+{
+    std::vector<Node> blanks;
+    blanks.reserve(schema.blankCount);
+    for (size_t i = 0; i < schema.blankCount; ++i)
+        blanks.push_back(schemaBlankNode(ctx));
+
+    for (size_t m = 0; m < schema.memberCount; ++m)
+    {
+        const SchemaMember &member = schema.members[m];
+        if (!member.writer || (member.writeMask && !(member.writeMask & mask)))
+            continue;
+        Node that;
+        if (writers[m] && !writers[m](ctx, object, that))
+            continue;
+        for (size_t t = 0; t < member.tripleCount; ++t)
+        {
+            const SchemaTriple &triple = member.triples[t];
+            schemaAddStatement(ctx,
+                schemaWriterNode(ctx, triple.subject, _this, that, blanks),
+                schemaWriterNode(ctx, triple.predicate, _this, that, blanks),
+                schemaWriterNode(ctx, triple.object, _this, that, blanks));
+        }
+    }
+    return _this;
+}
+
+// $that is unknown while reading and matches any node
+template <class Context, class Node>
+Node schemaReaderNode(const Context &ctx, const SchemaNode &node, Node &_this, std::vector<Node> &blanks)
+{
+    switch (node.kind)
+    {
+        case SCHEMA_THIS:
+            return _this;
+        case SCHEMA_THAT:
+            return Node();
+        case SCHEMA_BLANK:
+            return blanks[node.blank];
+        default:
+            return schemaConstantNode(ctx, node);
+    }
+}
+
+// Binds the node found at a position of a triple
+template <class Context, class Node>
+bool schemaBindNode(const Context &ctx, const SchemaNode &node, Node &found, Node &_this, std::vector<Node> &blanks,
+                    SchemaReader<Context, Node> reader, void *object)
+{
+    switch (node.kind)
+    {
+        case SCHEMA_THIS:
+            _this = found;
+            return true;
+        case SCHEMA_THAT:
+            return reader ? reader(ctx, found, object) : true;
+        case SCHEMA_BLANK:
+            blanks[node.blank] = found;
+            return true;
+        default:
+            return true;
+    }
+}
+
+// Node of a skeleton triple, constant is the resolved node of constant kinds
+template <class Node>
+const Node & schemaSkeletonNode(const SchemaNode &node, const Node &constant, const Node &_this, Node *const *blanks)
+{
+    switch (node.kind)
+    {
+        case SCHEMA_THIS:
+            return _this;
+        case SCHEMA_BLANK:
+            return *blanks[node.blank];
+        default:
+            return constant;
+    }
+}
+
+// Reads the reader members in mask, fails on the first triple which is not
+// found or whose value cannot be read
+template <class Context, class Node>
+bool fromRDFSchema(const Context &ctx, Node &_this, void *object, const SchemaClass &schema,
+                   const SchemaReader<Context, Node> *readers, MemberMask mask = ~MemberMask(0))
+{
+    std::vector<Node> blanks(schema.blankCount);
+
+    for (size_t m = 0; m < schema.memberCount; ++m)
+    {
+        const SchemaMember &member = schema.members[m];
+        if (!member.reader || (member.readMask && !(member.readMask & mask)))
+            continue;
+        for (size_t t = 0; t < member.tripleCount; ++t)
+        {
+            const SchemaTriple &triple = member.triples[t];
+            auto found = schemaFindTriple(ctx,
+                schemaReaderNode(ctx, triple.subject, _this, blanks),
+                schemaReaderNode(ctx, triple.predicate, _this, blanks),
+                schemaReaderNode(ctx, triple.object, _this, blanks));
+            if (!found.is_valid())
+                return false;
+            if (!schemaBindNode(ctx, triple.subject, found.subject, _this, blanks, readers[m], object) ||
+                !schemaBindNode(ctx, triple.object, found.object, _this, blanks, readers[m], object))
+                return false;
+        }
+    }
+    return true;
+}
+
+} // namespace RDF
+} // namespace Arvida
+
+#endif
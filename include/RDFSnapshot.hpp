@@ -0,0 +1,178 @@
+/*  ARVIDAPP - ARVIDA C++ Preprocessor
+ *
+ *  Copyright (C) 2015-2019 German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef RDF_SNAPSHOT_HPP_INCLUDED
+#define RDF_SNAPSHOT_HPP_INCLUDED
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace Arvida
+{
+namespace RDF
+{
+
+// RCU style holder of immutable snapshots (e.g. models)
+//
+// Writers build a new value off to the side and publish it, readers
+// acquire a reference counted snapshot of the current value without
+// locking. A retired value is destroyed when the last snapshot referring
+// to it is released.
+
+template <class T>
+class SnapshotHolder
+{
+    struct Entry
+    {
+        std::unique_ptr<T> value;
+        std::atomic<long> refs;
+
+        explicit Entry(std::unique_ptr<T> value) : value(std::move(value)), refs(1) { }
+    };
+
+    static void unref(Entry *entry)
+    {
+        if (entry && entry->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            delete entry;
+    }
+
+public:
+
+    class Snapshot
+    {
+    public:
+        Snapshot() : entry_(0) { }
+
+        Snapshot(const Snapshot &other) : entry_(other.entry_)
+        {
+            if (entry_)
+                entry_->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        Snapshot(Snapshot &&other) : entry_(other.entry_)
+        {
+            other.entry_ = 0;
+        }
+
+        Snapshot & operator=(Snapshot other)
+        {
+            std::swap(entry_, other.entry_);
+            return *this;
+        }
+
+        ~Snapshot()
+        {
+            unref(entry_);
+        }
+
+        T * get() const { return entry_ ? entry_->value.get() : 0; }
+
+        T & operator*() const { return *entry_->value; }
+
+        T * operator->() const { return entry_->value.get(); }
+
+        explicit operator bool() const { return entry_ != 0; }
+
+        void reset()
+        {
+            unref(entry_);
+            entry_ = 0;
+        }
+
+    private:
+        friend class SnapshotHolder;
+
+        explicit Snapshot(Entry *entry) : entry_(entry) { }
+
+        Entry *entry_;
+    };
+
+    SnapshotHolder() : current_(0), epoch_(0)
+    {
+        readers_[0].store(0);
+        readers_[1].store(0);
+    }
+
+    explicit SnapshotHolder(std::unique_ptr<T> value) : SnapshotHolder()
+    {
+        publish(std::move(value));
+    }
+
+    SnapshotHolder(const SnapshotHolder &) = delete;
+    SnapshotHolder & operator=(const SnapshotHolder &) = delete;
+
+    ~SnapshotHolder()
+    {
+        unref(current_.load());
+    }
+
+    // Returns snapshot of the current value, never blocks
+    Snapshot acquire() const
+    {
+        const unsigned epoch = epoch_.load() & 1;
+        readers_[epoch].fetch_add(1);
+        Entry *entry = current_.load();
+        if (entry)
+            entry->refs.fetch_add(1, std::memory_order_relaxed);
+        readers_[epoch].fetch_sub(1);
+        return Snapshot(entry);
+    }
+
+    // Replaces the current value. Blocks only until readers which are in
+    // the middle of acquire() have taken their reference.
+    void publish(std::unique_ptr<T> value)
+    {
+        Entry *entry = value ? new Entry(std::move(value)) : 0;
+
+        std::lock_guard<std::mutex> lock(writerMutex_);
+        Entry *old = current_.exchange(entry);
+        // Wait for both reader groups (as in userspace RCU), new readers
+        // always register in the group which is not waited for.
+        for (int i = 0; i < 2; ++i)
+        {
+            const unsigned oldEpoch = epoch_.fetch_add(1) & 1;
+            while (readers_[oldEpoch].load() != 0)
+                std::this_thread::yield();
+        }
+        unref(old);
+    }
+
+    template <class... Args>
+    void emplace(Args&&... args)
+    {
+        publish(std::unique_ptr<T>(new T(std::forward<Args>(args)...)));
+    }
+
+    void clear()
+    {
+        publish(std::unique_ptr<T>());
+    }
+
+private:
+    std::atomic<Entry *> current_;
+    std::atomic<unsigned> epoch_;
+    mutable std::atomic<long> readers_[2];
+    std::mutex writerMutex_;
+};
+
+} // namespace RDF
+} // namespace Arvida
+
+#endif
@@ -0,0 +1,97 @@
+/*  ARVIDAPP - ARVIDA C++ Preprocessor
+ *
+ *  Copyright (C) 2015-2019 German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef RDF_STRING_REF_HPP_INCLUDED
+#define RDF_STRING_REF_HPP_INCLUDED
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#include <string_view>
+#define ARVIDA_RDF_HAS_STRING_VIEW 1
+#endif
+
+namespace Arvida
+{
+namespace RDF
+{
+
+// Non-owning string read from a model
+//
+// fromRDF of the traits headers reads a literal into a StringRef (or a
+// std::string_view with C++17) without copying, it references the bytes of
+// the node held by the model. A setter taking a StringRef or string_view
+// receives them directly, they are valid as long as the statement is in the
+// model (for the flat store: until new terms are added, for the N-Triples
+// reader: as long as the graph and the vocabulary live). Setters taking a
+// std::string receive an owned copy, use str() to keep a StringRef beyond
+// the lifetime of the model.
+
+class StringRef
+{
+public:
+    StringRef() : data_(""), size_(0) { }
+
+    StringRef(const char *data, size_t size) : data_(data), size_(size) { }
+
+    StringRef(const char *str) : data_(str), size_(std::strlen(str)) { }
+
+    StringRef(const std::string &str) : data_(str.data()), size_(str.size()) { }
+
+#ifdef ARVIDA_RDF_HAS_STRING_VIEW
+    StringRef(std::string_view str) : data_(str.data()), size_(str.size()) { }
+
+    operator std::string_view() const { return std::string_view(data_, size_); }
+#endif
+
+    const char * data() const { return data_; }
+
+    size_t size() const { return size_; }
+
+    bool empty() const { return size_ == 0; }
+
+    const char * begin() const { return data_; }
+
+    const char * end() const { return data_ + size_; }
+
+    char operator[](size_t i) const { return data_[i]; }
+
+    std::string str() const { return std::string(data_, size_); }
+
+    explicit operator std::string() const { return str(); }
+
+    bool operator==(const StringRef &other) const
+    {
+        return size_ == other.size_ && (size_ == 0 || std::memcmp(data_, other.data_, size_) == 0);
+    }
+
+    bool operator!=(const StringRef &other) const
+    {
+        return !(*this == other);
+    }
+
+private:
+    const char *data_;
+    size_t size_;
+};
+
+} // namespace RDF
+} // namespace Arvida
+
+#endif
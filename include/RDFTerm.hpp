@@ -0,0 +1,205 @@
+/*  ARVIDAPP - ARVIDA C++ Preprocessor
+ *
+ *  Copyright (C) 2015-2019 German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef RDF_TERM_HPP_INCLUDED
+#define RDF_TERM_HPP_INCLUDED
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstring>
+
+namespace Arvida
+{
+namespace RDF
+{
+
+// Library independent representation of RDF terms, used by tools that
+// operate on whole models (diff, binary encoding, snapshots).
+
+struct Term
+{
+    enum Type
+    {
+        NONE, URI, BLANK, LITERAL
+    };
+
+    Type type;
+    std::string value;
+    std::string datatype;
+    std::string language;
+
+    Term() : type(NONE) { }
+
+    Term(Type type, const std::string &value)
+        : type(type), value(value)
+    { }
+
+    Term(Type type, const std::string &value, const std::string &datatype, const std::string &language = std::string())
+        : type(type), value(value), datatype(datatype), language(language)
+    { }
+
+    static Term uri(const std::string &value) { return Term(URI, value); }
+
+    static Term blank(const std::string &value) { return Term(BLANK, value); }
+
+    static Term literal(const std::string &value, const std::string &datatype = std::string(), const std::string &language = std::string())
+    {
+        return Term(LITERAL, value, datatype, language);
+    }
+
+    bool is_valid() const { return type != NONE; }
+
+    bool is_uri() const { return type == URI; }
+
+    bool is_blank() const { return type == BLANK; }
+
+    bool is_literal() const { return type == LITERAL; }
+
+    bool operator==(const Term &other) const
+    {
+        return type == other.type && value == other.value &&
+            datatype == other.datatype && language == other.language;
+    }
+
+    bool operator!=(const Term &other) const
+    {
+        return !(*this == other);
+    }
+};
+
+struct TermTriple
+{
+    Term subject;
+    Term predicate;
+    Term object;
+
+    TermTriple() { }
+
+    TermTriple(const Term &subject, const Term &predicate, const Term &object)
+        : subject(subject), predicate(predicate), object(object)
+    { }
+};
+
+typedef std::vector<TermTriple> TermTriples;
+
+// N-Triples formatting
+
+inline void appendNTriplesUChar(std::string &out, unsigned char c)
+{
+    char buf[8];
+    std::snprintf(buf, sizeof(buf), "\\u%04X", (unsigned)c);
+    out += buf;
+}
+
+inline void appendNTriplesIRI(std::string &out, const char *iri, size_t length)
+{
+    out += '<';
+    for (size_t i = 0; i < length; ++i)
+    {
+        const unsigned char c = static_cast<unsigned char>(iri[i]);
+        switch (c)
+        {
+            case '<': case '>': case '"': case '{': case '}':
+            case '|': case '^': case '`': case '\\':
+                appendNTriplesUChar(out, c);
+                break;
+            default:
+                if (c <= 0x20)
+                    appendNTriplesUChar(out, c);
+                else
+                    out += static_cast<char>(c);
+        }
+    }
+    out += '>';
+}
+
+inline void appendNTriplesString(std::string &out, const char *str, size_t length)
+{
+    out += '"';
+    // Characters which do not need escaping are appended in runs
+    size_t start = 0;
+    for (size_t i = 0; i < length; ++i)
+    {
+        const char *escaped;
+        switch (str[i])
+        {
+            case '"': escaped = "\\\""; break;
+            case '\\': escaped = "\\\\"; break;
+            case '\n': escaped = "\\n"; break;
+            case '\r': escaped = "\\r"; break;
+            case '\t': escaped = "\\t"; break;
+            default: continue;
+        }
+        out.append(str + start, i - start);
+        out.append(escaped, 2);
+        start = i + 1;
+    }
+    out.append(str + start, length - start);
+    out += '"';
+}
+
+inline void appendNTriplesTerm(std::string &out, const Term &term)
+{
+    switch (term.type)
+    {
+        case Term::URI:
+            appendNTriplesIRI(out, term.value.data(), term.value.size());
+            break;
+        case Term::BLANK:
+            out += "_:";
+            out += term.value;
+            break;
+        case Term::LITERAL:
+            appendNTriplesString(out, term.value.data(), term.value.size());
+            if (!term.language.empty())
+            {
+                out += '@';
+                out += term.language;
+            }
+            else if (!term.datatype.empty())
+            {
+                out += "^^";
+                appendNTriplesIRI(out, term.datatype.data(), term.datatype.size());
+            }
+            break;
+        case Term::NONE:
+            break;
+    }
+}
+
+inline std::string toNTriples(const Term &term)
+{
+    std::string result;
+    appendNTriplesTerm(result, term);
+    return result;
+}
+
+inline void appendNTriplesTriple(std::string &out, const TermTriple &triple)
+{
+    appendNTriplesTerm(out, triple.subject);
+    out += ' ';
+    appendNTriplesTerm(out, triple.predicate);
+    out += ' ';
+    appendNTriplesTerm(out, triple.object);
+    out += " .\n";
+}
+
+} // namespace RDF
+} // namespace Arvida
+
+#endif
@@ -19,10 +19,17 @@
 #define REDLAND_RDF_TRAITS_HPP_INCLUDED
 
 #include "redland.hpp"
+#include "RDFSchema.hpp"
+#include "RDFProjection.hpp"
+#include "RDFPath.hpp"
+#include "RDFStringRef.hpp"
 #include <memory>
 #include <vector>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <cstdlib>
+#include <exception>
 #include <boost/any.hpp>
 
 namespace Arvida
@@ -35,6 +42,9 @@ typedef Redland::Node * NodePtr;
 typedef Redland::Node & NodeRef;
 typedef std::unordered_map<std::string, boost::any> Cache;
 
+class Batch;
+class Sink;
+
 struct Context
 {
     Redland::World &world;
@@ -44,31 +54,199 @@ struct Context
     const std::string &path;
     Cache *cache;
     const void *user_data;
-
+    // Projection of toRDF (see RDFProjection.hpp) and depth of the object
+    // serialized with this context
+    const Projection *projection;
+    unsigned depth;
+    // Batch the statements of toRDF are added to (see Batch), 0 adds them to
+    // model directly
+    Batch *batch;
+    // Serializer sink the statements of toRDF are written to instead of
+    // model (see Sink)
+    Sink *sink;
 
     Context(Redland::World &world, Redland::Namespaces &namespaces, Redland::Model &model, const std::string &base_path,
             const std::string &path, Cache *cache = 0, const void *user_data = 0)
-        : world(world), namespaces(namespaces), model(model), base_path(base_path), path(path), cache(cache), user_data(user_data)
+        : world(world), namespaces(namespaces), model(model), base_path(base_path), path(path), cache(cache), user_data(user_data),
+          projection(0), depth(0), batch(0), sink(0)
     {
     }
 
     Context(Redland::World &world, Redland::Namespaces &namespaces, Redland::Model &model, const std::string &path,
             Cache *cache = 0, const void *user_data = 0)
-        : world(world), namespaces(namespaces), model(model), base_path(path), path(path), cache(cache), user_data(user_data)
+        : world(world), namespaces(namespaces), model(model), base_path(path), path(path), cache(cache), user_data(user_data),
+          projection(0), depth(0), batch(0), sink(0)
     {
     }
 
     Context(const Context &ctx)
-        : world(ctx.world), namespaces(ctx.namespaces), model(ctx.model), base_path(ctx.base_path), path(ctx.path), cache(ctx.cache), user_data(ctx.user_data)
+        : world(ctx.world), namespaces(ctx.namespaces), model(ctx.model), base_path(ctx.base_path), path(ctx.path), cache(ctx.cache), user_data(ctx.user_data),
+          projection(ctx.projection), depth(ctx.depth), batch(ctx.batch), sink(ctx.sink)
     {
     }
 
     Context(const Context &ctx, const std::string &path)
-        : world(ctx.world), namespaces(ctx.namespaces), model(ctx.model), base_path(ctx.base_path), path(path), cache(ctx.cache), user_data(ctx.user_data)
+        : world(ctx.world), namespaces(ctx.namespaces), model(ctx.model), base_path(ctx.base_path), path(path), cache(ctx.cache), user_data(ctx.user_data),
+          projection(ctx.projection), depth(ctx.depth), batch(ctx.batch), sink(ctx.sink)
+    {
+    }
+};
+
+// World, namespaces, in-memory storage and model bundled together
+
+struct WorldModel
+{
+    Redland::World world;
+    Redland::Namespaces namespaces;
+    Redland::Storage storage;
+    Redland::Model model;
+    Cache cache;
+
+    WorldModel()
+        : world()
+        , namespaces()
+        , storage(Redland::Storage::make_memory_hashes(world, "arvida"))
+        , model(world, storage, "")
+    { }
+
+    void clear()
+    {
+        model.clear();
+    }
+};
+
+// Bulk loading
+//
+// Set as Context::batch, the generated toRDF adds its statements with one
+// reused statement, and within one model transaction when the storage
+// supports transactions (e.g. "sqlite", "postgresql", "mysql"; the
+// "hashes" storage of WorldModel has none, in_transaction() is false). The
+// transaction is committed by commit() or the destructor, rollback()
+// discards the statements added since the batch was created. When the
+// destructor runs because of an exception (e.g. thrown by toRDF), the
+// transaction is rolled back, so no partial graph is committed. Without a
+// transaction the statements added so far stay in the model.
+
+class Batch
+{
+public:
+    Batch(Redland::World &world, Redland::Model &model)
+        : model_(model)
+        , statement_(world)
+        , transaction_(model.transaction_start())
+#if __cplusplus >= 201703L
+        , exceptions_(std::uncaught_exceptions())
+#endif
+    { }
+
+    Batch(const Batch &) = delete;
+
+    Batch & operator=(const Batch &) = delete;
+
+    ~Batch()
+    {
+        if (unwinding())
+            rollback();
+        else
+            commit();
+    }
+
+    bool add(const Redland::Node &subject, const Redland::Node &predicate, const Redland::Node &object)
+    {
+        statement_.set(subject, predicate, object);
+        const bool added = model_.add_statement(statement_);
+        statement_.set(NULL, NULL, NULL);
+        return added;
+    }
+
+    // False after commit() or rollback()
+    bool in_transaction() const { return transaction_; }
+
+    bool commit()
+    {
+        if (!transaction_)
+            return false;
+        transaction_ = false;
+        return model_.transaction_commit();
+    }
+
+    bool rollback()
+    {
+        if (!transaction_)
+            return false;
+        transaction_ = false;
+        return model_.transaction_rollback();
+    }
+
+private:
+    bool unwinding() const
     {
+#if __cplusplus >= 201703L
+        return std::uncaught_exceptions() > exceptions_;
+#else
+        return std::uncaught_exception();
+#endif
     }
+
+    Redland::Model &model_;
+    Redland::StatementRef statement_;
+    bool transaction_;
+#if __cplusplus >= 201703L
+    int exceptions_;
+#endif
 };
 
+// Streaming serialization
+//
+// Set as Context::sink, the generated toRDF writes its statements to a
+// Raptor serializer, the model is not used. Objects referenced by URI are
+// serialized once, the sink remembers their URIs instead of looking them up
+// in the model.
+
+class Sink
+{
+public:
+    Sink(Redland::World &world, Raptor::Serializer &serializer)
+        : serializer_(serializer)
+        , statement_(world)
+    { }
+
+    Sink(const Sink &) = delete;
+
+    Sink & operator=(const Sink &) = delete;
+
+    bool add(const Redland::Node &subject, const Redland::Node &predicate, const Redland::Node &object)
+    {
+        statement_.set(subject, predicate, object);
+        const bool written = serializer_.serialize_statement(statement_);
+        statement_.set(NULL, NULL, NULL);
+        return written;
+    }
+
+    // Marks the object of a URI node as serialized, returns false when it
+    // already was
+    bool mark(const Redland::Node &node)
+    {
+        size_t length = 0;
+        const unsigned char *uri = librdf_uri_as_counted_string(librdf_node_get_uri(node.c_obj()), &length);
+        return written_.insert(std::string(reinterpret_cast<const char *>(uri), length)).second;
+    }
+
+private:
+    Raptor::Serializer &serializer_;
+    Redland::StatementRef statement_;
+    std::unordered_set<std::string> written_;
+};
+
+inline bool addStatement(const Context &ctx, const Redland::Node &subject, const Redland::Node &predicate, const Redland::Node &object)
+{
+    if (ctx.sink)
+        return ctx.sink->add(subject, predicate, object);
+    if (ctx.batch)
+        return ctx.batch->add(subject, predicate, object);
+    return ctx.model.add_statement(ctx.world, subject, predicate, object);
+}
+
 struct Triple
 {
     Redland::Node subject;
@@ -83,6 +261,10 @@ struct Triple
         , object(object)
     { }
 
+    Triple(const Triple &triple) = default;
+
+    Triple(Triple &&triple) = default;
+
     Triple(const Redland::Statement &stmt)
         : subject(stmt.get_subject())
         , predicate(stmt.get_predicate())
@@ -90,6 +272,14 @@ struct Triple
     {
     }
 
+    // Takes a reference to the nodes of stmt
+    explicit Triple(librdf_statement *stmt)
+        : subject(librdf_new_node_from_node(librdf_statement_get_subject(stmt)))
+        , predicate(librdf_new_node_from_node(librdf_statement_get_predicate(stmt)))
+        , object(librdf_new_node_from_node(librdf_statement_get_object(stmt)))
+    {
+    }
+
     Triple & operator=(const Redland::Statement &stmt)
     {
         subject = stmt.get_subject();
@@ -106,12 +296,108 @@ struct Triple
         return *this;
     }
 
+    Triple & operator=(Triple &&triple) = default;
+
     bool is_valid() const
     {
         return subject.is_valid() && predicate.is_valid() && object.is_valid();
     }
 };
 
+// Non-owning nodes
+//
+// A NodeView references a node without copying it, it is valid as long as
+// its owner lives, e.g. the statement of a TripleView or a Node. Literals
+// are read from a view without copying the node, converting a view to a
+// Node copies it.
+
+class NodeView
+{
+public:
+    NodeView() : node_(0) { }
+
+    explicit NodeView(librdf_node *node) : node_(node) { }
+
+    explicit NodeView(const Redland::Node &node) : node_(node.c_obj()) { }
+
+    bool is_valid() const { return node_ != 0; }
+
+    bool is_blank() const { return node_ && librdf_node_is_blank(node_); }
+
+    bool is_literal() const { return node_ && librdf_node_is_literal(node_); }
+
+    bool is_resource() const { return node_ && librdf_node_is_resource(node_); }
+
+    librdf_node * c_obj() const { return node_; }
+
+    operator Redland::Node() const
+    {
+        return Redland::Node(node_ ? librdf_new_node_from_node(node_) : 0);
+    }
+
+    bool operator==(const NodeView &other) const
+    {
+        return node_ == other.node_ || (node_ && other.node_ && librdf_node_equals(node_, other.node_));
+    }
+
+    bool operator!=(const NodeView &other) const { return !(*this == other); }
+
+private:
+    librdf_node *node_;
+};
+
+// Nodes of a statement, valid as long as the statement lives
+struct TripleView
+{
+    NodeView subject;
+    NodeView predicate;
+    NodeView object;
+
+    TripleView() { }
+
+    explicit TripleView(librdf_statement *stmt)
+        : subject(librdf_statement_get_subject(stmt))
+        , predicate(librdf_statement_get_predicate(stmt))
+        , object(librdf_statement_get_object(stmt))
+    { }
+
+    explicit TripleView(const Redland::Statement &stmt)
+        : TripleView(stmt.c_obj())
+    { }
+
+    bool is_valid() const
+    {
+        return subject.is_valid() && predicate.is_valid() && object.is_valid();
+    }
+};
+
+// Queries
+//
+// The pattern of a query references the given nodes (see
+// Redland::StatementRef), so no statement is allocated for it. The
+// generated readers look up member triples with find_triple_view, the
+// returned view is valid until stream is reused or freed.
+
+inline Triple find_triple(const Context &ctx, const Redland::Node &subject, const Redland::Node &predicate, const Redland::Node &object)
+{
+    Redland::Stream stream = ctx.model.find_statements(ctx.world, subject, predicate, object);
+    return stream.end() ? Triple() : Triple(stream.current());
+}
+
+inline std::vector<Triple> find_triples(const Context &ctx, const Redland::Node &subject, const Redland::Node &predicate, const Redland::Node &object)
+{
+    std::vector<Triple> result;
+    for (Redland::Stream stream = ctx.model.find_statements(ctx.world, subject, predicate, object); !stream.end(); stream.next())
+        result.emplace_back(stream.current());
+    return result;
+}
+
+inline TripleView find_triple_view(const Context &ctx, Redland::Stream &stream, const Redland::Node &subject, const Redland::Node &predicate, const Redland::Node &object)
+{
+    stream = ctx.model.find_statements(ctx.world, subject, predicate, object);
+    return stream.end() ? TripleView() : TripleView(stream.current());
+}
+
 inline bool isNodeExists(Redland::Model &model, const Redland::Node &node)
 {
     librdf_iterator *it = librdf_model_get_arcs_in(model.c_obj(), node.c_obj());
@@ -135,6 +421,14 @@ inline bool isNodeExists(Redland::Model &model, const Redland::Node &node)
     return false;
 }
 
+// Whether the object of node was already serialized
+inline bool isNodeSerialized(const Context &ctx, const Redland::Node &node)
+{
+    if (ctx.sink)
+        return node.is_resource() && !ctx.sink->mark(node);
+    return isNodeExists(ctx.model, node);
+}
+
 template<class T>
 inline bool isValidValue(const T &value)
 {
@@ -292,7 +586,7 @@ Node createRDFNode(const Context &ctx, const T &value, PathType memberPathType,
         if (thatPathType == ABSOLUTE_PATH)
             thatPath = pathOf(ctx, value);
         else if (thatPathType == RELATIVE_TO_BASE_PATH)
-            thatPath = joinPath(ctx.base_path, pathOf(ctx, value));
+            joinPathInto(thatPath, ctx.base_path, pathOf(ctx, value));
         else {
             switch (memberPathType)
             {
@@ -300,17 +594,17 @@ Node createRDFNode(const Context &ctx, const T &value, PathType memberPathType,
                     thatPath = ctx.path;
                     break;
                 case RELATIVE_PATH:
-                    thatPath = joinPath(ctx.path, memberPath);
+                    joinPathInto(thatPath, ctx.path, memberPath);
                     break;
                 case RELATIVE_TO_BASE_PATH:
-                    thatPath = joinPath(ctx.base_path, memberPath);
+                    joinPathInto(thatPath, ctx.base_path, memberPath);
                     break;
                 case ABSOLUTE_PATH:
                     thatPath = memberPath;
                     break;
             }
             if (thatPathType == RELATIVE_PATH)
-                thatPath = joinPath(thatPath, pathOf(ctx, value));
+                appendPath(thatPath, pathOf(ctx, value));
         }
         Arvida::RDF::Context thatCtx(ctx, thatPath);
         Redland::Node thatNode(Redland::Node::make_uri_node(ctx.world, thatPath));
@@ -325,8 +619,18 @@ Node createRDFNodeAndSerialize(const Context &ctx, const T &value, PathType memb
     if (thatPathType == NO_PATH)
     {
         Redland::Node thatNode(Redland::Node::make_blank_node(ctx.world));
-        if (!isNodeExists(ctx.model, thatNode))
-            toRDF(ctx, thatNode, value);
+        if (!IsNestedObject<T>::value || !ctx.projection)
+        {
+            if (!isNodeSerialized(ctx, thatNode))
+                toRDF(ctx, thatNode, value);
+        }
+        else if (!projectionCut(ctx))
+        {
+            Arvida::RDF::Context thatCtx(ctx);
+            ++thatCtx.depth;
+            if (!isNodeSerialized(ctx, thatNode))
+                toRDF(thatCtx, thatNode, value);
+        }
         return thatNode;
     }
     else
@@ -335,7 +639,7 @@ Node createRDFNodeAndSerialize(const Context &ctx, const T &value, PathType memb
         if (thatPathType == ABSOLUTE_PATH)
             thatPath = pathOf(ctx, value);
         else if (thatPathType == RELATIVE_TO_BASE_PATH)
-            thatPath = joinPath(ctx.base_path, pathOf(ctx, value));
+            joinPathInto(thatPath, ctx.base_path, pathOf(ctx, value));
         else {
             switch (memberPathType)
             {
@@ -343,21 +647,22 @@ Node createRDFNodeAndSerialize(const Context &ctx, const T &value, PathType memb
                     thatPath = ctx.path;
                     break;
                 case RELATIVE_PATH:
-                    thatPath = joinPath(ctx.path, memberPath);
+                    joinPathInto(thatPath, ctx.path, memberPath);
                     break;
                 case RELATIVE_TO_BASE_PATH:
-                    thatPath = joinPath(ctx.base_path, memberPath);
+                    joinPathInto(thatPath, ctx.base_path, memberPath);
                     break;
                 case ABSOLUTE_PATH:
                     thatPath = memberPath;
                     break;
             }
             if (thatPathType == RELATIVE_PATH)
-                thatPath = joinPath(thatPath, pathOf(ctx, value));
+                appendPath(thatPath, pathOf(ctx, value));
         }
         Arvida::RDF::Context thatCtx(ctx, thatPath);
+        ++thatCtx.depth;
         Redland::Node thatNode(Redland::Node::make_uri_node(ctx.world, thatPath));
-        if (!isNodeExists(ctx.model, thatNode))
+        if (!projectionCut(ctx) && !isNodeSerialized(ctx, thatNode))
             toRDF(thatCtx, thatNode, value);
         return thatNode;
     }
@@ -424,53 +729,138 @@ bool fromRDF(const Context &ctx, const NodeRef thisNode, T &value)
     return value.fromRDF(ctx, thisNode);
 }
 
+// Reads the members in mask (see Members<T>), specialized for annotated
+// classes. Other types are read completely.
+template<class T>
+bool fromRDF(const Context &ctx, const NodeRef thisNode, T &value, MemberMask mask)
+{
+    return fromRDF(ctx, thisNode, value);
+}
+
 template < class T >
 bool fromRDF(const Context &ctx, const NodeRef thisNode, std::shared_ptr<T> &value)
 {
     return value ? fromRDF(ctx, thisNode, *value) : false;
 }
 
+// Reads from a node view, specialized for literals which are read without
+// copying the node
+template < class T >
+bool fromRDF(const Context &ctx, const NodeView &thisNode, T &value)
+{
+    Node node = thisNode;
+    return fromRDF(ctx, node, value);
+}
+
+// References the literal value of node, see RDFStringRef.hpp
+inline bool readLiteralRef(librdf_node *node, StringRef &value)
+{
+    if (!node || !librdf_node_is_literal(node))
+        return false;
+    size_t size = 0;
+    const unsigned char *data = librdf_node_get_literal_value_as_counted_string(node, &size);
+    if (!data)
+        return false;
+    value = StringRef(reinterpret_cast<const char *>(data), size);
+    return true;
+}
+
+template < class T >
+inline bool parseFloating(librdf_node *node, T &value)
+{
+    StringRef literal;
+    if (!readLiteralRef(node, literal))
+        return false;
+    // The literal value of librdf is NUL-terminated
+    char *endptr;
+    value = static_cast<T>(std::strtod(literal.data(), &endptr));
+    if (endptr == literal.data())
+        return false;
+    // Trailing whitespace is allowed (xsd whitespace collapse), other
+    // characters are not
+    while (*endptr == ' ' || *endptr == '\t' || *endptr == '\n' || *endptr == '\r')
+        ++endptr;
+    return *endptr == '\0';
+}
+
 template <>
 inline bool fromRDF(const Context &ctx, const NodeRef _this0, double &value)
 {
-    if (_this0.is_literal())
-    {
-        try {
-            value = std::stod(_this0.get_literal_value());
-        } catch (...)
-        {
-            return false;
-        }
-    }
-    return false;
+    return parseFloating(_this0.c_obj(), value);
+}
+
+template <>
+inline bool fromRDF(const Context &ctx, const NodeView &_this0, double &value)
+{
+    return parseFloating(_this0.c_obj(), value);
 }
 
 template <>
 inline bool fromRDF(const Context &ctx, const NodeRef _this0, float &value)
 {
-    if (_this0.is_literal())
-    {
-        try {
-            value = std::stof(_this0.get_literal_value());
-        } catch (...)
-        {
-            return false;
-        }
-    }
-    return false;
+    return parseFloating(_this0.c_obj(), value);
+}
+
+template <>
+inline bool fromRDF(const Context &ctx, const NodeView &_this0, float &value)
+{
+    return parseFloating(_this0.c_obj(), value);
 }
 
 template <>
 inline bool fromRDF(const Context &ctx, const NodeRef _this0, std::string &value)
 {
-    if (_this0.is_literal())
-    {
-        value = _this0.get_literal_value();
-        return true;
-    }
-    return false;
+    StringRef ref;
+    if (!readLiteralRef(_this0.c_obj(), ref))
+        return false;
+    value.assign(ref.data(), ref.size());
+    return true;
 }
 
+template <>
+inline bool fromRDF(const Context &ctx, const NodeView &_this0, std::string &value)
+{
+    StringRef ref;
+    if (!readLiteralRef(_this0.c_obj(), ref))
+        return false;
+    value.assign(ref.data(), ref.size());
+    return true;
+}
+
+template <>
+inline bool fromRDF(const Context &ctx, const NodeRef _this0, StringRef &value)
+{
+    return readLiteralRef(_this0.c_obj(), value);
+}
+
+template <>
+inline bool fromRDF(const Context &ctx, const NodeView &_this0, StringRef &value)
+{
+    return readLiteralRef(_this0.c_obj(), value);
+}
+
+#ifdef ARVIDA_RDF_HAS_STRING_VIEW
+template <>
+inline bool fromRDF(const Context &ctx, const NodeRef _this0, std::string_view &value)
+{
+    StringRef ref;
+    if (!readLiteralRef(_this0.c_obj(), ref))
+        return false;
+    value = ref;
+    return true;
+}
+
+template <>
+inline bool fromRDF(const Context &ctx, const NodeView &_this0, std::string_view &value)
+{
+    StringRef ref;
+    if (!readLiteralRef(_this0.c_obj(), ref))
+        return false;
+    value = ref;
+    return true;
+}
+#endif
+
 
 } // namespace Arvida
 } // namespace RDF
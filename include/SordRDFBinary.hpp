@@ -0,0 +1,118 @@
+/*  ARVIDAPP - ARVIDA C++ Preprocessor
+ *
+ *  Copyright (C) 2015-2019 German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef SORD_RDF_BINARY_HPP_INCLUDED
+#define SORD_RDF_BINARY_HPP_INCLUDED
+
+#include "SordRDFDiff.hpp"
+#include "RDFBinary.hpp"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Arvida {
+namespace RDF {
+
+// Writes all statements of the model, each node is converted once
+inline void writeBinaryRDF(BinaryRDFWriter &writer, Sord::Model &model)
+{
+    std::unordered_map<const SordNode *, Term> terms;
+    SordQuad quad;
+    SordIter *iter = sord_begin(model.c_obj());
+    for (; iter && !sord_iter_end(iter); sord_iter_next(iter))
+    {
+        sord_iter_get(iter, quad);
+        for (int i = SORD_SUBJECT; i <= SORD_OBJECT; ++i)
+        {
+            Term &term = terms[quad[i]];
+            if (!term.is_valid())
+                term = toTerm(quad[i]);
+            writer.writeTerm(term);
+        }
+    }
+    sord_iter_free(iter);
+}
+
+inline std::string toBinaryRDF(Sord::Model &model)
+{
+    std::string out;
+    BinaryRDFWriter writer(out);
+    writeBinaryRDF(writer, model);
+    writer.end();
+    return out;
+}
+
+// Adds the statements of the next document in the stream to the model.
+// Returns NEED_DATA when the reader needs more data to continue, the
+// statements read so far are already added.
+inline BinaryRDFReader::Status readBinaryRDF(BinaryRDFReader &reader, Sord::World &world, Sord::Model &model)
+{
+    SordWorld *sordWorld = world.c_obj();
+    std::vector<SordNode *> nodes;
+    BinaryTermRef triple[3];
+    BinaryRDFReader::Status status;
+    while ((status = reader.next(triple)) == BinaryRDFReader::TRIPLE)
+    {
+        SordQuad quad = { 0, 0, 0, 0 };
+        SordNode *literals[3] = { 0, 0, 0 };
+        for (int i = 0; i < 3; ++i)
+        {
+            if (triple[i].id == BinaryTermRef::NO_ID)
+            {
+                quad[i] = literals[i] = newSordNode(sordWorld, *triple[i].term);
+                continue;
+            }
+            if (triple[i].id >= nodes.size())
+                nodes.resize(triple[i].id + 1, 0);
+            if (!nodes[triple[i].id])
+                nodes[triple[i].id] = newSordNode(sordWorld, *triple[i].term);
+            quad[i] = nodes[triple[i].id];
+        }
+        sord_add(model.c_obj(), quad);
+        for (int i = 0; i < 3; ++i)
+        {
+            if (literals[i])
+                sord_node_free(sordWorld, literals[i]);
+        }
+    }
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+        if (nodes[i])
+            sord_node_free(sordWorld, nodes[i]);
+    }
+    return status;
+}
+
+// Adds the statements of a complete document to the model
+inline bool fromBinaryRDF(Sord::World &world, Sord::Model &model, const char *data, size_t size)
+{
+    BinaryRDFReader reader;
+    reader.feed(data, size);
+    const BinaryRDFReader::Status status = readBinaryRDF(reader, world, model);
+    return status == BinaryRDFReader::END_OF_DOCUMENT ||
+        (status == BinaryRDFReader::NEED_DATA && reader.empty());
+}
+
+inline bool fromBinaryRDF(Sord::World &world, Sord::Model &model, const std::string &data)
+{
+    return fromBinaryRDF(world, model, data.data(), data.size());
+}
+
+} // namespace RDF
+} // namespace Arvida
+
+#endif
@@ -0,0 +1,125 @@
+/*  ARVIDAPP - ARVIDA C++ Preprocessor
+ *
+ *  Copyright (C) 2015-2019 German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef SORD_RDF_DIFF_HPP_INCLUDED
+#define SORD_RDF_DIFF_HPP_INCLUDED
+
+#include "SordRDFTraits.hpp"
+#include "RDFDiff.hpp"
+
+namespace Arvida {
+namespace RDF {
+
+inline Term toTerm(const SordNode *node)
+{
+    if (!node)
+        return Term();
+
+    size_t length = 0;
+    const char *str = (const char *)sord_node_get_string_counted(node, &length);
+    switch (sord_node_get_type(node))
+    {
+        case SORD_URI:
+            return Term(Term::URI, std::string(str, length));
+        case SORD_BLANK:
+            return Term(Term::BLANK, std::string(str, length));
+        case SORD_LITERAL:
+        {
+            Term term(Term::LITERAL, std::string(str, length));
+            const SordNode *datatype = sord_node_get_datatype(node);
+            if (datatype)
+                term.datatype = (const char *)sord_node_get_string(datatype);
+            const char *language = sord_node_get_language(node);
+            if (language)
+                term.language = language;
+            return term;
+        }
+    }
+    return Term();
+}
+
+inline Term toTerm(const Sord::Node &node)
+{
+    return toTerm(node.c_obj());
+}
+
+inline TermTriples toTermTriples(Sord::Model &model)
+{
+    TermTriples result;
+    result.reserve(model.num_quads());
+    SordQuad quad;
+    SordIter *iter = sord_begin(model.c_obj());
+    for (; iter && !sord_iter_end(iter); sord_iter_next(iter))
+    {
+        sord_iter_get(iter, quad);
+        result.emplace_back(toTerm(quad[SORD_SUBJECT]), toTerm(quad[SORD_PREDICATE]), toTerm(quad[SORD_OBJECT]));
+    }
+    sord_iter_free(iter);
+    return result;
+}
+
+// Creates node owned by the caller
+inline SordNode * newSordNode(SordWorld *world, const Term &term)
+{
+    const uint8_t *str = (const uint8_t *)term.value.c_str();
+    switch (term.type)
+    {
+        case Term::URI:
+            return sord_new_uri(world, str);
+        case Term::BLANK:
+            return sord_new_blank(world, str);
+        case Term::LITERAL:
+        {
+            SordNode *datatype = term.datatype.empty() ? 0 : sord_new_uri(world, (const uint8_t *)term.datatype.c_str());
+            SordNode *node = sord_new_literal(world, datatype, str, term.language.empty() ? 0 : term.language.c_str());
+            if (datatype)
+                sord_node_free(world, datatype);
+            return node;
+        }
+        case Term::NONE:
+            break;
+    }
+    return 0;
+}
+
+// Computes patch which transforms model 'from' to model 'to'
+
+inline Patch diff(Sord::Model &from, Sord::Model &to)
+{
+    TermTriples fromTriples = toTermTriples(from);
+    TermTriples toTriples = toTermTriples(to);
+    return diff(fromTriples, toTriples);
+}
+
+// Computes patch which transforms model 'from' to the serialization of
+// value under the given path. Value is serialized into a temporary model
+// of the same world.
+
+template <class T>
+Patch diffObject(Sord::Model &from, const std::string &path, const T &value, Cache *cache = 0, const void *user_data = 0)
+{
+    Sord::Model to(from.world(), path);
+    Context ctx(to, path, cache, user_data);
+    Sord::Node thisNode = Sord::URI(from.world(), path);
+    toRDF(ctx, thisNode, value);
+    return diff(from, to);
+}
+
+} // namespace RDF
+} // namespace Arvida
+
+#endif
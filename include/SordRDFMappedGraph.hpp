@@ -0,0 +1,64 @@
+/*  ARVIDAPP - ARVIDA C++ Preprocessor
+ *
+ *  Copyright (C) 2015-2019 German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef SORD_RDF_MAPPED_GRAPH_HPP_INCLUDED
+#define SORD_RDF_MAPPED_GRAPH_HPP_INCLUDED
+
+#include "SordRDFDiff.hpp"
+#include "RDFMappedGraph.hpp"
+#include <string>
+#include <vector>
+
+namespace Arvida {
+namespace RDF {
+
+// Writes snapshot of all statements of the model
+inline bool writeMappedGraph(const std::string &fileName, Sord::Model &model)
+{
+    return writeMappedGraph(fileName, toTermTriples(model));
+}
+
+// Adds all statements of the snapshot to the model, each term is
+// converted once
+inline void loadMappedGraph(const MappedGraph &graph, Sord::World &world, Sord::Model &model)
+{
+    SordWorld *sordWorld = world.c_obj();
+    std::vector<SordNode *> nodes(graph.termCount(), 0);
+    graph.visit(TermView(), TermView(), TermView(), [&](const TripleView &triple) {
+        const TermView terms[3] = { triple.subject, triple.predicate, triple.object };
+        SordQuad quad = { 0, 0, 0, 0 };
+        for (int i = 0; i < 3; ++i)
+        {
+            SordNode *&node = nodes[graph.find_term(terms[i])];
+            if (!node)
+                node = newSordNode(sordWorld, toTerm(terms[i]));
+            quad[i] = node;
+        }
+        sord_add(model.c_obj(), quad);
+        return true;
+    });
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+        if (nodes[i])
+            sord_node_free(sordWorld, nodes[i]);
+    }
+}
+
+} // namespace RDF
+} // namespace Arvida
+
+#endif
@@ -0,0 +1,76 @@
+/*  ARVIDAPP - ARVIDA C++ Preprocessor
+ *
+ *  Copyright (C) 2015-2019 German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef SORD_RDF_PIPELINE_HPP_INCLUDED
+#define SORD_RDF_PIPELINE_HPP_INCLUDED
+
+#include "SordRDFTraits.hpp"
+#include "RDFPipeline.hpp"
+#include <string>
+
+namespace Arvida {
+namespace RDF {
+
+// Sink which serializes each snapshot with the generated toRDF code into a
+// fresh model and passes the written document to the output function.
+// Every sink owns its world, so one sink instance is used per worker.
+
+template <class T>
+class SordSerializationSink
+{
+public:
+    typedef std::function<void (const std::string &document)> Output;
+
+    SordSerializationSink(const std::string &path, const Prefixes &prefixes, const Output &output,
+                          SerdSyntax syntax = SERD_TURTLE)
+        : world_(std::make_shared<Sord::World>())
+        , path_(path)
+        , output_(output)
+        , syntax_(syntax)
+    {
+        for (Prefixes::const_iterator it = prefixes.begin(); it != prefixes.end(); ++it)
+            world_->add_prefix(it->first, it->second);
+    }
+
+    void operator()(const T &value)
+    {
+        Sord::Model model(*world_, path_);
+        Context ctx(model, path_);
+        Sord::Node thisNode = Sord::URI(*world_, path_);
+        toRDF(ctx, thisNode, value);
+        output_(model.write_to_string(path_, syntax_));
+    }
+
+private:
+    std::shared_ptr<Sord::World> world_;
+    std::string path_;
+    Output output_;
+    SerdSyntax syntax_;
+};
+
+template <class T>
+typename SerializationPipeline<T>::SinkFactory makeSordSinkFactory(const std::string &path, const Prefixes &prefixes,
+                                                                   const typename SordSerializationSink<T>::Output &output,
+                                                                   SerdSyntax syntax = SERD_TURTLE)
+{
+    return [=]() { return typename SerializationPipeline<T>::Sink(SordSerializationSink<T>(path, prefixes, output, syntax)); };
+}
+
+} // namespace RDF
+} // namespace Arvida
+
+#endif
@@ -0,0 +1,191 @@
+/*  ARVIDAPP - ARVIDA C++ Preprocessor
+ *
+ *  Copyright (C) 2015-2019 German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef SORD_RDF_SERIALIZER_HPP_INCLUDED
+#define SORD_RDF_SERIALIZER_HPP_INCLUDED
+
+#include "SordRDFTraits.hpp"
+#include <chrono>
+#include <string>
+
+namespace Arvida {
+namespace RDF {
+
+// Resumable serializer
+//
+// Serializes one object per work item, nested objects are queued instead of
+// serialized recursively, so the native stack depth does not grow with the
+// depth of the object graph and all triples of a subject are added together.
+// The caller steps the serializer with a budget of triples or time and
+// resumes it later, e.g. in the next frame. A single object is never split,
+// so a step can exceed its budget by the triples of one object. No locks are
+// taken, but the object graph must not change until the serializer is done.
+
+class Serializer
+{
+public:
+
+    Serializer(Sord::Model &model, const std::string &base_path, Cache *cache = 0, const void *user_data = 0,
+               TraversalOrder order = BREADTH_FIRST)
+        : model_(model)
+        , base_path_(base_path)
+        , cache_(cache)
+        , user_data_(user_data)
+        , order_(order)
+        , projection_(0)
+    { }
+
+    Serializer(const Serializer &) = delete;
+    Serializer & operator=(const Serializer &) = delete;
+
+    // Queues serialization of value under the base path. Value is referenced,
+    // it must stay alive until the serializer is done.
+    template <class T>
+    void start(const T &value)
+    {
+        start(base_path_, value);
+    }
+
+    template <class T>
+    void start(const std::string &path, const T &value)
+    {
+        Context ctx(model_, base_path_, path, cache_, user_data_, &work_);
+        ctx.projection = projection_;
+        Node node = Sord::URI(model_.world(), path);
+        serializeRDFNode<const T &>(ctx, node, value);
+    }
+
+    // Projection of the serialized objects (see RDFProjection.hpp), applies
+    // to values started afterwards. Projection is referenced.
+    void setProjection(const Projection *projection)
+    {
+        projection_ = projection;
+    }
+
+    bool done() const
+    {
+        return work_.empty();
+    }
+
+    // Number of queued objects
+    size_t pending() const
+    {
+        return work_.items.size();
+    }
+
+    // Runs queued work until at least maxTriples triples were added or the
+    // queue is empty. Returns true when done.
+    bool step(size_t maxTriples)
+    {
+        const size_t start = model_.num_quads();
+        while (!work_.empty() && model_.num_quads() - start < maxTriples)
+            runNext();
+        return finish();
+    }
+
+    // Runs queued work until budget is exhausted or the queue is empty.
+    // Returns true when done.
+    template <class Rep, class Period>
+    bool stepFor(const std::chrono::duration<Rep, Period> &budget)
+    {
+        const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + budget;
+        while (!work_.empty())
+        {
+            runNext();
+            if (std::chrono::steady_clock::now() >= deadline)
+                break;
+        }
+        return finish();
+    }
+
+    // Runs all queued work
+    void run()
+    {
+        while (!work_.empty())
+            runNext();
+        finish();
+    }
+
+    // Drops queued work
+    void reset()
+    {
+        work_.clear();
+    }
+
+private:
+
+    void runNext()
+    {
+        Context ctx(model_, base_path_, base_path_, cache_, user_data_, &work_);
+        ctx.projection = projection_;
+        runNextWorkItem(ctx, work_, order_);
+    }
+
+    bool finish()
+    {
+        if (!work_.empty())
+            return false;
+        work_.queued.clear();
+        return true;
+    }
+
+    Sord::Model &model_;
+    const std::string base_path_;
+    Cache *cache_;
+    const void *user_data_;
+    const TraversalOrder order_;
+    const Projection *projection_;
+    WorkQueue work_;
+};
+
+// Serializes value to thisNode without recursion into nested objects.
+// Within a context which already has a work queue the value is queued.
+
+template <class T>
+NodeRef toRDFIterative(const Context &ctx, NodeRef thisNode, const T &value, TraversalOrder order = BREADTH_FIRST)
+{
+    if (ctx.work)
+    {
+        serializeRDFNode<const T &>(ctx, thisNode, value);
+        return thisNode;
+    }
+    WorkQueue work;
+    Context workCtx(ctx.model, ctx.base_path, ctx.path, ctx.cache, ctx.user_data, &work);
+    workCtx.projection = ctx.projection;
+    workCtx.depth = ctx.depth;
+    serializeRDFNode<const T &>(workCtx, thisNode, value);
+    runWorkQueue(workCtx, work, order);
+    return thisNode;
+}
+
+// Deserializes value from thisNode without recursion into nested objects
+// held by std::shared_ptr, they are read from a queue after value. Setters
+// must keep the pointer, the object is filled after the setter was called.
+// Within a context which already has a read queue nested objects are queued.
+
+template <class T>
+bool fromRDFIterative(const Context &ctx, NodeRef thisNode, T &value)
+{
+    if (ctx.reads)
+        return fromRDF(ctx, thisNode, value);
+    return fromRDFNodeIteratively(ctx, thisNode, value);
+}
+
+} // namespace RDF
+} // namespace Arvida
+
+#endif
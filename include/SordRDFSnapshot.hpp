@@ -0,0 +1,129 @@
+/*  ARVIDAPP - ARVIDA C++ Preprocessor
+ *
+ *  Copyright (C) 2015-2019 German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef SORD_RDF_SNAPSHOT_HPP_INCLUDED
+#define SORD_RDF_SNAPSHOT_HPP_INCLUDED
+
+#include "SordRDFTraits.hpp"
+#include "SordRDFBinary.hpp"
+#include "RDFSnapshot.hpp"
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace Arvida {
+namespace RDF {
+
+// Published snapshot of a model
+//
+// Sord is not thread-safe even when a model is only read: looking up a node
+// (e.g. Curie) interns it into the world, and copies of nodes and iterators
+// change reference counts. So a snapshot does not share a model, it stores
+// the statements in the compact binary format, and each reader thread reads
+// them into a model with its own world (see SnapshotReader).
+//
+// This is not free: every reader decodes the whole snapshot and inserts
+// all statements into its model, once per published snapshot, so the cost
+// of a publish grows with model size times number of reader threads.
+// Publish less often or use fewer reader threads when the models are large.
+
+class ModelSnapshot
+{
+public:
+    explicit ModelSnapshot(Sord::Model &model) : data_(toBinaryRDF(model)) { }
+
+    explicit ModelSnapshot(std::string data) : data_(std::move(data)) { }
+
+    const std::string & data() const { return data_; }
+
+    // Adds the statements of the snapshot to the model
+    bool read(WorldModel &target) const
+    {
+        return fromBinaryRDF(target.world, target.model, data_);
+    }
+
+private:
+    std::string data_;
+};
+
+typedef SnapshotHolder<ModelSnapshot> ModelSnapshotHolder;
+typedef ModelSnapshotHolder::Snapshot ModelSnapshotRef;
+
+// Model of the current snapshot for one reader thread
+//
+// update() reads a snapshot only when a new one was published, otherwise
+// the model of the previous call is returned, reading a new one is
+// O(model size) (see ModelSnapshot). A SnapshotReader must not be
+// shared between threads, but any number of readers can use one holder.
+
+class SnapshotReader
+{
+public:
+    typedef std::function<std::unique_ptr<WorldModel> ()> Factory;
+
+    SnapshotReader(const ModelSnapshotHolder &holder, const std::string &base_uri)
+        : holder_(holder)
+        , factory_([base_uri]() { return std::unique_ptr<WorldModel>(new WorldModel(base_uri)); })
+    { }
+
+    SnapshotReader(const ModelSnapshotHolder &holder, const Factory &factory)
+        : holder_(holder)
+        , factory_(factory)
+    { }
+
+    SnapshotReader(const SnapshotReader &) = delete;
+    SnapshotReader & operator=(const SnapshotReader &) = delete;
+
+    // Returns the model of the current snapshot, null when no snapshot is
+    // published or it could not be read. A model which is replaced stays
+    // alive as long as it is referenced (e.g. by Context::owner).
+    const std::shared_ptr<WorldModel> & update()
+    {
+        ModelSnapshotRef snapshot = holder_.acquire();
+        if (snapshot.get() == snapshot_.get())
+            return model_;
+        snapshot_ = std::move(snapshot);
+        model_.reset();
+        if (snapshot_)
+        {
+            std::shared_ptr<WorldModel> model(factory_());
+            if (snapshot_->read(*model))
+                model_ = std::move(model);
+        }
+        return model_;
+    }
+
+    const std::shared_ptr<WorldModel> & model() const { return model_; }
+
+private:
+    const ModelSnapshotHolder &holder_;
+    Factory factory_;
+    ModelSnapshotRef snapshot_;
+    std::shared_ptr<WorldModel> model_;
+};
+
+// Owner for Context::owner, Lazy members read from the model of a reader
+// keep it alive
+inline std::shared_ptr<const void> snapshotOwner(const std::shared_ptr<WorldModel> &model)
+{
+    return model;
+}
+
+} // namespace RDF
+} // namespace Arvida
+
+#endif
@@ -20,9 +20,21 @@
 
 #include "sord/sordmm.hpp"
 #include "serd/serd.h"
+#include "RDFSchema.hpp"
+#include "RDFLazy.hpp"
+#include "RDFProjection.hpp"
+#include "RDFPath.hpp"
+#include "RDFStringRef.hpp"
+#include <algorithm>
+#include <cassert>
 #include <memory>
 #include <vector>
+#include <deque>
 #include <unordered_map>
+#include <unordered_set>
+#include <map>
+#include <type_traits>
+#include <cstring>
 #include <boost/any.hpp>
 
 namespace Arvida {
@@ -32,6 +44,96 @@ typedef Sord::Node Node;
 typedef Sord::Node * NodePtr;
 typedef Sord::Node & NodeRef;
 typedef std::unordered_map<std::string, boost::any> Cache;
+typedef std::map<std::string, std::string> Prefixes;
+
+struct Context;
+
+// Objects nested deeper than this are not serialized recursively, the
+// remaining object graph is processed with a work queue. Deserialization
+// recurses unless fromRDFIterative is used (it changes when setters see the
+// objects, see ReadItem).
+#ifndef ARVIDA_RDF_MAX_RECURSION_DEPTH
+#define ARVIDA_RDF_MAX_RECURSION_DEPTH 64
+#endif
+
+// Deferred serialization of nested objects
+//
+// When the context has a work queue, createRDFNodeAndSerialize only creates
+// the node of a nested object and queues its serialization, the owner of the
+// queue runs the queued items (see SordRDFSerializer.hpp). Queued values are
+// referenced, so the object graph must not change until the queue is empty.
+// Values which are not part of the object graph (returned by value) are copied.
+
+struct WorkItem
+{
+    typedef void (*Function)(const Context &ctx, Node &node, const void *value);
+
+    Function function;
+    const void *value;
+    std::shared_ptr<const void> owner;
+    std::string path;
+    unsigned depth;
+    Node node;
+
+    WorkItem() : function(0), value(0), depth(0) { }
+};
+
+struct WorkQueue
+{
+    std::deque<WorkItem> items;
+    std::unordered_set<std::string> queued;
+
+    bool empty() const { return items.empty(); }
+
+    void clear()
+    {
+        items.clear();
+        queued.clear();
+    }
+};
+
+enum TraversalOrder
+{
+    DEPTH_FIRST,   // work stack, objects in pre-order like recursive serialization
+    BREADTH_FIRST  // work queue, serializes the object graph level by level
+};
+
+inline WorkItem popWorkItem(WorkQueue &work, TraversalOrder order)
+{
+    WorkItem item;
+    if (order == BREADTH_FIRST)
+    {
+        item = std::move(work.items.front());
+        work.items.pop_front();
+    }
+    else
+    {
+        item = std::move(work.items.back());
+        work.items.pop_back();
+    }
+    return item;
+}
+
+// Deferred deserialization of nested objects
+//
+// When the context has a read queue, fromRDF of a std::shared_ptr only
+// queues reading of the object, the owner of the queue runs the queued items
+// (see fromRDFIterative of SordRDFSerializer.hpp). The setter already
+// receives the pointer and the object is filled afterwards, so setters must
+// keep the pointer instead of copying the object.
+
+struct ReadItem
+{
+    typedef bool (*Function)(const Context &ctx, Node &node, void *value);
+
+    Function function;
+    std::shared_ptr<void> value;
+    Node node;
+
+    ReadItem() : function(0) { }
+};
+
+typedef std::deque<ReadItem> ReadQueue;
 
 struct Context
 {
@@ -40,11 +142,20 @@ struct Context
     const std::string &path;
     Cache *cache;
     const void *user_data;
+    WorkQueue *work;
+    ReadQueue *reads;
+    // Keeps the model alive for Lazy members read with this context, e.g. a
+    // snapshot, required for reading them (see unownedModel())
+    std::shared_ptr<const void> owner;
+    // Projection of toRDF (see RDFProjection.hpp) and depth of the object
+    // serialized with this context
+    const Projection *projection;
+    unsigned depth;
 
-    Context(Sord::Model &model, const std::string &base_path, const std::string &path, Cache *cache = 0, const void *user_data = 0) : model(model), base_path(base_path), path(path), cache(cache), user_data(user_data) { }
-    Context(Sord::Model &model, const std::string &path, Cache *cache = 0, const void *user_data = 0) : model(model), base_path(path), path(path), cache(cache), user_data(user_data) { }
-    Context(const Context &ctx) : model(ctx.model), base_path(ctx.base_path), path(ctx.path), cache(ctx.cache), user_data(ctx.user_data) { }
-    Context(const Context &ctx, const std::string &path) : model(ctx.model), base_path(ctx.base_path), path(path), cache(ctx.cache), user_data(ctx.user_data) { }
+    Context(Sord::Model &model, const std::string &base_path, const std::string &path, Cache *cache = 0, const void *user_data = 0, WorkQueue *work = 0) : model(model), base_path(base_path), path(path), cache(cache), user_data(user_data), work(work), reads(0), projection(0), depth(0) { }
+    Context(Sord::Model &model, const std::string &path, Cache *cache = 0, const void *user_data = 0, WorkQueue *work = 0) : model(model), base_path(path), path(path), cache(cache), user_data(user_data), work(work), reads(0), projection(0), depth(0) { }
+    Context(const Context &ctx) : model(ctx.model), base_path(ctx.base_path), path(ctx.path), cache(ctx.cache), user_data(ctx.user_data), work(ctx.work), reads(ctx.reads), owner(ctx.owner), projection(ctx.projection), depth(ctx.depth) { }
+    Context(const Context &ctx, const std::string &path) : model(ctx.model), base_path(ctx.base_path), path(path), cache(ctx.cache), user_data(ctx.user_data), work(ctx.work), reads(ctx.reads), owner(ctx.owner), projection(ctx.projection), depth(ctx.depth) { }
 };
 
 struct Triple
@@ -61,6 +172,85 @@ struct Triple
         , object(object)
     { }
 
+    // Takes one reference of each node of quad
+    Triple(Sord::World &world, const SordQuad quad)
+        : subject(world, quad[SORD_SUBJECT])
+        , predicate(world, quad[SORD_PREDICATE])
+        , object(world, quad[SORD_OBJECT])
+    { }
+
+    bool is_valid() const
+    {
+        return subject.is_valid() && predicate.is_valid() && object.is_valid();
+    }
+};
+
+// Non-owning nodes
+//
+// A NodeView references a node without taking a reference, it is valid as
+// long as the node is used by a statement of the model (or by a Node). The
+// generated readers look up member triples with find_triple_view, so
+// reading a member does not copy nodes. Converting a view to a Node takes
+// a reference.
+
+class NodeView
+{
+public:
+    NodeView() : world_(0), node_(0) { }
+
+    NodeView(Sord::World &world, const SordNode *node) : world_(&world), node_(node) { }
+
+    bool is_valid() const { return node_ != 0; }
+
+    bool is_uri() const { return node_ && sord_node_get_type(node_) == SORD_URI; }
+
+    bool is_blank() const { return node_ && sord_node_get_type(node_) == SORD_BLANK; }
+
+    bool is_literal() const { return node_ && sord_node_get_type(node_) == SORD_LITERAL; }
+
+    bool is_literal_type(const char *type_uri) const
+    {
+        if (!is_literal())
+            return false;
+        const SordNode *datatype = sord_node_get_datatype(node_);
+        return datatype && std::strcmp(reinterpret_cast<const char *>(sord_node_get_string(datatype)), type_uri) == 0;
+    }
+
+    const char * to_c_string() const
+    {
+        return node_ ? reinterpret_cast<const char *>(sord_node_get_string(node_)) : "";
+    }
+
+    const SordNode * c_obj() const { return node_; }
+
+    operator Sord::Node() const
+    {
+        return node_ ? Sord::Node(*world_, node_) : Sord::Node();
+    }
+
+    bool operator==(const NodeView &other) const { return node_ == other.node_; }
+
+    bool operator!=(const NodeView &other) const { return node_ != other.node_; }
+
+private:
+    Sord::World *world_;
+    const SordNode *node_;
+};
+
+struct TripleView
+{
+    NodeView subject;
+    NodeView predicate;
+    NodeView object;
+
+    TripleView() { }
+
+    TripleView(Sord::World &world, const SordQuad quad)
+        : subject(world, quad[SORD_SUBJECT])
+        , predicate(world, quad[SORD_PREDICATE])
+        , object(world, quad[SORD_OBJECT])
+    { }
+
     bool is_valid() const
     {
         return subject.is_valid() && predicate.is_valid() && object.is_valid();
@@ -78,7 +268,9 @@ inline Triple find_triple(Sord::Model &model, const Sord::Node &subject, const S
     Sord::Iter iter = model.find(subject, predicate, object);
     if (iter.end())
         return Triple();
-    return Triple(iter.get_subject(), iter.get_predicate(), iter.get_object());
+    SordQuad quad;
+    sord_iter_get(iter.c_obj(), quad);
+    return Triple(model.world(), quad);
 }
 
 inline std::vector<Triple> find_triples(Sord::Model &model, const Sord::Node &subject, const Sord::Node &predicate, const Sord::Node &object)
@@ -86,7 +278,31 @@ inline std::vector<Triple> find_triples(Sord::Model &model, const Sord::Node &su
     std::vector<Triple> result;
     for (Sord::Iter iter = model.find(subject, predicate, object); !iter.end(); iter.next())
     {
-        result.emplace_back(iter.get_subject(), iter.get_predicate(), iter.get_object());
+        SordQuad quad;
+        sord_iter_get(iter.c_obj(), quad);
+        result.emplace_back(model.world(), quad);
+    }
+    return result;
+}
+
+inline TripleView find_triple_view(Sord::Model &model, const Sord::Node &subject, const Sord::Node &predicate, const Sord::Node &object)
+{
+    Sord::Iter iter = model.find(subject, predicate, object);
+    if (iter.end())
+        return TripleView();
+    SordQuad quad;
+    sord_iter_get(iter.c_obj(), quad);
+    return TripleView(model.world(), quad);
+}
+
+inline std::vector<TripleView> find_triples_view(Sord::Model &model, const Sord::Node &subject, const Sord::Node &predicate, const Sord::Node &object)
+{
+    std::vector<TripleView> result;
+    for (Sord::Iter iter = model.find(subject, predicate, object); !iter.end(); iter.next())
+    {
+        SordQuad quad;
+        sord_iter_get(iter.c_obj(), quad);
+        result.emplace_back(model.world(), quad);
     }
     return result;
 }
@@ -112,6 +328,117 @@ inline bool isNodeExists(Sord::Model &model, const Sord::Node &node)
     return false;
 }
 
+// Backend of the schema engine (RDFSchema.hpp)
+
+inline Node schemaConstantNode(const Context &ctx, const SchemaNode &node)
+{
+    if (node.kind == SCHEMA_IRI)
+        return Sord::URI(ctx.model.world(), node.value);
+    return Sord::Curie(ctx.model.world(), node.value);
+}
+
+inline Node schemaBlankNode(const Context &ctx)
+{
+    return Node::blank_id(ctx.model.world());
+}
+
+inline void schemaAddStatement(const Context &ctx, const Node &subject, const Node &predicate, const Node &object)
+{
+    ctx.model.add_statement(subject, predicate, object);
+}
+
+inline Triple schemaFindTriple(const Context &ctx, const Node &subject, const Node &predicate, const Node &object)
+{
+    return find_triple(ctx.model, subject, predicate, object);
+}
+
+// Constant nodes of skeletons, three per triple (unset for $this and blank
+// nodes). Stored in the cache of the context under "skeletons", per world,
+// since nodes belong to the world they were created in and a cache may be
+// used with models of different worlds. The cache must not outlive them.
+typedef std::unordered_map<const SchemaSkeleton *, std::vector<Node> > SkeletonNodes;
+typedef std::unordered_map<const SordWorld *, SkeletonNodes> WorldSkeletonNodes;
+
+inline void resolveSkeleton(const Context &ctx, const SchemaSkeleton &skeleton, std::vector<Node> &constants)
+{
+    constants.reserve(skeleton.tripleCount * 3);
+    for (size_t t = 0; t < skeleton.tripleCount; ++t)
+    {
+        const SchemaNode *nodes[] = { &skeleton.triples[t].subject, &skeleton.triples[t].predicate, &skeleton.triples[t].object };
+        for (int i = 0; i < 3; ++i)
+            constants.push_back(nodes[i]->kind >= SCHEMA_PREFIXED_NAME ? schemaConstantNode(ctx, *nodes[i]) : Node());
+    }
+}
+
+// Adds all triples of a skeleton. Without a cache the constant nodes are
+// resolved on each call.
+inline void addSkeleton(const Context &ctx, const SchemaSkeleton &skeleton, Node &_this, Node *const *blanks)
+{
+    std::vector<Node> local;
+    const std::vector<Node> *constants = &local;
+    if (ctx.cache)
+    {
+        boost::any &entry = (*ctx.cache)["skeletons"];
+        if (entry.empty())
+            entry = WorldSkeletonNodes();
+        SkeletonNodes &nodes = boost::any_cast<WorldSkeletonNodes &>(entry)[ctx.model.world().c_obj()];
+        std::vector<Node> &cached = nodes[&skeleton];
+        if (cached.empty())
+            resolveSkeleton(ctx, skeleton, cached);
+        constants = &cached;
+    }
+    else
+        resolveSkeleton(ctx, skeleton, local);
+
+    for (size_t t = 0; t < skeleton.tripleCount; ++t)
+    {
+        const SchemaTriple &triple = skeleton.triples[t];
+        const Node *constant = &(*constants)[t * 3];
+        ctx.model.add_statement(schemaSkeletonNode(triple.subject, constant[0], _this, blanks),
+                                schemaSkeletonNode(triple.predicate, constant[1], _this, blanks),
+                                schemaSkeletonNode(triple.object, constant[2], _this, blanks));
+    }
+}
+
+// Removes all statements, keeps the world with its prefixes
+
+inline void clearModel(Sord::Model &model)
+{
+    SordIter *iter = sord_begin(model.c_obj());
+    while (iter && !sord_iter_end(iter))
+        sord_erase(model.c_obj(), iter);
+    sord_iter_free(iter);
+}
+
+// Model together with its own world and a cache for Context::cache. When the
+// model is cleared Sord frees the nodes which are no longer referenced, only
+// nodes held in the cache (e.g. the resolved skeleton nodes) are kept.
+
+struct WorldModel
+{
+    Sord::World world;
+    Sord::Model model;
+    Cache cache;
+
+    explicit WorldModel(const std::string &base_uri, unsigned indices = (SORD_SPO|SORD_OPS))
+        : world()
+        , model(world, base_uri, indices)
+    { }
+
+    WorldModel(const std::string &base_uri, const Prefixes &prefixes, unsigned indices = (SORD_SPO|SORD_OPS))
+        : world()
+        , model(world, base_uri, indices)
+    {
+        for (Prefixes::const_iterator it = prefixes.begin(); it != prefixes.end(); ++it)
+            world.add_prefix(it->first, it->second);
+    }
+
+    void clear()
+    {
+        clearModel(model);
+    }
+};
+
 template <class T>
 inline bool isValidValue(const T &value)
 {
@@ -124,6 +451,14 @@ inline bool isValidValue(const std::shared_ptr<T> &value)
     return value.operator bool();
 }
 
+// A pending object is not loaded, errors in it are detected when it is
+// written
+template < class T >
+inline bool isValidValue(const Lazy<T> &value)
+{
+    return value.operator bool();
+}
+
 // PathType
 
 enum PathType
@@ -170,6 +505,12 @@ inline std::string pathOf(const Context &ctx, const std::shared_ptr<T> &value)
         return "";
 }
 
+template<class T>
+inline std::string pathOf(const Context &ctx, const Lazy<T> &value)
+{
+    return pathOf(ctx, value.get());
+}
+
 template<class T>
 inline PathType pathTypeOf(const Context &ctx, const T &value)
 {
@@ -185,6 +526,12 @@ inline PathType pathTypeOf(const Context &ctx, const std::shared_ptr<T> &value)
         return NO_PATH;
 }
 
+template<class T>
+inline PathType pathTypeOf(const Context &ctx, const Lazy<T> &value)
+{
+    return pathTypeOf(ctx, value.get());
+}
+
 template<>
 inline std::string pathOf(const Context &ctx, const double &value)
 {
@@ -253,6 +600,110 @@ std::string joinPath(const std::string &path1, const std::string path2)
     }
 }
 
+// IsLiteral: values serialized into a literal node, they are never deferred.
+// Specialize for custom types with a toRDF overload creating literals.
+
+template <class T>
+struct IsLiteral : std::integral_constant<bool, std::is_arithmetic<T>::value> { };
+
+template <>
+struct IsLiteral<std::string> : std::true_type { };
+
+template <class T>
+struct IsLiteral<std::shared_ptr<T> > : IsLiteral<T> { };
+
+// Reference type of a container element, elements of a container which is
+// returned by value are not part of the object graph
+
+template <class ContainerRef, class Element>
+using ElementRef = typename std::conditional<std::is_reference<ContainerRef>::value,
+    Element, typename std::decay<Element>::type>::type;
+
+template <class T>
+void runWorkItem(const Context &ctx, Node &node, const void *value)
+{
+    toRDF(ctx, node, *static_cast<const T *>(value));
+}
+
+template <class T>
+inline const void * holdValue(const T &value, std::shared_ptr<const void> &owner, std::true_type)
+{
+    return &value;
+}
+
+template <class T>
+inline const void * holdValue(const T &value, std::shared_ptr<const void> &owner, std::false_type)
+{
+    std::shared_ptr<const T> copy = std::make_shared<T>(value);
+    owner = copy;
+    return copy.get();
+}
+
+// Runs the next queued item with the model, paths and settings of ctx.
+// Depth-first the items queued by the item are reversed, so nested objects
+// are serialized in member order like with recursive serialization.
+inline void runNextWorkItem(const Context &ctx, WorkQueue &work, TraversalOrder order)
+{
+    WorkItem item(popWorkItem(work, order));
+    const size_t queued = work.items.size();
+    Context itemCtx(ctx.model, ctx.base_path, item.path, ctx.cache, ctx.user_data, &work);
+    itemCtx.projection = ctx.projection;
+    itemCtx.depth = item.depth;
+    item.function(itemCtx, item.node, item.value);
+    if (order == DEPTH_FIRST)
+        std::reverse(work.items.begin() + queued, work.items.end());
+}
+
+inline void runWorkQueue(const Context &ctx, WorkQueue &work, TraversalOrder order)
+{
+    while (!work.empty())
+        runNextWorkItem(ctx, work, order);
+}
+
+// Serializes value to node, nested objects are queued and serialized
+// depth-first without recursion
+template <class T>
+void serializeRDFNodeIteratively(const Context &ctx, NodeRef node, const T &value)
+{
+    WorkQueue work;
+    Context workCtx(ctx);
+    workCtx.work = &work;
+    toRDF(workCtx, node, value);
+    runWorkQueue(workCtx, work, DEPTH_FIRST);
+}
+
+// Serializes value to node, or queues its serialization when ctx has a work
+// queue. ValueRef is a reference type when value is part of the object graph.
+// Objects nested deeper than ARVIDA_RDF_MAX_RECURSION_DEPTH are serialized
+// with a work queue of their own.
+
+template <class ValueRef, class T>
+void serializeRDFNode(const Context &ctx, NodeRef node, const T &value)
+{
+    if (!ctx.work || IsLiteral<T>::value || !isValidValue(value))
+    {
+        if (isNodeExists(ctx.model, node))
+            return;
+        if (!ctx.work && ctx.depth >= ARVIDA_RDF_MAX_RECURSION_DEPTH && !IsLiteral<T>::value && isValidValue(value))
+            serializeRDFNodeIteratively(ctx, node, value);
+        else
+            toRDF(ctx, node, value);
+        return;
+    }
+    if (isNodeExists(ctx.model, node))
+        return;
+    if (!node.is_blank() && !ctx.work->queued.insert(ctx.path).second)
+        return;
+
+    ctx.work->items.push_back(WorkItem());
+    WorkItem &item = ctx.work->items.back();
+    item.function = &runWorkItem<T>;
+    item.value = holdValue(value, item.owner, typename std::is_reference<ValueRef>::type());
+    item.path = ctx.path;
+    item.depth = ctx.depth;
+    item.node = node;
+}
+
 // createRDFNode
 
 template<class T>
@@ -270,7 +721,7 @@ Node createRDFNode(const Context &ctx, const T &value, PathType memberPathType,
         if (thatPathType == ABSOLUTE_PATH)
             thatPath = pathOf(ctx, value);
         else if (thatPathType == RELATIVE_TO_BASE_PATH)
-            thatPath = joinPath(ctx.base_path, pathOf(ctx, value));
+            joinPathInto(thatPath, ctx.base_path, pathOf(ctx, value));
         else {
             switch (memberPathType)
             {
@@ -278,17 +729,17 @@ Node createRDFNode(const Context &ctx, const T &value, PathType memberPathType,
                     thatPath = ctx.path;
                     break;
                 case RELATIVE_PATH:
-                    thatPath = joinPath(ctx.path, memberPath);
+                    joinPathInto(thatPath, ctx.path, memberPath);
                     break;
                 case RELATIVE_TO_BASE_PATH:
-                    thatPath = joinPath(ctx.base_path, memberPath);
+                    joinPathInto(thatPath, ctx.base_path, memberPath);
                     break;
                 case ABSOLUTE_PATH:
                     thatPath = memberPath;
                     break;
             }
             if (thatPathType == RELATIVE_PATH)
-                thatPath = joinPath(thatPath, pathOf(ctx, value));
+                appendPath(thatPath, pathOf(ctx, value));
         }
         Arvida::RDF::Context thatCtx(ctx, thatPath);
         Sord::URI thatNode(ctx.model.world(), thatPath);
@@ -296,15 +747,21 @@ Node createRDFNode(const Context &ctx, const T &value, PathType memberPathType,
     }
 }
 
-template<class T>
+template<class ValueRef = void, class T>
 Node createRDFNodeAndSerialize(const Context &ctx, const T &value, PathType memberPathType, const std::string &memberPath)
 {
     const PathType thatPathType = pathTypeOf(ctx, value);
     if (thatPathType == NO_PATH)
     {
         Node thatNode(Node::blank_id(ctx.model.world()));
-        if (!isNodeExists(ctx.model, thatNode))
-            toRDF(ctx, thatNode, value);
+        if (!IsNestedObject<T>::value)
+            serializeRDFNode<ValueRef>(ctx, thatNode, value);
+        else if (!projectionCut(ctx))
+        {
+            Arvida::RDF::Context thatCtx(ctx);
+            ++thatCtx.depth;
+            serializeRDFNode<ValueRef>(thatCtx, thatNode, value);
+        }
         return thatNode;
     }
     else
@@ -313,7 +770,7 @@ Node createRDFNodeAndSerialize(const Context &ctx, const T &value, PathType memb
         if (thatPathType == ABSOLUTE_PATH)
             thatPath = pathOf(ctx, value);
         else if (thatPathType == RELATIVE_TO_BASE_PATH)
-            thatPath = joinPath(ctx.base_path, pathOf(ctx, value));
+            joinPathInto(thatPath, ctx.base_path, pathOf(ctx, value));
         else {
             switch (memberPathType)
             {
@@ -321,22 +778,25 @@ Node createRDFNodeAndSerialize(const Context &ctx, const T &value, PathType memb
                     thatPath = ctx.path;
                     break;
                 case RELATIVE_PATH:
-                    thatPath = joinPath(ctx.path, memberPath);
+                    joinPathInto(thatPath, ctx.path, memberPath);
                     break;
                 case RELATIVE_TO_BASE_PATH:
-                    thatPath = joinPath(ctx.base_path, memberPath);
+                    joinPathInto(thatPath, ctx.base_path, memberPath);
                     break;
                 case ABSOLUTE_PATH:
                     thatPath = memberPath;
                     break;
             }
             if (thatPathType == RELATIVE_PATH)
-                thatPath = joinPath(thatPath, pathOf(ctx, value));
+                appendPath(thatPath, pathOf(ctx, value));
+        }
+        Node thatNode = Sord::URI(ctx.model.world(), thatPath);
+        if (!projectionCut(ctx))
+        {
+            Arvida::RDF::Context thatCtx(ctx, thatPath);
+            ++thatCtx.depth;
+            serializeRDFNode<ValueRef>(thatCtx, thatNode, value);
         }
-        Arvida::RDF::Context thatCtx(ctx, thatPath);
-        Sord::URI thatNode(ctx.model.world(), thatPath);
-        if (!isNodeExists(ctx.model, thatNode))
-            toRDF(thatCtx, thatNode, value);
         return thatNode;
     }
 }
@@ -369,6 +829,12 @@ inline NodeRef toRDF(const Context &ctx, NodeRef thisNode, const std::shared_ptr
     }
 }
 
+template < class T >
+inline NodeRef toRDF(const Context &ctx, NodeRef thisNode, const Lazy<T> &value)
+{
+    return toRDF(ctx, thisNode, value.get());
+}
+
 template < class T >
 inline NodeRef toRDF(const Context &ctx, NodeRef thisNode, const std::vector<T> &value)
 {
@@ -378,7 +844,9 @@ inline NodeRef toRDF(const Context &ctx, NodeRef thisNode, const std::vector<T>
     for (auto it = std::begin(value); it != std::end(value); ++it)
     {
         const auto & _that = *it;
-        ctx.model.add_statement(thisNode, Curie(ctx.model.world(), "core:member"), Arvida::RDF::toRDF(ctx, _that));
+        Sord::Node memberNode = Sord::Node::blank_id(ctx.model.world());
+        serializeRDFNode<decltype((*it))>(ctx, memberNode, _that);
+        ctx.model.add_statement(thisNode, Curie(ctx.model.world(), "core:member"), memberNode);
     }
     return thisNode;
 }
@@ -425,42 +893,182 @@ bool fromRDF(const Context &ctx, const NodeRef thisNode, T &value)
     return value.fromRDF(ctx, thisNode);
 }
 
+// Reads the members in mask (see Members<T>), specialized for annotated
+// classes. Other types are read completely.
 template < class T >
-bool fromRDF(const Context &ctx, const NodeRef thisNode, std::shared_ptr<T> &value)
+bool fromRDF(const Context &ctx, const NodeRef thisNode, T &value, MemberMask mask)
 {
-    return value ? fromRDF(ctx, thisNode, *value) : false;
+    return fromRDF(ctx, thisNode, value);
 }
 
-template <>
-inline bool fromRDF(const Context &ctx, const NodeRef _this0, double &value)
+template <class T>
+bool runReadItem(const Context &ctx, Node &node, void *value)
 {
-    if (_this0.is_literal_type(SORD_NS_XSD "integer") ||
-        _this0.is_literal_type(SORD_NS_XSD "decimal") ||
-        _this0.is_literal_type(SORD_NS_XSD "double"))
+    return fromRDF(ctx, node, *static_cast<T *>(value));
+}
+
+// Runs the queued items until the queue is empty or an object could not be
+// read
+inline bool runReadQueue(const Context &ctx, ReadQueue &reads)
+{
+    while (!reads.empty())
     {
-        char* endptr;
-        value = serd_strtod(_this0.to_c_string(), &endptr);
+        ReadItem item(std::move(reads.front()));
+        reads.pop_front();
+        if (!item.function(ctx, item.node, item.value.get()))
+        {
+            reads.clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+// Reads value from node, nested objects held by std::shared_ptr are queued
+// and read without recursion
+template <class T>
+bool fromRDFNodeIteratively(const Context &ctx, NodeRef node, T &value)
+{
+    ReadQueue reads;
+    Context readCtx(ctx);
+    readCtx.reads = &reads;
+    return fromRDF(readCtx, node, value) && runReadQueue(readCtx, reads);
+}
+
+// Reads the object before it is passed to the setter, or queues reading it
+// when ctx has a read queue (fromRDFIterative). Reading is not switched to a
+// queue beyond ARVIDA_RDF_MAX_RECURSION_DEPTH like serialization, the setter
+// would then receive an object which was not read yet.
+template < class T >
+bool fromRDF(const Context &ctx, const NodeRef thisNode, std::shared_ptr<T> &value)
+{
+    if (!value)
+        return false;
+    if (IsLiteral<T>::value)
+        return fromRDF(ctx, thisNode, *value);
+    if (ctx.reads)
+    {
+        ctx.reads->push_back(ReadItem());
+        ReadItem &item = ctx.reads->back();
+        item.function = &runReadItem<T>;
+        item.value = value;
+        item.node = thisNode;
         return true;
     }
+    return fromRDF(ctx, thisNode, *value);
+}
 
-    return false;
+// Reads from a node view, specialized for literals which are read without
+// taking a reference
+template < class T >
+bool fromRDF(const Context &ctx, const NodeView &thisNode, T &value)
+{
+    Node node = thisNode;
+    return fromRDF(ctx, node, value);
 }
 
-template <>
-inline bool fromRDF(const Context &ctx, const NodeRef _this0, float &value)
+// Node and model of a Lazy member, the owner is released after the node
+struct LazySource
+{
+    std::shared_ptr<const void> owner;
+    Sord::Model *model;
+    std::string base_path;
+    std::string path;
+    const void *user_data;
+    Node node;
+};
+
+// Owner for Context::owner of a model which the caller keeps alive as long
+// as the Lazy members read from it
+inline std::shared_ptr<const void> unownedModel(const Sord::Model &model)
+{
+    return std::shared_ptr<const void>(std::shared_ptr<const void>(), &model);
+}
+
+// Stores the node, the object is read on first access. The model is
+// referenced, so the context needs an owner (see unownedModel()).
+template < class T >
+bool fromRDF(const Context &ctx, const NodeRef thisNode, Lazy<T> &value)
+{
+    assert(ctx.owner && "Lazy members are only read with Context::owner");
+    if (!ctx.owner)
+        return false;
+    std::shared_ptr<LazySource> source = std::make_shared<LazySource>();
+    source->owner = ctx.owner;
+    source->model = &ctx.model;
+    source->base_path = ctx.base_path;
+    source->path = ctx.path;
+    source->user_data = ctx.user_data;
+    source->node = thisNode;
+    value = Lazy<T>([source](T &result) {
+        Context lazy(*source->model, source->base_path, source->path, 0, source->user_data);
+        lazy.owner = source->owner;
+        return fromRDF(lazy, source->node, result);
+    });
+    return true;
+}
+
+// Literals, NodeType is Node or NodeView
+
+template <class NodeType, class T>
+inline bool parseFloating(const NodeType &node, T &value)
 {
-    if (_this0.is_literal_type(SORD_NS_XSD "integer") ||
-        _this0.is_literal_type(SORD_NS_XSD "decimal") ||
-        _this0.is_literal_type(SORD_NS_XSD "double"))
+    if (node.is_literal_type(SORD_NS_XSD "integer") ||
+        node.is_literal_type(SORD_NS_XSD "decimal") ||
+        node.is_literal_type(SORD_NS_XSD "double") ||
+        node.is_literal_type(SORD_NS_XSD "float"))
     {
+        const char *str = node.to_c_string();
         char* endptr;
-        value = serd_strtod(_this0.to_c_string(), &endptr);
-        return true;
+        value = static_cast<T>(serd_strtod(str, &endptr));
+        if (endptr == str)
+            return false;
+        // Trailing whitespace is allowed (xsd whitespace collapse), other
+        // characters are not
+        while (*endptr == ' ' || *endptr == '\t' || *endptr == '\n' || *endptr == '\r')
+            ++endptr;
+        return *endptr == '\0';
     }
 
     return false;
 }
 
+// References the string of the node, see RDFStringRef.hpp
+template <class NodeType>
+inline bool readStringRef(const NodeType &node, StringRef &value)
+{
+    size_t size = 0;
+    const uint8_t *data = sord_node_get_string_counted(node.c_obj(), &size);
+    if (!data)
+        return false;
+    value = StringRef(reinterpret_cast<const char *>(data), size);
+    return true;
+}
+
+template <>
+inline bool fromRDF(const Context &ctx, const NodeRef _this0, double &value)
+{
+    return parseFloating(_this0, value);
+}
+
+template <>
+inline bool fromRDF(const Context &ctx, const NodeView &_this0, double &value)
+{
+    return parseFloating(_this0, value);
+}
+
+template <>
+inline bool fromRDF(const Context &ctx, const NodeRef _this0, float &value)
+{
+    return parseFloating(_this0, value);
+}
+
+template <>
+inline bool fromRDF(const Context &ctx, const NodeView &_this0, float &value)
+{
+    return parseFloating(_this0, value);
+}
+
 template <>
 inline bool fromRDF(const Context &ctx, const NodeRef _this0, std::string &value)
 {
@@ -468,6 +1076,47 @@ inline bool fromRDF(const Context &ctx, const NodeRef _this0, std::string &value
     return true;
 }
 
+template <>
+inline bool fromRDF(const Context &ctx, const NodeView &_this0, std::string &value)
+{
+    value = _this0.to_c_string();
+    return true;
+}
+
+template <>
+inline bool fromRDF(const Context &ctx, const NodeRef _this0, StringRef &value)
+{
+    return readStringRef(_this0, value);
+}
+
+template <>
+inline bool fromRDF(const Context &ctx, const NodeView &_this0, StringRef &value)
+{
+    return readStringRef(_this0, value);
+}
+
+#ifdef ARVIDA_RDF_HAS_STRING_VIEW
+template <>
+inline bool fromRDF(const Context &ctx, const NodeRef _this0, std::string_view &value)
+{
+    StringRef ref;
+    if (!readStringRef(_this0, ref))
+        return false;
+    value = ref;
+    return true;
+}
+
+template <>
+inline bool fromRDF(const Context &ctx, const NodeView &_this0, std::string_view &value)
+{
+    StringRef ref;
+    if (!readStringRef(_this0, ref))
+        return false;
+    value = ref;
+    return true;
+}
+#endif
+
 } // namespace Arvida
 } // namespace RDF
 
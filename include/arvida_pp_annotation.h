@@ -125,6 +125,9 @@ void   arvida_global_annotation_func(const char *str, ...);
 #define arvida_uid_method(method_name) \
         "arvida-uid-method", ARVIDA_STRINGIZE(method_name), "arvida-eop"
 
+#define arvida_prefix(prefix, uri) \
+        "arvida-prefix", prefix, uri, "arvida-eop"
+
 #define arvida_class_stmt(a, b, c)                                                  \
         "arvida-class-stmt", ARVIDA_STRINGIZE(a), ARVIDA_STRINGIZE(b), ARVIDA_STRINGIZE(c), "arvida-eop"
 
@@ -193,6 +196,7 @@ void   arvida_global_annotation_func(const char *str, ...);
 #define arvida_include(include)
 #define arvida_prolog(prolog)
 #define arvida_epilog(epilog)
+#define arvida_prefix(prefix, uri)
 
 #define arvida_annotate_object(T, ...)
 #define arvida_class_stmt(a, b, c)
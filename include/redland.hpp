@@ -32,6 +32,7 @@
 #include <string>
 #include <sstream>
 #include <map>
+#include <vector>
 
 // Macros from Boost C++ Libraries
 
@@ -186,6 +187,18 @@ public:
         }
     }
 
+    void register_with_serializer(raptor_world *world, raptor_serializer *ser) const
+    {
+        raptor_uri *uri;
+        for (std::map<std::string, std::string>::const_iterator it = prefixToUriMap_.begin();
+            it != prefixToUriMap_.end(); ++it)
+        {
+            uri = raptor_new_uri(world, (const unsigned char*)it->second.c_str());
+            raptor_serializer_set_namespace(ser, uri, (const unsigned char*)it->first.c_str());
+            raptor_free_uri(uri);
+        }
+    }
+
 private:
     std::map<std::string, std::string> prefixToUriMap_;
 };
@@ -275,6 +288,15 @@ public:
             throw AllocException("librdf_new_storage");
     }
 
+    // In-memory hashes storage for serialization, which mostly inserts
+    // statements: no contexts and no predicate index, which would be
+    // updated with every statement. Queries by subject, predicate or object
+    // still use the default indexes.
+    static Storage make_memory_hashes(const World &world, const char *name)
+    {
+        return Storage(world, "hashes", name, "hash-type='memory',contexts='no',index-predicates='no'");
+    }
+
     Storage(const Storage &other)
         : CObjWrapper(librdf_new_storage_from_storage(other.c_obj()))
     {
@@ -314,6 +336,11 @@ class Node : public CObjWrapper<librdf_node>
 {
 public:
 
+    // Null node, matches any node in a query pattern
+    Node()
+        : CObjWrapper(NULL)
+    { }
+
     Node(librdf_node *node)
         : CObjWrapper(node)
     { }
@@ -326,9 +353,9 @@ public:
     }
 
     Node(const Node &other)
-        : CObjWrapper(librdf_new_node_from_node(other.c_obj()))
+        : CObjWrapper(other.c_obj() ? librdf_new_node_from_node(other.c_obj()) : NULL)
     {
-        if (!c_obj_)
+        if (!c_obj_ && other.c_obj())
             throw AllocException("librdf_new_node_from_node");
     }
 
@@ -339,15 +366,22 @@ public:
 
     Node & operator=(Node && other)
     {
-        return static_cast<Node&>(CObjWrapper::operator=(std::move(other)));
+        if (this != &other)
+        {
+            if (c_obj_)
+                librdf_free_node(c_obj_);
+            c_obj_ = other.release();
+        }
+        return *this;
     }
 
     Node & operator=(const Node & other)
     {
         if (this != &other)
         {
-            librdf_free_node(c_obj_);
-            c_obj_ = librdf_new_node_from_node(other.c_obj());
+            if (c_obj_)
+                librdf_free_node(c_obj_);
+            c_obj_ = other.c_obj() ? librdf_new_node_from_node(other.c_obj()) : NULL;
         }
         return *this;
     }
@@ -414,9 +448,21 @@ public:
         : Node(world, (const unsigned char *)NULL, tag)
     { }
 
-    bool is_blank() const { return librdf_node_is_blank(c_obj_); }
+    bool is_valid() const { return c_obj_ != NULL; }
+
+    bool is_blank() const { return c_obj_ && librdf_node_is_blank(c_obj_); }
+
+    bool is_literal() const { return c_obj_ && librdf_node_is_literal(c_obj_); }
 
-    bool is_literal() const { return librdf_node_is_literal(c_obj_); }
+    bool is_resource() const { return c_obj_ && librdf_node_is_resource(c_obj_); }
+
+    // Value of a literal node, empty for other nodes
+    std::string get_literal_value() const
+    {
+        size_t length = 0;
+        const unsigned char *value = is_literal() ? librdf_node_get_literal_value_as_counted_string(c_obj_, &length) : NULL;
+        return value ? std::string(reinterpret_cast<const char *>(value), length) : std::string();
+    }
 
     static Node make_blank_node(const World &world)
     {
@@ -458,7 +504,8 @@ public:
 
     ~Node()
     {
-        librdf_free_node(c_obj_);
+        if (c_obj_)
+            librdf_free_node(c_obj_);
     }
 
 };
@@ -469,6 +516,16 @@ class Statement : public CObjWrapper<librdf_statement>
 {
 public:
 
+    // Null statement, e.g. when a query has no result
+    Statement()
+        : CObjWrapper(NULL)
+    { }
+
+    // Takes ownership of statement
+    explicit Statement(librdf_statement *statement)
+        : CObjWrapper(statement)
+    { }
+
     Statement(const World &world)
         : CObjWrapper(librdf_new_statement(world.c_obj()))
     {
@@ -477,9 +534,9 @@ public:
     }
 
     Statement(const Statement &other)
-        : CObjWrapper(librdf_new_statement_from_statement(other.c_obj()))
+        : CObjWrapper(other.c_obj() ? librdf_new_statement_from_statement(other.c_obj()) : NULL)
     {
-        if (!c_obj_)
+        if (!c_obj_ && other.c_obj())
             throw AllocException("librdf_new_statement_from_statement");
     }
 
@@ -497,15 +554,22 @@ public:
 
     Statement & operator=(Statement && other)
     {
-        return static_cast<Statement&>(CObjWrapper::operator=(std::move(other)));
+        if (this != &other)
+        {
+            if (c_obj_)
+                librdf_free_statement(c_obj_);
+            c_obj_ = other.release();
+        }
+        return *this;
     }
 
     Statement & operator=(const Statement & other)
     {
         if (this != &other)
         {
-            librdf_free_statement(c_obj_);
-            c_obj_ = librdf_new_statement_from_statement(other.c_obj());
+            if (c_obj_)
+                librdf_free_statement(c_obj_);
+            c_obj_ = other.c_obj() ? librdf_new_statement_from_statement(other.c_obj()) : NULL;
         }
         return *this;
     }
@@ -519,24 +583,142 @@ public:
 
     ~Statement()
     {
-        librdf_free_statement(c_obj_);
+        if (c_obj_)
+            librdf_free_statement(c_obj_);
     }
 
+    bool is_valid() const { return c_obj_ != NULL; }
+
     Node get_subject() const
     {
-        return Node(librdf_new_node_from_node(librdf_statement_get_subject(c_obj_)));
+        return copy_node(c_obj_ ? librdf_statement_get_subject(c_obj_) : NULL);
     }
 
     Node get_predicate() const
     {
-        return Node(librdf_new_node_from_node(librdf_statement_get_predicate(c_obj_)));
+        return copy_node(c_obj_ ? librdf_statement_get_predicate(c_obj_) : NULL);
     }
 
     Node get_object() const
     {
-        return Node(librdf_new_node_from_node(librdf_statement_get_object(c_obj_)));
+        return copy_node(c_obj_ ? librdf_statement_get_object(c_obj_) : NULL);
+    }
+
+private:
+    static Node copy_node(librdf_node *node)
+    {
+        return Node(node ? librdf_new_node_from_node(node) : NULL);
+    }
+};
+
+// Statement referencing nodes
+//
+// Unlike a Statement it does not copy its nodes, it references them until
+// they are replaced with set(), so the nodes must live during the query or
+// add_statement call it is passed to. It is not allocated and can be
+// reused. As a query pattern null nodes match any node.
+
+class StatementRef
+{
+public:
+
+    explicit StatementRef(const World &world)
+    {
+        librdf_statement_init(world.c_obj(), &statement_);
+    }
+
+    StatementRef(const World &world, const Node &subject, const Node &predicate, const Node &object)
+        : StatementRef(world)
+    {
+        set(subject, predicate, object);
+    }
+
+    StatementRef(const StatementRef &) = delete;
+
+    StatementRef & operator=(const StatementRef &) = delete;
+
+    ~StatementRef()
+    {
+        // The nodes are not owned, librdf_statement_clear would free them
+        set(NULL, NULL, NULL);
+    }
+
+    void set(librdf_node *subject, librdf_node *predicate, librdf_node *object)
+    {
+        librdf_statement_set_subject(&statement_, subject);
+        librdf_statement_set_predicate(&statement_, predicate);
+        librdf_statement_set_object(&statement_, object);
+    }
+
+    void set(const Node &subject, const Node &predicate, const Node &object)
+    {
+        set(subject.c_obj(), predicate.c_obj(), object.c_obj());
+    }
+
+    librdf_statement * c_obj() const { return const_cast<librdf_statement *>(&statement_); }
+
+private:
+    librdf_statement statement_;
+};
+
+// Stream of statements returned by a query, the current statement is owned
+// by the stream and valid until next() is called or the stream is freed.
+
+class Stream : public CObjWrapper<librdf_stream>
+{
+public:
+
+    Stream()
+        : CObjWrapper(NULL)
+    { }
+
+    // Takes ownership of stream
+    explicit Stream(librdf_stream *stream)
+        : CObjWrapper(stream)
+    { }
+
+    Stream(const Stream &) = delete;
+
+    Stream(Stream && other)
+        : CObjWrapper(std::move(other))
+    {
+    }
+
+    Stream & operator=(Stream && other)
+    {
+        if (this != &other)
+        {
+            if (c_obj_)
+                librdf_free_stream(c_obj_);
+            c_obj_ = other.release();
+        }
+        return *this;
+    }
+
+    Stream & operator=(const Stream & other) = delete;
+
+    ~Stream()
+    {
+        if (c_obj_)
+            librdf_free_stream(c_obj_);
+    }
+
+    bool end() const { return !c_obj_ || librdf_stream_end(c_obj_); }
+
+    bool next() { return c_obj_ && librdf_stream_next(c_obj_) == 0; }
+
+    // Current statement, NULL at the end
+    librdf_statement * current() const
+    {
+        return end() ? NULL : librdf_stream_get_object(c_obj_);
     }
 
+    // Copy of the current statement
+    Statement get_statement() const
+    {
+        librdf_statement *statement = current();
+        return Statement(statement ? librdf_new_statement_from_statement(statement) : NULL);
+    }
 };
 
 
@@ -578,13 +760,83 @@ public:
         return librdf_model_add_statement(c_obj_, statement.c_obj()) == 0;
     }
 
-    template <class N1, class N2, class N3>
-    bool add_statement(const World &world, N1 &&subject, N2 &&predicate, N3 &&object)
+    // The storage copies the statement, so nodes are only referenced
+    bool add_statement(const StatementRef &statement)
+    {
+        return librdf_model_add_statement(c_obj_, statement.c_obj()) == 0;
+    }
+
+    bool add_statement(const World &world, const Node &subject, const Node &predicate, const Node &object)
+    {
+        return add_statement(StatementRef(world, subject, predicate, object));
+    }
+
+    // Transactions, the functions return false when the storage does not
+    // support them
+    bool transaction_start()
+    {
+        return librdf_model_transaction_start(c_obj_) == 0;
+    }
+
+    bool transaction_commit()
+    {
+        return librdf_model_transaction_commit(c_obj_) == 0;
+    }
+
+    bool transaction_rollback()
+    {
+        return librdf_model_transaction_rollback(c_obj_) == 0;
+    }
+
+    int size() const
+    {
+        return librdf_model_size(c_obj_);
+    }
+
+    // Statements matching pattern, streamed from the storage
+    Stream find_statements(const StatementRef &pattern) const
+    {
+        return Stream(librdf_model_find_statements(c_obj_, pattern.c_obj()));
+    }
+
+    Stream find_statements(const Statement &pattern) const
+    {
+        return Stream(librdf_model_find_statements(c_obj_, pattern.c_obj()));
+    }
+
+    Stream find_statements(const World &world, const Node &subject, const Node &predicate, const Node &object) const
+    {
+        StatementRef pattern(world, subject, predicate, object);
+        return find_statements(pattern);
+    }
+
+    // First statement matching pattern, a null statement when there is none
+    Statement find_statement(const StatementRef &pattern) const
+    {
+        return find_statements(pattern).get_statement();
+    }
+
+    Statement find_statement(const Statement &pattern) const
+    {
+        return find_statements(pattern).get_statement();
+    }
+
+    Statement find_statement(const World &world, const Node &subject, const Node &predicate, const Node &object) const
     {
-        return add_statement(Statement(world,
-            std::forward<N1>(subject),
-            std::forward<N2>(predicate),
-            std::forward<N3>(object)));
+        return find_statements(world, subject, predicate, object).get_statement();
+    }
+
+    // Removes all statements
+    void clear()
+    {
+        std::vector<librdf_statement *> statements;
+        for (Stream stream(librdf_model_as_stream(c_obj_)); !stream.end(); stream.next())
+            statements.push_back(librdf_new_statement_from_statement(stream.current()));
+        for (std::vector<librdf_statement *>::iterator it = statements.begin(); it != statements.end(); ++it)
+        {
+            librdf_model_remove_statement(c_obj_, *it);
+            librdf_free_statement(*it);
+        }
     }
 
 };
@@ -631,6 +883,90 @@ public:
 
 };
 
+// Serializer writing statements directly to a file handle or a memory
+// buffer, without a model. Statements are passed as Redland::StatementRef,
+// librdf statements and nodes are Raptor statements and terms. Create the
+// serializer with the Raptor world of the Redland world the nodes belong to.
+
+class Serializer : public CObjWrapper<raptor_serializer>
+{
+public:
+
+    Serializer(raptor_world *world, const char *syntax_name)
+        : CObjWrapper(raptor_new_serializer(world, syntax_name))
+        , world_(world)
+        , string_(NULL)
+        , length_(0)
+    {
+        if (!c_obj_)
+            throw AllocException("raptor_new_serializer");
+    }
+
+    Serializer(const World &world, const char *syntax_name)
+        : Serializer(world.c_obj(), syntax_name)
+    { }
+
+    Serializer(const Redland::World &world, const char *syntax_name)
+        : Serializer(librdf_world_get_raptor(world.c_obj()), syntax_name)
+    { }
+
+    Serializer(const Serializer &) = delete;
+
+    Serializer & operator=(const Serializer &) = delete;
+
+    ~Serializer()
+    {
+        raptor_free_serializer(c_obj_);
+        if (string_)
+            raptor_free_memory(string_);
+    }
+
+    // Call before start
+    void set_namespaces(const Redland::Namespaces &namespaces)
+    {
+        namespaces.register_with_serializer(world_, c_obj_);
+    }
+
+    bool start_to_file_handle(FILE *handle)
+    {
+        return raptor_serializer_start_to_file_handle(c_obj_, NULL, handle) == 0;
+    }
+
+    // The output is available with str() after end()
+    bool start_to_string()
+    {
+        if (string_)
+            raptor_free_memory(string_);
+        string_ = NULL;
+        length_ = 0;
+        return raptor_serializer_start_to_string(c_obj_, NULL, &string_, &length_) == 0;
+    }
+
+    bool serialize_statement(const Redland::StatementRef &statement)
+    {
+        return raptor_serializer_serialize_statement(c_obj_, statement.c_obj()) == 0;
+    }
+
+    bool flush()
+    {
+        return raptor_serializer_flush(c_obj_) == 0;
+    }
+
+    bool end()
+    {
+        return raptor_serializer_serialize_end(c_obj_) == 0;
+    }
+
+    std::string str() const
+    {
+        return string_ ? std::string(static_cast<const char *>(string_), length_) : std::string();
+    }
+
+private:
+    raptor_world *world_;
+    void *string_;
+    size_t length_;
+};
 
 } // namespace Raptor
 
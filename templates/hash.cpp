@@ -0,0 +1,58 @@
+{# Structural hash and equality of RDFHash.hpp, imported by all templates #}
+
+{% macro member_ref(mtc, object) %}
+{{ object }}.{{ mtc.member.name }}{% if mtc.is_function() %}(){% endif %}
+{% endmacro %}
+
+{% macro make_hash_decl(c) %}
+template<>
+inline size_t hashValue(const {{ c.full_name }} &value);
+
+template<>
+inline bool equalValue(const {{ c.full_name }} &a, const {{ c.full_name }} &b);
+{% endmacro %}
+
+{% macro make_hash(c) %}
+template<>
+inline size_t hashValue(const {{ c.full_name }} &value)
+{
+    size_t seed = 0;
+    {% for it in c.annotated_base_classes %}
+    combineHash(seed, hashValue(static_cast<const {{ it.full_name }} &>(value)));
+    {% endfor %}
+    {% for mtc in c.hash_mtcs %}
+    combineHash(seed, hashValue({{ member_ref(mtc, 'value') }}));
+    {% endfor %}
+    {% for expr in c.hash_path_exprs %}
+    combineHash(seed, hashPathValue({{ expr | replace('$this', '(&value)') }}));
+    {% endfor %}
+    return seed;
+}
+
+template<>
+inline bool equalValue(const {{ c.full_name }} &a, const {{ c.full_name }} &b)
+{
+    {% for it in c.annotated_base_classes %}
+    if (!equalValue(static_cast<const {{ it.full_name }} &>(a), static_cast<const {{ it.full_name }} &>(b)))
+        return false;
+    {% endfor %}
+    {% for mtc in c.hash_mtcs %}
+    if (!equalValue({{ member_ref(mtc, 'a') }}, {{ member_ref(mtc, 'b') }}))
+        return false;
+    {% endfor %}
+    {% for expr in c.hash_path_exprs %}
+    if (!equalPathValue({{ expr | replace('$this', '(&a)') }}, {{ expr | replace('$this', '(&b)') }}))
+        return false;
+    {% endfor %}
+    return true;
+}
+{% endmacro %}
+
+{% macro make_hashes(env) %}
+{% for c in env.annotated_classes %}
+{{ make_hash_decl(c) }}
+{% endfor %}
+{% for c in env.annotated_classes %}
+{{ make_hash(c) }}
+{% endfor %}
+{% endmacro %}
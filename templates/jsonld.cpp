@@ -0,0 +1,50 @@
+{# The generated code is the one of the ntriples template, JsonLdRDFTraits.hpp
+   collects the statements into node objects instead of writing lines. #}
+{% import 'ntriples.cpp' as ntriples %}
+{% import 'schema.cpp' as schema %}
+{% import 'hash.cpp' as hash %}
+
+{# ---------------------------------------------------------------------------- #}
+{# Main #}
+
+{% macro main(env, include_files, include_file) %}
+/** This file was generated by ARVIDA C++ preprocessor **/
+{% for it in env.prolog %}
+{{ it }}
+{% endfor %}
+#include "JsonLdRDFTraits.hpp"
+#include "RDFHash.hpp"
+{% for it in env.includes %}
+#include {{it}}
+{% endfor %}
+namespace Arvida
+{
+namespace RDF
+{
+
+{% for c in env.annotated_classes %}
+{{ ntriples.make_pathOf(c)}}
+{% endfor %}
+
+{{ hash.make_hashes(env) }}
+
+{% for c in env.annotated_classes %}
+{{ schema.make_members(c) }}
+{% endfor %}
+
+{% for c in env.annotated_classes %}
+{{ ntriples.make_toRDF(c)}}
+{% endfor %}
+
+
+{% for c in env.annotated_classes %}
+{{ ntriples.make_fromRDF(c)}}
+{% endfor %}
+
+} // namespace Arvida
+} // namespace RDF
+{% for it in env.epilog %}
+{{ it }}
+{% endfor %}
+
+{% endmacro %}
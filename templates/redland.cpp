@@ -1,3 +1,6 @@
+{% import 'schema.cpp' as schema %}
+{% import 'hash.cpp' as hash %}
+
 {# Writer #}
 
 {% macro member_ref(mtc, arg='') %}
@@ -9,7 +12,7 @@ Redland::Node {{ value.var_name }} = Redland::Node::make_blank_node(ctx.world);
 {% endmacro %}
 
 {% macro make_writer_triple_statement(mtc, triple) %}
-ctx.model.add_statement(ctx.world, {{make_writer_node_expr(mtc=mtc, value=triple.subject)}}, {{make_writer_node_expr(mtc=mtc, value=triple.predicate)}}, {{make_writer_node_expr(mtc=mtc, value=triple.object)}});
+Arvida::RDF::addStatement(ctx, {{make_writer_node_expr(mtc=mtc, value=triple.subject)}}, {{make_writer_node_expr(mtc=mtc, value=triple.predicate)}}, {{make_writer_node_expr(mtc=mtc, value=triple.object)}});
 {% endmacro %}
 
 // Example: <({make_writer_<triple.subject.kind>_defs})(mtc=mtc, value=triple.subject)>
@@ -23,6 +26,8 @@ that_node
 element_node
 {%- elif value.is_prefixed_name() -%}
 Redland::Node::make_uri_node(ctx.world,  ctx.namespaces.expand({{ value.value }}))
+{%- elif value.is_iri_node() -%}
+Redland::Node::make_uri_node(ctx.world, {{ value.value }})
 {%- elif value.that_element_ref -%}
 element_node
 {%- elif value.is_blank_node() -%}
@@ -48,7 +53,7 @@ Arvida::RDF::createRDFNodeAndSerialize
 {% if mtc.member %}
 // Serialize member {{mtc.member.name}}
 {%endif-%}
-{
+{{ schema.write_condition(mtc) }}{
     {% if mtc.has_that_or_that_element_ref() %}
     const auto & _that = {{ member_ref(mtc) }};
     if (Arvida::RDF::isValidValue(_that))
@@ -68,6 +73,9 @@ Arvida::RDF::createRDFNodeAndSerialize
     {# End of triples #}
     {# Triples with only that element references  #}
     {% if mtc.has_that_element_ref() %}
+    {% if mtc.element_path_buffer %}
+    std::string {{ mtc.element_path_buffer }};
+    {% endif %}
     for (auto it = std::begin(_that); it != std::end(_that); ++it)
     {
         const auto & _element = *it;
@@ -130,6 +138,9 @@ inline NodeRef toRDF(const Context &ctx, NodeRef _this, const {{ c.full_name }}
     {% for it in c.annotated_base_classes %}
     {{ make_toRDF_call(it) }}
     {% endfor %}
+    {% if c.has_writer_members %}
+    const MemberMask mask = Arvida::RDF::projectionMask< {{ c.full_name }} >(ctx.projection);
+    {% endif %}
     {% for it in c.blanks.values() -%}
         {{ define_blank_node(it)|indent(4, True) }}
     {% endfor %}
@@ -156,7 +167,7 @@ toRDF(ctx, _this, static_cast<const {{ c.full_name }} &>(value));
 
 
 {% macro make_reader_triple_statement(mtc, triple) %}
-triple = ctx.model.find_statement(Redland::Statement(ctx.world, {{make_reader_node_expr(mtc=mtc, value=triple.subject)}}, {{make_reader_node_expr(mtc=mtc, value=triple.predicate)}}, {{make_reader_node_expr(mtc=mtc, value=triple.object)}}));
+triple = Arvida::RDF::find_triple_view(ctx, stream, {{make_reader_node_expr(mtc=mtc, value=triple.subject)}}, {{make_reader_node_expr(mtc=mtc, value=triple.predicate)}}, {{make_reader_node_expr(mtc=mtc, value=triple.object)}});
 if (!triple.is_valid())
     return false;
 {{post_reader_node_expr(mtc, triple, 'subject')}}
@@ -164,39 +175,39 @@ if (!triple.is_valid())
 {% endmacro %}
 
 {% macro make_reader_pre_element_triple_statement(mtc, triple) %}
-triples = ctx.model.find_statements(Redland::Statement(ctx.world, {{make_reader_node_expr(mtc=mtc, value=triple.subject)}}, {{make_reader_node_expr(mtc=mtc, value=triple.predicate)}}, {{make_reader_node_expr(mtc=mtc, value=triple.object)}}));
+triples = Arvida::RDF::find_triples(ctx, {{make_reader_node_expr(mtc=mtc, value=triple.subject)}}, {{make_reader_node_expr(mtc=mtc, value=triple.predicate)}}, {{make_reader_node_expr(mtc=mtc, value=triple.object)}});
 if (triples.empty())
     return false;
 typedef {{mtc.get_setter_value_type()}} _that_container_type;
 _that_container_type _that_value;
 for (auto it = std::begin(triples); it != std::end(triples); ++it)
 {
-     auto _element_node = it->get_{{ triple.that_element_position }}();
+     auto & _element_node = it->{{ triple.that_element_position }};
     _that_container_type::value_type _element{% if mtc.create_element %} = {{ mtc.create_element }}(ctx, _element_node){% endif %};
 {% endmacro %}
 
 {% macro make_reader_post_element_triple_statement(mtc, triple) %}
 {{post_reader_element_node_expr(mtc, triple, 'subject')}}
 {{post_reader_element_node_expr(mtc, triple, 'object')}}
-_that_value.push_back(_element);
+_that_value.push_back(std::move(_element));
 }
-{{member_ref(mtc, arg='_that_value')}};
+{{member_ref(mtc, arg='std::move(_that_value)')}};
 {% endmacro %}
 
 {% macro post_reader_element_node_expr(mtc, triple, position) %}
 {% set value = triple[position] -%}
 {% if value.is_this_ref() -%}
-_this = it->get_{{ position }}();
+_this = it->{{ position }};
 {%- elif value.is_that_ref() -%}
 {
     if (!Arvida::RDF::fromRDF(ctx, triple.{{ position }}, tmp_value))
         return false;
-    {{member_ref(mtc, arg='tmp_value')}};
+    {{member_ref(mtc, arg='std::move(tmp_value)')}};
 }
 {%- elif value.is_that_element_ref() -%}
 if (!Arvida::RDF::fromRDF(ctx, _element_node, _element))
     return false;
-{%- elif value.is_prefixed_name() -%}
+{%- elif value.is_prefixed_name() or value.is_iri_node() -%}
 {# Empty since it is a constant #}
 {%- elif value.is_blank_node() -%}
 {{ value.var_name }} = triple.{{ position }};
@@ -214,7 +225,7 @@ _this = triple.{{ position }};
     {{mtc.get_setter_value_type()}} tmp_value;
     if (!Arvida::RDF::fromRDF(ctx, triple.{{ position }}, tmp_value))
         return false;
-    {{member_ref(mtc, arg='tmp_value')}};
+    {{member_ref(mtc, arg='std::move(tmp_value)')}};
 }
 {%- elif value.is_that_element_ref() -%}
 // THAT_ELEMENT_REF
@@ -222,9 +233,9 @@ _this = triple.{{ position }};
     {{mtc.get_setter_value_type()}} tmp_value;
     if (!Arvida::RDF::fromRDF(ctx, triple.{{ position }}, tmp_value))
         return false;
-    {{member_ref(mtc, arg='tmp_value')}};
+    {{member_ref(mtc, arg='std::move(tmp_value)')}};
 }
-{%- elif value.is_prefixed_name() -%}
+{%- elif value.is_prefixed_name() or value.is_iri_node() -%}
 {# Empty since it is a constant #}
 {%- elif value.is_blank_node() -%}
 {{ value.var_name }} = triple.{{ position }};
@@ -243,6 +254,8 @@ Redland::Node()
 Redland::Node()
 {%- elif value.is_prefixed_name() -%}
 Redland::Node::make_uri_node(ctx.world, ctx.namespaces.expand({{ value.value }}))
+{%- elif value.is_iri_node() -%}
+Redland::Node::make_uri_node(ctx.world, {{ value.value }})
 {%- elif value.that_element_ref -%}
 Redland::Node()
 {%- elif value.is_blank_node() -%}
@@ -258,7 +271,7 @@ UNKNOWN EXPR
 {% if mtc.member %}
 // Deserialize member {{mtc.member.name}}
 {%endif-%}
-{
+{{ schema.read_condition(mtc) }}{
     {# Triples with only that reference or no that references #}
     {# Begin of member triples #}
     {% for it in mtc.member_triples -%}
@@ -285,15 +298,16 @@ UNKNOWN EXPR
 {% macro make_fromRDF(c) %}
 
 {% if c.use_visitor %}
-inline bool fromRDF_impl(const Context &ctx, const NodeRef _this0, {{ c.full_name }} &value)
+inline bool fromRDF_impl(const Context &ctx, const NodeRef _this0, {{ c.full_name }} &value, MemberMask mask = ~MemberMask(0))
 {% else %}
 template<>
-inline bool fromRDF(const Context &ctx, const NodeRef _this0, {{ c.full_name }} &value)
+inline bool fromRDF(const Context &ctx, const NodeRef _this0, {{ c.full_name }} &value, MemberMask mask)
 {% endif %}
 {
-    Arvida::RDF::Triple triple;
+    Redland::Stream stream;
+    Arvida::RDF::TripleView triple;
     {% if c.has_element_refs %}
-    std::vector<Redland::Statement> triples;
+    std::vector<Arvida::RDF::Triple> triples;
     {% endif %}
     Redland::Node _this = _this0;
 
@@ -314,6 +328,14 @@ inline bool fromRDF(const Context &ctx, const NodeRef _this0, {{ c.full_name }}
 
     return true;
 }
+{% if not c.use_visitor %}
+
+template<>
+inline bool fromRDF(const Context &ctx, const NodeRef _this0, {{ c.full_name }} &value)
+{
+    return fromRDF(ctx, _this0, value, ~MemberMask(0));
+}
+{% endif %}
 {% endmacro %}
 
 {% macro make_fromRDF_call(c) %}
@@ -333,6 +355,7 @@ fromRDF(ctx, _this, static_cast<{{ c.full_name }} &>(value));
 {{ it }}
 {% endfor %}
 #include "RedlandRDFTraits.hpp"
+#include "RDFHash.hpp"
 {% for it in env.includes %}
 #include {{it}}
 {% endfor %}
@@ -345,6 +368,12 @@ namespace RDF
 {{ make_pathOf(c)}}
 {% endfor %}
 
+{{ hash.make_hashes(env) }}
+
+{% for c in env.annotated_classes %}
+{{ schema.make_members(c) }}
+{% endfor %}
+
 {% for c in env.annotated_classes %}
 {{ make_toRDF(c)}}
 {% endfor %}
@@ -0,0 +1,245 @@
+{# Schema tables of RDFSchema.hpp. The sord and flat templates import the
+   macros for classes with use_schema (--schema-tables), used as a template
+   of its own only the tables are generated, as reflection data. #}
+
+{% macro member_ref(mtc, arg='') %}
+value.{{mtc.member.name}}{% if mtc.is_function() %}({{arg}}){% endif %}
+{% endmacro %}
+
+{% macro quoted_or_null(value) %}
+{% if value %}{{ value }}{% else %}nullptr{% endif %}
+{% endmacro %}
+
+{% macro make_node(value) %}
+{% if value.is_this_ref() -%}
+{ Arvida::RDF::SCHEMA_THIS, nullptr, 0 }
+{%- elif value.is_that_ref() -%}
+{ Arvida::RDF::SCHEMA_THAT, nullptr, 0 }
+{%- elif value.is_blank_node() -%}
+{ Arvida::RDF::SCHEMA_BLANK, "{{ value.label }}", {{ value.index }} }
+{%- elif value.is_prefixed_name() -%}
+{ Arvida::RDF::SCHEMA_PREFIXED_NAME, {{ value.value }}, 0 }
+{%- elif value.is_iri_node() -%}
+{ Arvida::RDF::SCHEMA_IRI, {{ value.value }}, 0 }
+{%- else -%}
+UNKNOWN EXPR
+{%- endif -%}
+{% endmacro %}
+
+{# --- Member ids (fromRDF with a member mask) --- #}
+
+{% macro make_members(c) %}
+template<>
+struct Members< {{ c.full_name }} >
+{
+    enum : MemberMask
+    {
+        {% for name in c.member_names %}
+        {{ name }} = MemberMask(1) << {{ loop.index0 }},
+        {% endfor %}
+        ALL_MEMBERS = ~MemberMask(0)
+    };
+};
+{% endmacro %}
+
+{# Members of the mask which require reading mtc, 0 when it is always read #}
+{% macro read_mask(mtc) %}
+{% set c = mtc.get_class() %}
+{% if mtc.read_mask_ids -%}
+{% for id in mtc.read_mask_ids %}Members< {{ c.full_name }} >::{{ c.member_names[id] }}{% if not loop.last %} | {% endif %}{% endfor %}
+{%- else -%}
+0
+{%- endif %}
+{% endmacro %}
+
+{# Condition of the reader statements of mtc #}
+{% macro read_condition(mtc) %}
+{% if mtc.read_mask_ids %}
+if (mask & ({{ read_mask(mtc) }}))
+{% endif %}
+{% endmacro %}
+
+{# Member of the mask which selects the writer statements of mtc, 0 when they
+   are always written #}
+{% macro write_mask(mtc) %}
+{% set c = mtc.get_class() %}
+{% if mtc.is_for_writer() and mtc.member_id is not none -%}
+Members< {{ c.full_name }} >::{{ c.member_names[mtc.member_id] }}
+{%- else -%}
+0
+{%- endif %}
+{% endmacro %}
+
+{# Condition of the writer statements of mtc #}
+{% macro write_condition(mtc) %}
+{% if mtc.is_for_writer() and mtc.member_id is not none %}
+if (mask & {{ write_mask(mtc) }})
+{% endif %}
+{% endmacro %}
+
+{# --- Tables --- #}
+
+{% macro make_schema(c) %}
+template<>
+struct Schema< {{ c.full_name }} >
+{
+    static const SchemaClass & get()
+    {
+        {% for mtc in c.mtcs %}
+        static constexpr SchemaTriple triples{{ loop.index0 }}[] = {
+            {% for it in mtc.member_triples %}
+            { {{ make_node(it.subject) }}, {{ make_node(it.predicate) }}, {{ make_node(it.object) }} },
+            {% endfor %}
+        };
+        {% endfor %}
+        static constexpr SchemaMember members[] = {
+            {% for mtc in c.mtcs %}
+            { {% if mtc.member %}"{{ mtc.member.name }}"{% else %}nullptr{% endif %}, SCHEMA_{{ mtc.path_type or 'NO_PATH' }}, {{ quoted_or_null(mtc.path) }}, triples{{ loop.index0 }}, {{ mtc.member_triples|length }}, {{ mtc.is_for_reader()|lower }}, {{ mtc.is_for_writer()|lower }}, {{ read_mask(mtc) }}, {{ write_mask(mtc) }} },
+            {% endfor %}
+        };
+        static constexpr SchemaClass schema = {
+            "{{ c.full_name }}", SCHEMA_{{ c.path_type }}, {{ quoted_or_null(c.path) }}, members, {{ c.mtcs|length }}, {{ c.blanks|length }}
+        };
+        return schema;
+    }
+};
+{% endmacro %}
+
+{# --- Skeletons (constant triples of classes with use_skeleton) --- #}
+
+{% macro make_skeleton(c) %}
+template<>
+struct Skeleton< {{ c.full_name }} >
+{
+    static const SchemaSkeleton & get()
+    {
+        static constexpr SchemaTriple triples[] = {
+            {% for it in c.skeleton_triples %}
+            { {{ make_node(it.subject) }}, {{ make_node(it.predicate) }}, {{ make_node(it.object) }} },
+            {% endfor %}
+        };
+        static constexpr SchemaSkeleton skeleton = {
+            "{{ c.full_name }}", triples, {{ c.skeleton_triples|length }}
+        };
+        return skeleton;
+    }
+};
+{% endmacro %}
+
+{% macro make_skeleton_call(c) %}
+// Constant triples
+{
+    {% if c.blanks %}
+    Node *const _blanks[] = { {% for it in c.blanks.values() %}&{{ it.var_name }}{% if not loop.last %}, {% endif %}{% endfor %} };
+    {% else %}
+    Node *const *_blanks = nullptr;
+    {% endif %}
+    Arvida::RDF::addSkeleton(ctx, Skeleton< {{ c.full_name }} >::get(), _this, _blanks);
+}
+{% endmacro %}
+
+{# --- Accessors --- #}
+
+{% macro make_writers(c) %}
+template<>
+struct SchemaWriters< {{ c.full_name }} >
+{
+    {% for mtc in c.mtcs %}
+    {% if mtc.is_for_writer() and mtc.has_that_ref() %}
+    static bool write{{ loop.index0 }}(const Context &ctx, const void *object, Node &that)
+    {
+        const {{ c.full_name }} &value = *static_cast<const {{ c.full_name }} *>(object);
+        const auto & _that = {{ member_ref(mtc) }};
+        typedef decltype(({{ member_ref(mtc) }})) _that_ref;
+        if (!Arvida::RDF::isValidValue(_that))
+            return false;
+        that = Arvida::RDF::createRDFNodeAndSerialize<_that_ref>(ctx, _that, Arvida::RDF::{{ mtc.path_type }}, {% if mtc.pp_path %}{{ mtc.pp_path }}{% else %}""{% endif %});
+        return true;
+    }
+
+    {% endif %}
+    {% endfor %}
+    static const SchemaWriter<Context, Node> * get()
+    {
+        static const SchemaWriter<Context, Node> writers[] = {
+            {% for mtc in c.mtcs %}
+            {% if mtc.is_for_writer() and mtc.has_that_ref() %}&write{{ loop.index0 }}{% else %}nullptr{% endif %},
+            {% endfor %}
+        };
+        return writers;
+    }
+};
+{% endmacro %}
+
+{% macro make_readers(c) %}
+template<>
+struct SchemaReaders< {{ c.full_name }} >
+{
+    {% for mtc in c.mtcs %}
+    {% if mtc.is_for_reader() and mtc.has_that_ref() %}
+    static bool read{{ loop.index0 }}(const Context &ctx, Node &that, void *object)
+    {
+        {{ c.full_name }} &value = *static_cast<{{ c.full_name }} *>(object);
+        {{ mtc.get_setter_value_type() }} tmp_value;
+        if (!Arvida::RDF::fromRDF(ctx, that, tmp_value))
+            return false;
+        {{ member_ref(mtc, arg='std::move(tmp_value)') }};
+        return true;
+    }
+
+    {% endif %}
+    {% endfor %}
+    static const SchemaReader<Context, Node> * get()
+    {
+        static const SchemaReader<Context, Node> readers[] = {
+            {% for mtc in c.mtcs %}
+            {% if mtc.is_for_reader() and mtc.has_that_ref() %}&read{{ loop.index0 }}{% else %}nullptr{% endif %},
+            {% endfor %}
+        };
+        return readers;
+    }
+};
+{% endmacro %}
+
+{# --- Function bodies --- #}
+
+{% macro make_toRDF_body(c) %}
+    return Arvida::RDF::toRDFSchema(ctx, _this, &value, Schema< {{ c.full_name }} >::get(), SchemaWriters< {{ c.full_name }} >::get(),
+                                    Arvida::RDF::projectionMask< {{ c.full_name }} >(ctx.projection));
+{% endmacro %}
+
+{% macro make_fromRDF_body(c) %}
+    return Arvida::RDF::fromRDFSchema(ctx, _this, &value, Schema< {{ c.full_name }} >::get(), SchemaReaders< {{ c.full_name }} >::get(), mask);
+{% endmacro %}
+
+{# ---------------------------------------------------------------------------- #}
+{# Main #}
+
+{% macro main(env, include_files, include_file) %}
+/** This file was generated by ARVIDA C++ preprocessor **/
+{% for it in env.prolog %}
+{{ it }}
+{% endfor %}
+#include "RDFSchema.hpp"
+{% for it in env.includes %}
+#include {{it}}
+{% endfor %}
+namespace Arvida
+{
+namespace RDF
+{
+
+{% for c in env.annotated_classes %}
+{% if c.mtcs and not c.has_element_refs %}
+{{ make_members(c) }}
+{{ make_schema(c) }}
+{% endif %}
+{% endfor %}
+
+} // namespace Arvida
+} // namespace RDF
+{% for it in env.epilog %}
+{{ it }}
+{% endfor %}
+
+{% endmacro %}
@@ -1,3 +1,6 @@
+{% import 'schema.cpp' as schema %}
+{% import 'hash.cpp' as hash %}
+
 {# Writer #}
 
 {% macro member_ref(mtc, arg='') %}
@@ -23,6 +26,8 @@ that_node
 element_node
 {%- elif value.is_prefixed_name() -%}
 Sord::Curie(ctx.model.world(), {{ value.value }})
+{%- elif value.is_iri_node() -%}
+Sord::URI(ctx.model.world(), {{ value.value }})
 {%- elif value.that_element_ref -%}
 element_node
 {%- elif value.is_blank_node() -%}
@@ -33,11 +38,11 @@ UNKNOWN EXPR
 {% endmacro %}
 
 
-{% macro create_rdf_node(dont_serialize_flag, ctx, value, member_path_type, member_path) %}
+{% macro create_rdf_node(dont_serialize_flag, ctx, value, member_path_type, member_path, value_ref='') %}
 {% if dont_serialize_flag %}
 Arvida::RDF::createRDFNode
 {%-else-%}
-Arvida::RDF::createRDFNodeAndSerialize
+Arvida::RDF::createRDFNodeAndSerialize{% if value_ref %}<{{ value_ref }}>{% endif %}
 {%-endif-%}
 ({{ctx}}, {{value}}, Arvida::RDF::{{ member_path_type }}, {%if member_path%}{{member_path}}{%else%}""{%endif%})
 {%-endmacro-%}
@@ -48,16 +53,17 @@ Arvida::RDF::createRDFNodeAndSerialize
 {% if mtc.member %}
 // Serialize member {{mtc.member.name}}
 {%endif-%}
-{
+{{ schema.write_condition(mtc) }}{
     {% if mtc.has_that_or_that_element_ref() %}
     const auto & _that = {{ member_ref(mtc) }};
+    typedef decltype(({{ member_ref(mtc) }})) _that_ref;
     if (Arvida::RDF::isValidValue(_that))
     {
     {%endif%}
     {# Triples with only that reference or no that references #}
     {% if mtc.has_that_ref() %}
     Sord::Node that_node({{ create_rdf_node(dont_serialize_flag=mtc.has_that_element_ref(), ctx="ctx", value="_that",
-                         member_path_type=mtc.path_type, member_path=mtc.pp_path) }});
+                         member_path_type=mtc.path_type, member_path=mtc.pp_path, value_ref="_that_ref") }});
     {%endif%}
     {# Begin of triples #}
     {% for it in mtc.triples %}
@@ -68,12 +74,16 @@ Arvida::RDF::createRDFNodeAndSerialize
     {# End of triples #}
     {# Triples with only that element references  #}
     {% if mtc.has_that_element_ref() %}
+    {% if mtc.element_path_buffer %}
+    std::string {{ mtc.element_path_buffer }};
+    {% endif %}
     for (auto it = std::begin(_that); it != std::end(_that); ++it)
     {
         const auto & _element = *it;
+        typedef Arvida::RDF::ElementRef<_that_ref, decltype((*it))> _element_ref;
 
         Node element_node({{ create_rdf_node(ctx="ctx", value="_element",
-                 member_path_type=mtc.element_path_type, member_path=mtc.pp_element_path)}});
+                 member_path_type=mtc.element_path_type, member_path=mtc.pp_element_path, value_ref="_element_ref")}});
 
     {# Begin of triples #}
     {% for it in mtc.triples %}
@@ -130,16 +140,28 @@ inline NodeRef toRDF(const Context &ctx, NodeRef _this, const {{ c.full_name }}
     {% for it in c.annotated_base_classes %}
     {{ make_toRDF_call(it) }}
     {% endfor %}
+    {% if c.use_schema %}
+{{ schema.make_toRDF_body(c) }}
+    {% else %}
+    {% if c.has_writer_members %}
+    const MemberMask mask = Arvida::RDF::projectionMask< {{ c.full_name }} >(ctx.projection);
+    {% endif %}
     {% for it in c.blanks.values() -%}
         {{ define_blank_node(it)|indent(4, True) }}
     {% endfor %}
+    {% if c.use_skeleton %}
+    {{ schema.make_skeleton_call(c)|indent(4) }}
+    {% endif %}
     {% for it in c.mtcs -%}
+      {% if not c.use_skeleton or it not in c.skeleton_mtcs -%}
        {{ make_writer_member_statements(it)|indent(4, True) }}
+      {% endif %}
     {% endfor %}
     {% for it in c.writer.defs %}{{ it }}{% endfor %}
     {% for it in c.writer.statements %}{{ it }}{% endfor %}
 
     return _this;
+    {% endif %}
 }
 {% endmacro %}
 
@@ -155,7 +177,7 @@ toRDF(ctx, _this, static_cast<const {{ c.full_name }} &>(value));
 {# Reader #}
 
 {% macro make_reader_triple_statement(mtc, triple) %}
-triple = Arvida::RDF::find_triple(ctx.model, {{make_reader_node_expr(mtc=mtc, value=triple.subject)}}, {{make_reader_node_expr(mtc=mtc, value=triple.predicate)}}, {{make_reader_node_expr(mtc=mtc, value=triple.object)}});
+triple = Arvida::RDF::find_triple_view(ctx.model, {{make_reader_node_expr(mtc=mtc, value=triple.subject)}}, {{make_reader_node_expr(mtc=mtc, value=triple.predicate)}}, {{make_reader_node_expr(mtc=mtc, value=triple.object)}});
 if (!triple.is_valid())
     return false;
 {{post_reader_node_expr(mtc, triple, 'subject')}}
@@ -177,9 +199,9 @@ for (auto it = std::begin(triples); it != std::end(triples); ++it)
 {% macro make_reader_post_element_triple_statement(mtc, triple) %}
 {{post_reader_element_node_expr(mtc, triple, 'subject')}}
 {{post_reader_element_node_expr(mtc, triple, 'object')}}
-_that_value.push_back(_element);
+_that_value.push_back(std::move(_element));
 }
-{{member_ref(mtc, arg='_that_value')}};
+{{member_ref(mtc, arg='std::move(_that_value)')}};
 {% endmacro %}
 
 {% macro post_reader_element_node_expr(mtc, triple, position) %}
@@ -190,12 +212,12 @@ _this = it->{{ position }};
 {
     if (!Arvida::RDF::fromRDF(ctx, triple.{{ position }}, tmp_value))
         return false;
-    {{member_ref(mtc, arg='tmp_value')}};
+    {{member_ref(mtc, arg='std::move(tmp_value)')}};
 }
 {%- elif value.is_that_element_ref() -%}
 if (!Arvida::RDF::fromRDF(ctx, _element_node, _element))
     return false;
-{%- elif value.is_prefixed_name() -%}
+{%- elif value.is_prefixed_name() or value.is_iri_node() -%}
 {# Empty since it is a constant #}
 {%- elif value.is_blank_node() -%}
 {{ value.var_name }} = triple.{{ position }};
@@ -213,7 +235,7 @@ _this = triple.{{ position }};
     {{mtc.get_setter_value_type()}} tmp_value;
     if (!Arvida::RDF::fromRDF(ctx, triple.{{ position }}, tmp_value))
         return false;
-    {{member_ref(mtc, arg='tmp_value')}};
+    {{member_ref(mtc, arg='std::move(tmp_value)')}};
 }
 {%- elif value.is_that_element_ref() -%}
 // THAT_ELEMENT_REF
@@ -221,9 +243,9 @@ _this = triple.{{ position }};
     {{mtc.get_setter_value_type()}} tmp_value;
     if (!Arvida::RDF::fromRDF(ctx, triple.{{ position }}, tmp_value))
         return false;
-    {{member_ref(mtc, arg='tmp_value')}};
+    {{member_ref(mtc, arg='std::move(tmp_value)')}};
 }
-{%- elif value.is_prefixed_name() -%}
+{%- elif value.is_prefixed_name() or value.is_iri_node() -%}
 {# Empty since it is a constant #}
 {%- elif value.is_blank_node() -%}
 {{ value.var_name }} = triple.{{ position }};
@@ -242,6 +264,8 @@ Sord::Node()
 Sord::Node()
 {%- elif value.is_prefixed_name() -%}
 Sord::Curie(ctx.model.world(), {{ value.value }})
+{%- elif value.is_iri_node() -%}
+Sord::URI(ctx.model.world(), {{ value.value }})
 {%- elif value.that_element_ref -%}
 Sord::Node()
 {%- elif value.is_blank_node() -%}
@@ -257,7 +281,7 @@ UNKNOWN EXPR
 {% if mtc.member %}
 // Deserialize member {{mtc.member.name}}
 {%endif-%}
-{
+{{ schema.read_condition(mtc) }}{
     {# Triples with only that reference or no that references #}
     {# Begin of member triples #}
     {% for it in mtc.member_triples -%}
@@ -284,13 +308,15 @@ UNKNOWN EXPR
 {% macro make_fromRDF(c) %}
 
 {% if c.use_visitor %}
-inline bool fromRDF_impl(const Context &ctx, const NodeRef _this0, {{ c.full_name }} &value)
+inline bool fromRDF_impl(const Context &ctx, const NodeRef _this0, {{ c.full_name }} &value, MemberMask mask = ~MemberMask(0))
 {% else %}
 template<>
-inline bool fromRDF(const Context &ctx, const NodeRef _this0, {{ c.full_name }} &value)
+inline bool fromRDF(const Context &ctx, const NodeRef _this0, {{ c.full_name }} &value, MemberMask mask)
 {% endif %}
 {
-    Arvida::RDF::Triple triple;
+    {% if not c.use_schema %}
+    Arvida::RDF::TripleView triple;
+    {% endif %}
     {% if c.has_element_refs %}
     std::vector<Arvida::RDF::Triple> triples;
     {% endif %}
@@ -299,6 +325,9 @@ inline bool fromRDF(const Context &ctx, const NodeRef _this0, {{ c.full_name }}
     {% for it in c.annotated_base_classes %}
     {{ make_fromRDF_call(it) }}
     {% endfor %}
+    {% if c.use_schema %}
+{{ schema.make_fromRDF_body(c) }}
+    {% else %}
 
     {% for it in c.blanks.values() %}
     Sord::Node {{ it.var_name }};
@@ -312,7 +341,16 @@ inline bool fromRDF(const Context &ctx, const NodeRef _this0, {{ c.full_name }}
     {% for it in c.reader.statements %}{{ it }}{% endfor %}
 
     return true;
+    {% endif %}
 }
+{% if not c.use_visitor %}
+
+template<>
+inline bool fromRDF(const Context &ctx, const NodeRef _this0, {{ c.full_name }} &value)
+{
+    return fromRDF(ctx, _this0, value, ~MemberMask(0));
+}
+{% endif %}
 {% endmacro %}
 
 {% macro make_fromRDF_call(c) %}
@@ -332,6 +370,7 @@ fromRDF(ctx, _this, static_cast<{{ c.full_name }} &>(value));
 {{ it }}
 {% endfor %}
 #include "SordRDFTraits.hpp"
+#include "RDFHash.hpp"
 {% for it in env.includes %}
 #include {{it}}
 {% endfor %}
@@ -344,12 +383,28 @@ namespace RDF
 {{ make_pathOf(c)}}
 {% endfor %}
 
+{{ hash.make_hashes(env) }}
+
+{% for c in env.annotated_classes %}
+{{ schema.make_members(c) }}
+{% endfor %}
+
 {% for c in env.annotated_classes %}
+{% if c.use_schema %}
+{{ schema.make_schema(c) }}
+{{ schema.make_writers(c) }}
+{% endif %}
+{% if c.use_skeleton %}
+{{ schema.make_skeleton(c) }}
+{% endif %}
 {{ make_toRDF(c)}}
 {% endfor %}
 
 
 {% for c in env.annotated_classes %}
+{% if c.use_schema %}
+{{ schema.make_readers(c) }}
+{% endif %}
 {{ make_fromRDF(c)}}
 {% endfor %}
 
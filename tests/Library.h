@@ -0,0 +1,78 @@
+/*  ARVIDAPP - ARVIDA C++ Preprocessor
+ *
+ *  Copyright (C) 2015-2019 German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef ARVIDA_TEST_LIBRARY_H_INCLUDED
+#define ARVIDA_TEST_LIBRARY_H_INCLUDED
+
+#include "arvida_pp_annotation.h"
+#include "RDFLazy.hpp"
+#include <string>
+
+arvida_global_annotation(
+    arvida_include("Library.h"),
+    arvida_prefix("rdf", "http://www.w3.org/1999/02/22-rdf-syntax-ns#"),
+    arvida_prefix("lib", "http://example.com/library#")
+)
+
+// Types with a Lazy member and a float member, only the sord and flat
+// templates read them
+
+class
+RdfStmt($this, "rdf:type", "lib:Book")
+Book
+{
+public:
+    Book() : rating_(0) { }
+
+    RdfStmt($this, "lib:title", $that)
+    const std::string & getTitle() const { return title_; }
+    RdfStmt($this, "lib:title", $that)
+    void setTitle(const std::string &t) { title_ = t; }
+
+    RdfStmt($this, "lib:rating", $that)
+    float getRating() const { return rating_; }
+    RdfStmt($this, "lib:rating", $that)
+    void setRating(float r) { rating_ = r; }
+
+private:
+    std::string title_;
+    float rating_;
+};
+
+class
+RdfStmt($this, "rdf:type", "lib:Shelf")
+Shelf
+{
+public:
+    RdfStmt($this, "lib:label", $that)
+    const std::string & getLabel() const { return label_; }
+    RdfStmt($this, "lib:label", $that)
+    void setLabel(const std::string &l) { label_ = l; }
+
+    RdfPath("/book")
+    RdfStmt($this, "lib:book", $that)
+    const Arvida::RDF::Lazy<Book> & getBook() const { return book_; }
+    RdfPath("/book")
+    RdfStmt($this, "lib:book", $that)
+    void setBook(const Arvida::RDF::Lazy<Book> &b) { book_ = b; }
+
+private:
+    std::string label_;
+    Arvida::RDF::Lazy<Book> book_;
+};
+
+#endif
@@ -0,0 +1,155 @@
+/*  ARVIDAPP - ARVIDA C++ Preprocessor
+ *
+ *  Copyright (C) 2015-2019 German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef ARVIDA_TEST_SCENE_H_INCLUDED
+#define ARVIDA_TEST_SCENE_H_INCLUDED
+
+#include "arvida_pp_annotation.h"
+#include <string>
+#include <vector>
+#include <memory>
+
+arvida_global_annotation(
+    arvida_include("Scene.h"),
+    arvida_prefix("rdf", "http://www.w3.org/1999/02/22-rdf-syntax-ns#"),
+    arvida_prefix("scene", "http://example.com/scene#")
+)
+
+// Types of the tests. Item, Group and Tag are written and read, SceneNode with
+// its chain of nested objects is only written (the generated readers need
+// all members, so a finite chain cannot be read).
+
+class
+RdfStmt($this, "rdf:type", "scene:Item")
+Item
+{
+public:
+    Item() : weight_(0) { }
+
+    Item(const std::string &name, double weight) : name_(name), weight_(weight) { }
+
+    RdfStmt($this, "scene:name", $that)
+    const std::string & getName() const { return name_; }
+    RdfStmt($this, "scene:name", $that)
+    void setName(const std::string &n) { name_ = n; }
+
+    RdfStmt($this, "scene:weight", $that)
+    double getWeight() const { return weight_; }
+    RdfStmt($this, "scene:weight", $that)
+    void setWeight(double w) { weight_ = w; }
+
+private:
+    std::string name_;
+    double weight_;
+};
+
+typedef std::vector<std::shared_ptr<Item> > Items;
+
+// Creates the elements of Group::setItems
+template <class Context, class Node>
+inline std::shared_ptr<Item> createItem(const Context &, const Node &)
+{
+    return std::make_shared<Item>();
+}
+
+class
+RdfStmt($this, "rdf:type", "scene:Group")
+Group
+{
+public:
+    RdfStmt($this, "scene:name", $that)
+    const std::string & getName() const { return name_; }
+    RdfStmt($this, "scene:name", $that)
+    void setName(const std::string &n) { name_ = n; }
+
+    RdfElementPath("{$element->getName()}")
+    RdfStmt($this, "scene:item", $that.foreach)
+    const Items & getItems() const { return items_; }
+    RdfStmt($this, "scene:item", $that.foreach)
+    RdfCreateElement(createItem)
+    void setItems(const Items &items) { items_ = items; }
+
+private:
+    std::string name_;
+    Items items_;
+};
+
+// The id is not written as a statement, it only determines the IRI
+class
+RdfPath("tag/{$this->getId()}")
+RdfStmt($this, "rdf:type", "scene:Tag")
+Tag
+{
+public:
+    Tag() : id_(0) { }
+
+    Tag(int id, const std::string &label) : id_(id), label_(label) { }
+
+    int getId() const { return id_; }
+
+    RdfStmt($this, "scene:label", $that)
+    const std::string & getLabel() const { return label_; }
+    RdfStmt($this, "scene:label", $that)
+    void setLabel(const std::string &l) { label_ = l; }
+
+private:
+    int id_;
+    std::string label_;
+};
+
+class SceneNode;
+typedef std::vector<std::shared_ptr<SceneNode> > SceneNodes;
+typedef std::shared_ptr<SceneNode> SceneNodePtr;
+
+class
+RdfStmt($this, "rdf:type", "scene:Node")
+SceneNode
+{
+public:
+    SceneNode() : weight_(0) { }
+
+    RdfStmt($this, "scene:name", $that)
+    const std::string & getName() const { return name_; }
+    RdfStmt($this, "scene:name", $that)
+    void setName(const std::string &n) { name_ = n; }
+
+    RdfStmt($this, "scene:weight", $that)
+    double getWeight() const { return weight_; }
+    RdfStmt($this, "scene:weight", $that)
+    void setWeight(double w) { weight_ = w; }
+
+    RdfPath("/next")
+    RdfStmt($this, "scene:next", $that)
+    const SceneNodePtr & getNext() const { return next_; }
+    RdfPath("/next")
+    RdfStmt($this, "scene:next", $that)
+    void setNext(const SceneNodePtr &n) { next_ = n; }
+
+    RdfElementPath("{$element->getName()}")
+    RdfStmt($this, "scene:child", $that.foreach)
+    const SceneNodes & getChildren() const { return children_; }
+    RdfStmt($this, "scene:child", $that.foreach)
+    void setChildren(const SceneNodes &c) { children_ = c; }
+
+private:
+    std::string name_;
+    double weight_;
+    SceneNodePtr next_;
+    SceneNodes children_;
+};
+
+#endif
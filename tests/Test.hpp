@@ -0,0 +1,59 @@
+/*  ARVIDAPP - ARVIDA C++ Preprocessor
+ *
+ *  Copyright (C) 2015-2019 German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef ARVIDA_TEST_HPP_INCLUDED
+#define ARVIDA_TEST_HPP_INCLUDED
+
+#include <iostream>
+
+// Minimal checks for the tests, main() returns TEST_RESULT()
+
+namespace ArvidaTest
+{
+
+inline int & failures()
+{
+    static int count = 0;
+    return count;
+}
+
+} // namespace ArvidaTest
+
+#define CHECK(cond)                                                     \
+    do {                                                                \
+        if (!(cond))                                                    \
+        {                                                               \
+            std::cerr << __FILE__ << ":" << __LINE__                    \
+                      << ": check failed: " #cond << std::endl;         \
+            ++ArvidaTest::failures();                                   \
+        }                                                               \
+    } while (0)
+
+#define CHECK_EQUAL(a, b)                                               \
+    do {                                                                \
+        if (!((a) == (b)))                                              \
+        {                                                               \
+            std::cerr << __FILE__ << ":" << __LINE__                    \
+                      << ": check failed: " #a " == " #b                \
+                      << " (" << (a) << " != " << (b) << ")" << std::endl; \
+            ++ArvidaTest::failures();                                   \
+        }                                                               \
+    } while (0)
+
+#define TEST_RESULT() (ArvidaTest::failures() == 0 ? 0 : 1)
+
+#endif
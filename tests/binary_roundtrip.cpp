@@ -0,0 +1,200 @@
+/*  ARVIDAPP - ARVIDA C++ Preprocessor
+ *
+ *  Copyright (C) 2015-2019 German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+// Binary RDF writer and reader: varints, round trip, streaming, truncated
+// and invalid input, size and parse time compared with N-Triples
+
+#include "Test.hpp"
+#include "Scene_binary.hpp"
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+using namespace Arvida::RDF;
+
+static const std::string PATH = "http://example.com/scene/g";
+
+static Group makeGroup(int count)
+{
+    Group group;
+    group.setName("group \"quoted\" \\ with\ttab\nand line break");
+    Items items;
+    for (int i = 0; i < count; ++i)
+    {
+        char name[32];
+        std::snprintf(name, sizeof(name), "item-%d", i);
+        items.push_back(std::make_shared<Item>(name, i * 0.25 - 3e10 * (i % 2)));
+    }
+    group.setItems(items);
+    return group;
+}
+
+// Average time of fn in microseconds
+template <class F>
+static double measure(int runs, F fn)
+{
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int i = 0; i < runs; ++i)
+        fn();
+    const std::chrono::duration<double, std::micro> time = std::chrono::steady_clock::now() - start;
+    return time.count() / runs;
+}
+
+static VarintStatus varint(const std::string &data, uint64_t &value, size_t &used)
+{
+    const char *p = data.data();
+    const VarintStatus status = readVarint(p, data.data() + data.size(), value);
+    used = p - data.data();
+    return status;
+}
+
+int main()
+{
+    // Varints
+    {
+        const uint64_t values[] = { 0, 1, 0x7F, 0x80, 0x3FFF, 0x4000, 0xFFFFFFFFULL, ~0ULL >> 1, ~0ULL };
+        const size_t sizes[] = { 1, 1, 1, 2, 2, 3, 5, 9, 10 };
+        for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); ++i)
+        {
+            std::string data;
+            appendVarint(data, values[i]);
+            CHECK_EQUAL(data.size(), sizes[i]);
+            uint64_t value;
+            size_t used;
+            CHECK(varint(data, value, used) == VARINT_OK);
+            CHECK(value == values[i]);
+            CHECK_EQUAL(used, data.size());
+            CHECK(varint(data.substr(0, data.size() - 1), value, used) == VARINT_INCOMPLETE);
+        }
+
+        // More than 64 bits
+        uint64_t value;
+        size_t used;
+        CHECK(varint(std::string(10, '\xFF') + '\1', value, used) == VARINT_OVERFLOW);
+        CHECK(varint(std::string(9, '\xFF') + '\2', value, used) == VARINT_OVERFLOW);
+        CHECK_EQUAL(used, 10u);
+        CHECK(varint(std::string(20, '\x80'), value, used) == VARINT_OVERFLOW);
+        CHECK_EQUAL(used, 10u);
+    }
+
+    const Group group = makeGroup(50);
+    Prefixes prefixes;
+    prefixes["rdf"] = "http://www.w3.org/1999/02/22-rdf-syntax-ns#";
+    prefixes["scene"] = "http://example.com/scene#";
+    Document doc(prefixes);
+    writeBinaryRDF(doc, PATH, group);
+    doc.end();
+
+    // Round trip
+    BinaryRDFGraph graph;
+    CHECK(graph.parse(doc.out));
+    {
+        Vocabulary vocabulary;
+        Group read;
+        CHECK(readBinaryRDF(graph, vocabulary, PATH, read));
+        CHECK(equalValue(group, read));
+    }
+
+    // Size and parse time compared with the N-Triples of the same statements
+    {
+        std::string ntriples;
+        const std::vector<TripleView> triples = graph.graph().find_triples(TermView(), TermView(), TermView());
+        for (size_t i = 0; i < triples.size(); ++i)
+        {
+            ntriples.append(triples[i].subject.data, triples[i].subject.size);
+            ntriples += ' ';
+            ntriples.append(triples[i].predicate.data, triples[i].predicate.size);
+            ntriples += ' ';
+            ntriples.append(triples[i].object.data, triples[i].object.size);
+            ntriples += " .\n";
+        }
+        std::printf("%u triples: %u bytes binary, %u bytes N-Triples\n", static_cast<unsigned>(triples.size()),
+                    static_cast<unsigned>(doc.out.size()), static_cast<unsigned>(ntriples.size()));
+        CHECK(doc.out.size() * 2 < ntriples.size());
+
+        const int runs = 200;
+        size_t parsed = 0;
+        const double writeTime = measure(runs, [&]() {
+            Document document(prefixes);
+            writeBinaryRDF(document, PATH, group);
+            document.end();
+            parsed += document.out.size();
+        });
+        const double binaryTime = measure(runs, [&]() {
+            BinaryRDFGraph binary;
+            binary.parse(doc.out);
+            parsed += binary.graph().size();
+        });
+        const double ntriplesTime = measure(runs, [&]() {
+            Graph text;
+            text.parse(ntriples);
+            parsed += text.size();
+        });
+        std::printf("per document: write binary %.1f us, parse binary %.1f us, parse N-Triples %.1f us\n",
+                    writeTime, binaryTime, ntriplesTime);
+        CHECK(parsed > 0);
+    }
+
+    // Streaming: byte by byte, two documents in one stream
+    {
+        const std::string stream = doc.out + doc.out;
+        BinaryRDFReader reader;
+        BinaryTermRef triple[3];
+        size_t triples = 0;
+        size_t documents = 0;
+        for (size_t i = 0; i < stream.size(); ++i)
+        {
+            reader.feed(stream.data() + i, 1);
+            BinaryRDFReader::Status status;
+            while ((status = reader.next(triple)) == BinaryRDFReader::TRIPLE)
+                ++triples;
+            if (status == BinaryRDFReader::END_OF_DOCUMENT)
+                ++documents;
+            CHECK(status != BinaryRDFReader::ERROR);
+        }
+        CHECK_EQUAL(documents, 2u);
+        CHECK_EQUAL(triples, 2 * graph.graph().size());
+        CHECK(reader.empty());
+    }
+
+    // Truncated input is read up to the last complete triple
+    for (size_t size = 0; size < doc.out.size(); ++size)
+    {
+        BinaryRDFGraph truncated;
+        CHECK(truncated.parse(doc.out.data(), size));
+        CHECK(truncated.graph().size() <= graph.graph().size());
+        if (size < doc.out.size() - 1)
+        {
+            Vocabulary vocabulary;
+            Group read;
+            CHECK(!readBinaryRDF(truncated, vocabulary, PATH, read) || !equalValue(group, read));
+        }
+    }
+
+    // Invalid input
+    {
+        const std::string header = doc.out.substr(0, 5);
+        BinaryRDFGraph invalid;
+        CHECK(!invalid.parse("ARVIDA?"));
+        CHECK(!invalid.parse(header + std::string(11, '\xFF')));
+        CHECK(!invalid.error().empty());
+        CHECK(!invalid.parse(header + "\x05"));
+        CHECK(!invalid.parse(header + "\x01\x7F"));
+    }
+
+    return TEST_RESULT();
+}
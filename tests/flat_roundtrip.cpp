@@ -0,0 +1,142 @@
+/*  ARVIDAPP - ARVIDA C++ Preprocessor
+ *
+ *  Copyright (C) 2015-2019 German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+// Flat triple store: round trip, queries between appends, missing and
+// invalid statements
+
+#include "Test.hpp"
+#include "Scene_flat.hpp"
+#include <string>
+
+using namespace Arvida::RDF;
+
+static const std::string BASE = "http://example.com/scene/";
+static const std::string NAME = "http://example.com/scene#name";
+static const std::string WEIGHT = "http://example.com/scene#weight";
+
+static Group makeGroup()
+{
+    Group group;
+    group.setName("group \"quoted\" \\ with\ttab\nand line break");
+    Items items;
+    items.push_back(std::make_shared<Item>("plain", 0.1));
+    items.push_back(std::make_shared<Item>("unicode-\xc3\xa9", -2.5));
+    items.push_back(std::make_shared<Item>("large", 3e10));
+    group.setItems(items);
+    return group;
+}
+
+static bool readGroup(Flat::Model &model, Group &group)
+{
+    Context ctx(model, BASE);
+    Node node = model.uri(BASE);
+    return fromRDF(ctx, node, group);
+}
+
+// Copies the statements of source except those with predicate
+static void copyWithout(const Flat::Model &source, Flat::Model &target, const std::string &predicate)
+{
+    TermTriples triples = toTermTriples(source);
+    for (size_t i = 0; i < triples.size(); ++i)
+    {
+        if (triples[i].predicate.value != predicate)
+            target.add_statement(target.intern(triples[i].subject), target.intern(triples[i].predicate), target.intern(triples[i].object));
+    }
+}
+
+int main()
+{
+    const Group group = makeGroup();
+
+    WorldModel wm(BASE);
+    {
+        Context ctx(wm.model, BASE);
+        Node node = wm.model.uri(BASE);
+        toRDF(ctx, node, group);
+    }
+    const size_t size = wm.model.size();
+    CHECK(size > 0);
+
+    // Round trip
+    {
+        Group read;
+        CHECK(readGroup(wm.model, read));
+        CHECK(equalValue(group, read));
+    }
+
+    // Writing again adds no duplicates
+    {
+        Context ctx(wm.model, BASE);
+        Node node = wm.model.uri(BASE);
+        toRDF(ctx, node, group);
+        CHECK_EQUAL(wm.model.size(), size);
+    }
+
+    // Statements appended after a query are found by the next one
+    {
+        const Node subject = wm.model.uri(BASE + "extra");
+        const Node predicate = wm.model.uri(NAME);
+        CHECK(wm.model.find_triples(subject, Node(), Node()).empty());
+        CHECK(wm.model.add_statement(subject, predicate, wm.model.literal("x")));
+        CHECK(!wm.model.add_statement(subject, predicate, wm.model.literal("x")));
+        CHECK(wm.model.add_statement(subject, predicate, wm.model.literal("y")));
+        CHECK_EQUAL(wm.model.find_triples(subject, Node(), Node()).size(), 2u);
+        CHECK_EQUAL(wm.model.find_triples(Node(), Node(), wm.model.literal("y")).size(), 1u);
+        CHECK_EQUAL(wm.model.size(), size + 2);
+    }
+
+    // Term triples and N-Triples of the model
+    {
+        Flat::Model copy(BASE);
+        addTermTriples(copy, toTermTriples(wm.model));
+        CHECK_EQUAL(copy.size(), wm.model.size());
+        CHECK_EQUAL(toNTriples(copy), toNTriples(wm.model));
+        Group read;
+        CHECK(readGroup(copy, read));
+        CHECK(equalValue(group, read));
+    }
+
+    // Missing statements fail to read
+    {
+        Flat::Model empty(BASE);
+        Group read;
+        CHECK(!readGroup(empty, read));
+
+        Flat::Model noName(BASE);
+        copyWithout(wm.model, noName, NAME);
+        CHECK(!readGroup(noName, read));
+    }
+
+    // Literals which are no numbers fail to read
+    {
+        Flat::Model invalid(BASE);
+        copyWithout(wm.model, invalid, WEIGHT);
+        TermTriples triples = toTermTriples(wm.model);
+        for (size_t i = 0; i < triples.size(); ++i)
+        {
+            if (triples[i].predicate.value == WEIGHT && triples[i].subject.value != BASE + "plain")
+                invalid.add_statement(invalid.intern(triples[i].subject), invalid.intern(triples[i].predicate), invalid.intern(triples[i].object));
+        }
+        const Node item = invalid.uri(BASE + "plain");
+        CHECK(!invalid.find_triples(item, Node(), Node()).empty());
+        invalid.add_statement(item, invalid.uri(WEIGHT), invalid.literal("heavy", "http://www.w3.org/2001/XMLSchema#double"));
+        Group read;
+        CHECK(!readGroup(invalid, read));
+    }
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,80 @@
+/*  ARVIDAPP - ARVIDA C++ Preprocessor
+ *
+ *  Copyright (C) 2015-2019 German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+// Generated structural hash and equality: members and path substitutions
+
+#include "Test.hpp"
+#include "Scene_ntriples.hpp"
+#include <string>
+#include <unordered_map>
+
+using namespace Arvida::RDF;
+
+static std::string path(const Tag &tag)
+{
+    Document doc;
+    const std::string base = "http://example.com/scene/";
+    Context ctx(doc, base);
+    return pathOf(ctx, tag);
+}
+
+int main()
+{
+    // Members written by toRDF
+    {
+        Group a;
+        a.setName("g");
+        Items items;
+        items.push_back(std::make_shared<Item>("i", 1.5));
+        a.setItems(items);
+
+        Group b;
+        b.setName("g");
+        Items copies;
+        copies.push_back(std::make_shared<Item>("i", 1.5));
+        b.setItems(copies);
+        CHECK(equalValue(a, b));
+        CHECK_EQUAL(hashValue(a), hashValue(b));
+
+        copies[0]->setWeight(2.5);
+        CHECK(!equalValue(a, b));
+        CHECK(hashValue(a) != hashValue(b));
+    }
+
+    // The id is only part of the path, tags with different ids are written
+    // as different nodes and are not equal
+    {
+        const Tag a(1, "label");
+        const Tag b(1, "label");
+        const Tag c(2, "label");
+        CHECK_EQUAL(path(a), "tag/1");
+        CHECK_EQUAL(path(c), "tag/2");
+        CHECK(equalValue(a, b));
+        CHECK_EQUAL(hashValue(a), hashValue(b));
+        CHECK(!equalValue(a, c));
+        CHECK(hashValue(a) != hashValue(c));
+
+        std::unordered_map<Tag, int, ValueHash<Tag>, ValueEqual<Tag> > counts;
+        ++counts[a];
+        ++counts[b];
+        ++counts[c];
+        CHECK_EQUAL(counts.size(), 2u);
+        CHECK_EQUAL(counts[Tag(1, "label")], 2);
+    }
+
+    return TEST_RESULT();
+}
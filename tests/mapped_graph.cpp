@@ -0,0 +1,141 @@
+/*  ARVIDAPP - ARVIDA C++ Preprocessor
+ *
+ *  Copyright (C) 2015-2019 German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+// Mapped graph snapshots: round trip, queries and corrupt files
+
+#include "Test.hpp"
+#include "Scene_ntriples.hpp"
+#include "RDFMappedGraph.hpp"
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+using namespace Arvida::RDF;
+
+static const std::string PATH = "http://example.com/scene/g";
+
+static std::string readFile(const std::string &fileName)
+{
+    std::ifstream file(fileName.c_str(), std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+static void writeFile(const std::string &fileName, const std::string &data)
+{
+    std::ofstream file(fileName.c_str(), std::ios::binary | std::ios::trunc);
+    file.write(data.data(), data.size());
+}
+
+template <class T>
+static void patch(std::string &data, uint64_t offset, T value)
+{
+    std::memcpy(&data[offset], &value, sizeof(value));
+}
+
+// Writes data to fileName and returns the error of opening it
+static std::string openError(const std::string &fileName, const std::string &data)
+{
+    writeFile(fileName, data);
+    MappedGraph graph;
+    const bool opened = graph.open(fileName);
+    return opened ? std::string() : graph.error();
+}
+
+int main()
+{
+    const std::string fileName = "mapped_graph_test.snapshot";
+
+    Group group;
+    group.setName("group");
+    Items items;
+    items.push_back(std::make_shared<Item>("a", 1.5));
+    items.push_back(std::make_shared<Item>("b", -2));
+    group.setItems(items);
+
+    Document doc;
+    writeNTriples(doc, PATH, group);
+    Graph parsed;
+    CHECK(parsed.parse(doc.out));
+    CHECK(writeMappedGraph(fileName, parsed.triples()));
+
+    // Round trip and queries
+    {
+        MappedGraph graph(fileName);
+        CHECK(graph.is_open());
+        CHECK_EQUAL(graph.size(), parsed.size());
+        Vocabulary vocabulary;
+        Group read;
+        CHECK(readNTriples(graph, vocabulary, PATH, read));
+        CHECK(equalValue(group, read));
+
+        const std::string name = "<http://example.com/scene#name>";
+        const std::string a = "<http://example.com/scene/g/a>";
+        const std::string unknown = "<http://unknown>";
+        CHECK_EQUAL(graph.find_triples(TermView(), TermView(name), TermView()).size(), 3u);
+        CHECK_EQUAL(graph.find_triples(TermView(), TermView(), TermView(a)).size(), 1u);
+        CHECK(!graph.find_triple(TermView(unknown), TermView(), TermView()).is_valid());
+    }
+
+    // Corrupt files are rejected
+    const std::string data = readFile(fileName);
+    MappedGraphHeader header;
+    std::memcpy(&header, data.data(), sizeof(header));
+    CHECK(header.terms > 2 && header.triples > 0);
+    {
+        CHECK_EQUAL(openError(fileName, data), "");
+
+        std::string corrupt = data;
+        corrupt[0] = 'X';
+        CHECK_EQUAL(openError(fileName, corrupt), "invalid magic");
+
+        CHECK_EQUAL(openError(fileName, data.substr(0, data.size() - 8)), "invalid header");
+        CHECK_EQUAL(openError(fileName, data.substr(0, sizeof(header) - 1)), "invalid file size");
+
+        corrupt = data;
+        patch(corrupt, offsetof(MappedGraphHeader, triples), ~static_cast<uint64_t>(0) / 4);
+        CHECK_EQUAL(openError(fileName, corrupt), "invalid header");
+
+        corrupt = data;
+        patch(corrupt, offsetof(MappedGraphHeader, offsets), static_cast<uint64_t>(data.size()));
+        CHECK_EQUAL(openError(fileName, corrupt), "invalid header");
+
+        // Offsets decrease
+        corrupt = data;
+        patch(corrupt, header.offsets + 2 * 8, static_cast<uint64_t>(1) << 62);
+        CHECK_EQUAL(openError(fileName, corrupt), "invalid term offset");
+
+        // Last offset is past the term data
+        corrupt = data;
+        patch(corrupt, header.offsets + header.terms * 8, static_cast<uint64_t>(data.size()));
+        CHECK_EQUAL(openError(fileName, corrupt), "invalid term data");
+
+        // Term id in each index is out of range
+        for (int i = 0; i < 3; ++i)
+        {
+            corrupt = data;
+            patch(corrupt, header.index[i] + 4 * (3 * header.triples - 1), static_cast<uint32_t>(header.terms));
+            CHECK_EQUAL(openError(fileName, corrupt), "invalid term id in index");
+        }
+
+        corrupt = data;
+        patch(corrupt, offsetof(MappedGraphHeader, index) + 8, static_cast<uint64_t>(data.size() - 4));
+        CHECK_EQUAL(openError(fileName, corrupt), "invalid index");
+    }
+
+    std::remove(fileName.c_str());
+    return TEST_RESULT();
+}
@@ -0,0 +1,280 @@
+/*  ARVIDAPP - ARVIDA C++ Preprocessor
+ *
+ *  Copyright (C) 2015-2019 German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+// N-Triples writer and parser: round trip, escapes and syntax errors
+
+#include "Test.hpp"
+#include "Scene_ntriples.hpp"
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Arvida::RDF;
+
+static const std::string PATH = "http://example.com/scene/g";
+
+static Group makeGroup()
+{
+    Group group;
+    group.setName("group \"quoted\" \\ with\ttab\nand line break");
+    Items items;
+    items.push_back(std::make_shared<Item>("plain", 0.1));
+    items.push_back(std::make_shared<Item>("unicode-\xc3\xa9", -2.5));
+    items.push_back(std::make_shared<Item>("large", 3e10));
+    group.setItems(items);
+    return group;
+}
+
+// Graph which counts the lookups of the generated readers
+class CountingSource : public TripleSource
+{
+public:
+    explicit CountingSource(const TripleSource &graph) : graph_(graph), lookups(0) { }
+
+    virtual TripleView find_triple(const TermView &subject, const TermView &predicate, const TermView &object) const
+    {
+        ++lookups;
+        return graph_.find_triple(subject, predicate, object);
+    }
+
+    virtual std::vector<TripleView> find_triples(const TermView &subject, const TermView &predicate, const TermView &object) const
+    {
+        ++lookups;
+        return graph_.find_triples(subject, predicate, object);
+    }
+
+private:
+    const TripleSource &graph_;
+
+public:
+    mutable int lookups;
+};
+
+// Writes group with the projection, graph references out
+static bool writeProjected(const Group &group, const Projection &projection, Graph &graph, std::string &out)
+{
+    Document doc;
+    Context ctx(doc, PATH);
+    ctx.projection = &projection;
+    Node thisNode(uriNode(PATH));
+    doc.insertNode(thisNode);
+    toRDF(ctx, thisNode, group);
+    out = doc.out;
+    return graph.parse(out);
+}
+
+static bool parseFails(const std::string &document, size_t line)
+{
+    Graph graph;
+    const bool failed = !graph.parse(document) && !graph.error().empty() && graph.size() == 0;
+    CHECK_EQUAL(graph.errorLine(), line);
+    return failed;
+}
+
+int main()
+{
+    const Group group = makeGroup();
+
+    Document doc;
+    writeNTriples(doc, PATH, group);
+
+    // Round trip
+    {
+        Graph graph;
+        CHECK(graph.parse(doc.out));
+        Vocabulary vocabulary;
+        Group read;
+        CHECK(readNTriples(graph, vocabulary, PATH, read));
+        CHECK(equalValue(group, read));
+    }
+
+    // The order of the statements does not matter
+    {
+        std::vector<std::string> lines;
+        size_t start = 0;
+        while (start < doc.out.size())
+        {
+            const size_t end = doc.out.find('\n', start);
+            lines.push_back(doc.out.substr(start, end - start));
+            start = end + 1;
+        }
+        std::reverse(lines.begin(), lines.end());
+        std::string reversed = "# comment\n\n";
+        for (size_t i = 0; i < lines.size(); ++i)
+            reversed += "  " + lines[i] + " \t\r\n";
+
+        Graph graph;
+        CHECK(graph.parse(reversed));
+        Vocabulary vocabulary;
+        Group read;
+        CHECK(readNTriples(graph, vocabulary, PATH, read));
+        CHECK_EQUAL(read.getName(), group.getName());
+        // Items are read in the order of their statements
+        Items items = read.getItems();
+        std::reverse(items.begin(), items.end());
+        CHECK(equalValue(items, group.getItems()));
+    }
+
+    // Terms are compared with their escape sequences resolved
+    {
+        const std::string document =
+            "<http://example.com/scene/\\u0067> <http://www.w3.org/1999/02/22-rdf-syntax-ns#type> <http://example.com/scene#Group> .\n"
+            "<http://example.com/scene/g> <http://example.com/scene\\u0023name> \"\\u0041\\u00E9\\\"\\U0001F600\" .\n"
+            "<http://example.com/scene/g> <http://example.com/scene#item> <http://example.com/scene/g/i> .\n"
+            "<http://example.com/scene/g/i> <http://www.w3.org/1999/02/22-rdf-syntax-ns#type> <http://example.com/scene#Item> .\n"
+            "<http://example.com/scene/g/i> <http://example.com/scene#name> \"i\" .\n"
+            "<http://example.com/scene/g/i> <http://example.com/scene#weight> \"1.5\"^^<http://www.w3.org/2001/XMLSchema\\u0023double> .\n";
+        Graph graph;
+        CHECK(graph.parse(document));
+        Vocabulary vocabulary;
+        Group read;
+        CHECK(readNTriples(graph, vocabulary, PATH, read));
+        CHECK_EQUAL(read.getName(), "A\xc3\xa9\"\xf0\x9f\x98\x80");
+        CHECK_EQUAL(read.getItems().size(), 1u);
+        CHECK(read.getItems().size() == 1 && read.getItems()[0]->getWeight() == 1.5);
+        CHECK(graph.find_triple(TermView(std::string("<http://example.com/scene/g>")), TermView(), TermView()).is_valid());
+    }
+
+    // A member mask skips the lookups of the other members, so they need not
+    // be in the graph
+    {
+        const std::string document =
+            "<http://example.com/scene/i> <http://www.w3.org/1999/02/22-rdf-syntax-ns#type> <http://example.com/scene#Item> .\n"
+            "<http://example.com/scene/i> <http://example.com/scene#name> \"i\" .\n";
+        Graph graph;
+        CHECK(graph.parse(document));
+        CountingSource source(graph);
+        Vocabulary vocabulary;
+        const std::string path = "http://example.com/scene/i";
+        const std::string node = "<" + path + ">";
+        ReadContext ctx(source, vocabulary, path);
+
+        Item full;
+        CHECK(!fromRDF(ctx, TermView(node), full));
+        const int fullLookups = source.lookups;
+        CHECK_EQUAL(fullLookups, 3);
+
+        source.lookups = 0;
+        Item named;
+        named.setWeight(4);
+        CHECK(fromRDF(ctx, TermView(node), named, Members<Item>::setName));
+        CHECK_EQUAL(named.getName(), "i");
+        CHECK_EQUAL(named.getWeight(), 4);
+        CHECK_EQUAL(source.lookups, 2);
+
+        // Class triples are checked with an empty mask too
+        source.lookups = 0;
+        Item none;
+        CHECK(fromRDF(ctx, TermView(node), none, MemberMask(0)));
+        CHECK_EQUAL(source.lookups, 1);
+        const std::string other = "<http://example.com/scene/o>";
+        CHECK(!fromRDF(ctx, TermView(other), none, MemberMask(0)));
+    }
+
+    // A cut projection references nested objects by their URI, a member mask
+    // leaves out the other members
+    {
+        const std::string item = "<http://example.com/scene#item>";
+        const std::string weight = "<http://example.com/scene#weight>";
+        const std::string name = "<http://example.com/scene#name>";
+        std::string out[3];
+        Graph graph;
+        CHECK(writeProjected(group, Projection(0), graph, out[0]));
+        const std::vector<TripleView> references = graph.find_triples(TermView(), TermView(item), TermView());
+        CHECK_EQUAL(references.size(), 3u);
+        for (size_t i = 0; i < references.size(); ++i)
+        {
+            CHECK(references[i].object.is_uri());
+            CHECK(!graph.find_triple(references[i].object, TermView(), TermView()).is_valid());
+        }
+        CHECK_EQUAL(graph.find_triples(TermView(), TermView(name), TermView()).size(), 1u);
+
+        Graph nested;
+        CHECK(writeProjected(group, Projection(1), nested, out[1]));
+        CHECK_EQUAL(nested.find_triples(TermView(), TermView(weight), TermView()).size(), 3u);
+        const std::vector<TripleView> nestedReferences = nested.find_triples(TermView(), TermView(item), TermView());
+        CHECK(nestedReferences.size() == 3 && nestedReferences[0].object == references[0].object);
+
+        Graph masked;
+        CHECK(writeProjected(group, Projection().members<Item>(Members<Item>::getName), masked, out[2]));
+        CHECK(!masked.find_triple(TermView(), TermView(weight), TermView()).is_valid());
+        CHECK_EQUAL(masked.find_triples(TermView(), TermView(name), TermView()).size(), 4u);
+    }
+
+    // Numbers followed by other characters are rejected
+    {
+        const std::string valid = "\"2.5 \"^^<http://www.w3.org/2001/XMLSchema#double>";
+        const std::string garbage = "\"1.5abc\"^^<http://www.w3.org/2001/XMLSchema#double>";
+        const std::string blank = "\" \"^^<http://www.w3.org/2001/XMLSchema#float>";
+        double d = 0;
+        float f = 0;
+        CHECK(parseFloating(TermView(valid), d) && d == 2.5);
+        CHECK(!parseFloating(TermView(garbage), d));
+        CHECK(!parseFloating(TermView(blank), f));
+    }
+
+    // Lookups by object use the index built by parse(), several threads
+    // read one const graph
+    {
+        std::string document;
+        for (int i = 0; i < 200; ++i)
+            document += "<http://example.com/s" + std::to_string(i) + "> <http://example.com/p> <http://example.com/o" +
+                std::to_string(i % 10) + "> .\n";
+        Graph parsed;
+        CHECK(parsed.parse(document));
+        const Graph &graph = parsed;
+        const std::string object = "<http://example.com/o3>";
+        const std::string predicate = "<http://example.com/p>";
+        std::vector<size_t> counts(4, 0);
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < counts.size(); ++t)
+        {
+            threads.emplace_back([&graph, &object, &predicate, &counts, t]() {
+                for (int i = 0; i < 100; ++i)
+                    counts[t] += graph.find_triples(TermView(), TermView(predicate), TermView(object)).size();
+            });
+        }
+        for (size_t t = 0; t < threads.size(); ++t)
+            threads[t].join();
+        for (size_t t = 0; t < counts.size(); ++t)
+            CHECK_EQUAL(counts[t], 2000u);
+        CHECK(graph.find_triple(TermView(), TermView(), TermView(object)).is_valid());
+        const std::string missing = "<http://example.com/o10>";
+        CHECK(!graph.find_triple(TermView(), TermView(), TermView(missing)).is_valid());
+    }
+
+    // Syntax errors
+    CHECK(parseFails("<http://a> <http://b> \"x\"\n", 1));
+    CHECK(parseFails("<http://a> <http://b> <http://c> .\n\"x\" <http://b> <http://c> .\n", 2));
+    CHECK(parseFails("<http://a> _:b <http://c> .\n", 1));
+    CHECK(parseFails("<http://a> <http://b> \"unterminated .\n", 1));
+    CHECK(parseFails("<http://a> <http://b> <http://c .\n", 1));
+    CHECK(parseFails("<http://a> <http://b> <http://c> . <http://d>\n", 1));
+
+    // Missing statements fail to read
+    {
+        const std::string document = doc.out.substr(0, doc.out.find('\n') + 1);
+        Graph graph;
+        CHECK(graph.parse(document));
+        Vocabulary vocabulary;
+        Group read;
+        CHECK(!readNTriples(graph, vocabulary, PATH, read));
+    }
+
+    return TEST_RESULT();
+}
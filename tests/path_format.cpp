@@ -0,0 +1,101 @@
+/*  ARVIDAPP - ARVIDA C++ Preprocessor
+ *
+ *  Copyright (C) 2015-2019 German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+// Path templates: formatting of substituted values and their round trip,
+// and reuse of a caller buffer
+
+#include "Test.hpp"
+#include "RDFPath.hpp"
+#include <climits>
+#include <cstdlib>
+#include <string>
+
+using namespace Arvida::RDF;
+
+template <class T>
+static std::string format(const T &value)
+{
+    return PathFormatter(5).literal("item/").value(value).str();
+}
+
+// Value substituted into "item/{...}"
+static std::string valueOf(const std::string &path)
+{
+    return path.substr(5);
+}
+
+int main()
+{
+    // Integers
+    CHECK_EQUAL(format(42), "item/42");
+    CHECK_EQUAL(format(-7L), "item/-7");
+    CHECK_EQUAL(format(LLONG_MIN), "item/-9223372036854775808");
+    CHECK_EQUAL(format(ULLONG_MAX), "item/18446744073709551615");
+    CHECK_EQUAL(format(static_cast<unsigned short>(65535)), "item/65535");
+    CHECK_EQUAL(std::strtoll(valueOf(format(LLONG_MIN)).c_str(), 0, 10), LLONG_MIN);
+    CHECK_EQUAL(std::strtoull(valueOf(format(ULLONG_MAX)).c_str(), 0, 10), ULLONG_MAX);
+
+    // Floating point numbers with the shortest precision which reads back
+    CHECK_EQUAL(format(1.5), "item/1.5");
+    CHECK_EQUAL(format(-0.25f), "item/-0.25");
+    CHECK_EQUAL(format(0.1), "item/0.1");
+    CHECK_EQUAL(format(0.1f), "item/0.1");
+    CHECK_EQUAL(format(2e30), "item/2e+30");
+    CHECK_EQUAL(format(100.0), "item/100");
+    const double values[] = { 0.0, 1.5, -3.25, 1e-5, 6.02214e23, 123456.0,
+                              1234567.0, 1234568.0, 0.1 + 0.2, 1.0 / 3, 123456789.125, -2.5e-300 };
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); ++i)
+        CHECK_EQUAL(std::strtod(valueOf(format(values[i])).c_str(), 0), values[i]);
+    const float floats[] = { 0.75f, 1234567.0f, 1234568.0f, 16777215.0f, 1.0f / 3 };
+    for (size_t i = 0; i < sizeof(floats) / sizeof(floats[0]); ++i)
+        CHECK_EQUAL(static_cast<float>(std::strtod(valueOf(format(floats[i])).c_str(), 0)), floats[i]);
+
+    // Values which differ after 6 digits give different paths
+    CHECK(format(1234567.0) != format(1234568.0));
+    CHECK(format(1234567.0f) != format(1234568.0f));
+    CHECK(format(0.1 + 0.2) != format(0.3));
+
+    // Characters and bool
+    CHECK_EQUAL(format('x'), "item/x");
+    CHECK_EQUAL(format(static_cast<signed char>('y')), "item/y");
+    CHECK_EQUAL(format(static_cast<unsigned char>('z')), "item/z");
+    CHECK_EQUAL(format(true), "item/1");
+    CHECK_EQUAL(format(false), "item/0");
+
+    // Strings and segments are joined with one '/'
+    CHECK_EQUAL(format(std::string("a/b")), "item/a/b");
+    CHECK_EQUAL(format("/c"), "item/c");
+    CHECK_EQUAL(format(std::string()), "item/");
+    CHECK_EQUAL(PathFormatter(0).value(3).literal("/x").value("y").str(), "3/x/y");
+
+    // The buffer is cleared and reused
+    {
+        std::string buffer = "previous content";
+        const std::string &path = PathFormatter(buffer, 5).literal("item/").value(12).path();
+        CHECK(&path == &buffer);
+        CHECK_EQUAL(buffer, "item/12");
+        const char *data = buffer.data();
+        for (int i = 0; i < 100; ++i)
+        {
+            PathFormatter(buffer, 5).literal("item/").value(i).value('c');
+            CHECK_EQUAL(buffer, "item/" + std::to_string(i) + "/c");
+        }
+        CHECK(buffer.data() == data);
+    }
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,250 @@
+/*  ARVIDAPP - ARVIDA C++ Preprocessor
+ *
+ *  Copyright (C) 2015-2019 German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+// Bounded queue and serialization pipeline with concurrent producers and
+// workers, drop policies and statistics. Checks run on the main thread after
+// the threads were joined.
+
+#include "Test.hpp"
+#include "RDFPipeline.hpp"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace Arvida::RDF;
+
+static const int PRODUCERS = 4;
+static const int ITEMS = 10000;
+
+// Values processed by the sinks of a pipeline
+struct Collector
+{
+    std::mutex mutex;
+    std::vector<int> values;
+    std::atomic<bool> open;
+
+    Collector() : open(true) { }
+
+    SerializationPipeline<int>::SinkFactory factory()
+    {
+        return [this]() {
+            return SerializationPipeline<int>::Sink([this](const int &value) {
+                while (!open.load())
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                if (value < 0)
+                    throw std::runtime_error("failed");
+                std::lock_guard<std::mutex> lock(mutex);
+                values.push_back(value);
+            });
+        };
+    }
+
+    bool contains(int value)
+    {
+        return std::find(values.begin(), values.end(), value) != values.end();
+    }
+};
+
+static void produce(SerializationPipeline<int> &pipeline)
+{
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; ++p)
+    {
+        producers.emplace_back([&pipeline, p]() {
+            for (int i = 0; i < ITEMS; ++i)
+                pipeline.submit(p * ITEMS + i);
+        });
+    }
+    for (size_t i = 0; i < producers.size(); ++i)
+        producers[i].join();
+}
+
+int main()
+{
+    // Every value is popped exactly once, values of one producer in order
+    {
+        BoundedQueue<int> queue(5);
+        CHECK_EQUAL(queue.capacity(), 8u);
+
+        std::atomic<int> done(0);
+        std::vector<std::vector<int> > popped(PRODUCERS);
+        std::vector<std::thread> threads;
+        for (int p = 0; p < PRODUCERS; ++p)
+        {
+            threads.emplace_back([&queue, &done, p]() {
+                for (int i = 0; i < ITEMS; ++i)
+                {
+                    while (!queue.try_push(p * ITEMS + i))
+                        std::this_thread::yield();
+                }
+                ++done;
+            });
+            threads.emplace_back([&queue, &done, &popped, p]() {
+                int value;
+                for (;;)
+                {
+                    if (queue.try_pop(value))
+                        popped[p].push_back(value);
+                    else if (done.load() == PRODUCERS)
+                    {
+                        if (!queue.try_pop(value))
+                            break;
+                        popped[p].push_back(value);
+                    }
+                    else
+                        std::this_thread::yield();
+                }
+            });
+        }
+        for (size_t i = 0; i < threads.size(); ++i)
+            threads[i].join();
+
+        std::vector<int> all;
+        bool ordered = true;
+        for (int c = 0; c < PRODUCERS; ++c)
+        {
+            std::vector<int> last(PRODUCERS, -1);
+            for (size_t i = 0; i < popped[c].size(); ++i)
+            {
+                const int value = popped[c][i];
+                ordered = ordered && value > last[value / ITEMS];
+                last[value / ITEMS] = value;
+            }
+            all.insert(all.end(), popped[c].begin(), popped[c].end());
+        }
+        CHECK(ordered);
+        std::sort(all.begin(), all.end());
+        CHECK_EQUAL(all.size(), static_cast<size_t>(PRODUCERS * ITEMS));
+        bool exact = true;
+        for (size_t i = 0; i < all.size(); ++i)
+            exact = exact && all[i] == static_cast<int>(i);
+        CHECK(exact);
+        CHECK_EQUAL(queue.size(), 0u);
+    }
+
+    // BLOCK processes every submitted value with several workers
+    {
+        Collector collector;
+        SerializationPipeline<int> pipeline(collector.factory(), 16, BLOCK, 3);
+        produce(pipeline);
+        pipeline.flush();
+        const PipelineStats stats = pipeline.stats();
+        CHECK_EQUAL(stats.submitted, static_cast<size_t>(PRODUCERS * ITEMS));
+        CHECK_EQUAL(stats.processed, stats.submitted);
+        CHECK_EQUAL(stats.dropped, 0u);
+        CHECK_EQUAL(stats.failed, 0u);
+        pipeline.stop();
+        std::sort(collector.values.begin(), collector.values.end());
+        CHECK_EQUAL(collector.values.size(), stats.submitted);
+        CHECK(std::unique(collector.values.begin(), collector.values.end()) == collector.values.end());
+    }
+
+    // DROP_NEWEST rejects values while the queue is full
+    {
+        Collector collector;
+        collector.open = false;
+        SerializationPipeline<int> pipeline(collector.factory(), 4, DROP_NEWEST);
+        int accepted = 0;
+        for (int i = 0; i < 20; ++i)
+            accepted += pipeline.submit(i) ? 1 : 0;
+        CHECK(accepted <= 5);
+        CHECK(pipeline.congested());
+        collector.open = true;
+        pipeline.flush();
+        const PipelineStats stats = pipeline.stats();
+        CHECK_EQUAL(stats.submitted, 20u);
+        CHECK_EQUAL(stats.dropped, static_cast<size_t>(20 - accepted));
+        CHECK_EQUAL(stats.processed, static_cast<size_t>(accepted));
+        CHECK(collector.contains(0));
+    }
+
+    // DROP_OLDEST keeps the newest values
+    {
+        Collector collector;
+        collector.open = false;
+        SerializationPipeline<int> pipeline(collector.factory(), 4, DROP_OLDEST);
+        for (int i = 0; i < 20; ++i)
+            CHECK(pipeline.submit(i));
+        collector.open = true;
+        pipeline.flush();
+        const PipelineStats stats = pipeline.stats();
+        CHECK_EQUAL(stats.submitted, 20u);
+        CHECK_EQUAL(stats.processed + stats.dropped, 20u);
+        CHECK(stats.dropped >= 15u);
+        for (int i = 16; i < 20; ++i)
+            CHECK(collector.contains(i));
+    }
+
+    // Failing sinks are counted, stop() processes the queued values
+    {
+        Collector collector;
+        collector.open = false;
+        SerializationPipeline<int> pipeline(collector.factory(), 64, BLOCK, 2);
+        for (int i = 0; i < 40; ++i)
+            pipeline.submit(i % 4 == 0 ? -1 : i);
+        collector.open = true;
+        pipeline.stop();
+        const PipelineStats stats = pipeline.stats();
+        CHECK_EQUAL(stats.failed, 10u);
+        CHECK_EQUAL(stats.processed, 30u);
+        CHECK_EQUAL(stats.depth, 0u);
+        CHECK_EQUAL(collector.values.size(), 30u);
+    }
+
+    // A stopped pipeline rejects snapshots, also when the queue is full
+    {
+        Collector collector;
+        SerializationPipeline<int> pipeline(collector.factory(), 2, BLOCK);
+        CHECK(pipeline.submit(1));
+        pipeline.flush();
+        pipeline.stop();
+        CHECK(!pipeline.running());
+        for (int i = 0; i < 10; ++i)
+            CHECK(!pipeline.submit(i));
+        pipeline.flush();
+        const PipelineStats stats = pipeline.stats();
+        CHECK_EQUAL(stats.submitted, 1u);
+        CHECK_EQUAL(stats.processed, 1u);
+    }
+
+    // A failing sink factory stops the workers which were already started
+    {
+        Collector collector;
+        std::atomic<int> created(0);
+        SerializationPipeline<int>::SinkFactory factory = [&collector, &created]() {
+            if (++created == 3)
+                throw std::runtime_error("no sink");
+            return collector.factory()();
+        };
+        bool thrown = false;
+        try
+        {
+            SerializationPipeline<int> pipeline(factory, 4, BLOCK, 4);
+        }
+        catch (const std::runtime_error &)
+        {
+            thrown = true;
+        }
+        CHECK(thrown);
+        CHECK_EQUAL(created.load(), 3);
+    }
+
+    return TEST_RESULT();
+}
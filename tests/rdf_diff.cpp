@@ -0,0 +1,119 @@
+/*  ARVIDAPP - ARVIDA C++ Preprocessor
+ *
+ *  Copyright (C) 2015-2019 German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+// Patches between graphs: blank nodes matched by structure, delete/add
+// rows and the transaction framing of RDF Patch
+
+#include "Test.hpp"
+#include "RDFDiff.hpp"
+#include <string>
+
+using namespace Arvida::RDF;
+
+static const std::string BASE = "http://example.com/scene/";
+static const std::string SCENE = "http://example.com/scene#";
+static const std::string XSD_DOUBLE = "http://www.w3.org/2001/XMLSchema#double";
+
+// Item with a weight value held by a blank node, as written by the
+// generated code
+static void addItem(TermTriples &triples, const std::string &name, const std::string &blank, const std::string &weight)
+{
+    const Term item = Term::uri(BASE + name);
+    const Term value = Term::blank(blank);
+    triples.push_back(TermTriple(item, Term::uri(SCENE + "name"), Term::literal(name)));
+    triples.push_back(TermTriple(item, Term::uri(SCENE + "weight"), value));
+    triples.push_back(TermTriple(value, Term::uri(SCENE + "value"), Term::literal(weight, XSD_DOUBLE)));
+    triples.push_back(TermTriple(value, Term::uri(SCENE + "unit"), Term::uri(SCENE + "kg")));
+}
+
+static std::string row(const char *op, const TermTriple &triple)
+{
+    std::string result = op;
+    result += " ";
+    appendNTriplesTriple(result, triple);
+    return result;
+}
+
+int main()
+{
+    // Graphs which differ only in their blank node labels are equal
+    {
+        TermTriples from, to;
+        addItem(from, "a", "b1", "1.5");
+        addItem(from, "b", "b2", "2");
+        addItem(to, "b", "genid7", "2");
+        addItem(to, "a", "genid12", "1.5");
+        const Patch patch = diff(from, to);
+        CHECK(patch.empty());
+        CHECK_EQUAL(patch.to_string(), "");
+    }
+
+    // Changed and removed triples are deleted, new ones added
+    {
+        TermTriples from, to;
+        addItem(from, "a", "b1", "1.5");
+        addItem(from, "b", "b2", "2");
+        addItem(to, "a", "x", "2.5");
+        const TermTriple added(Term::uri(BASE + "c"), Term::uri(SCENE + "name"), Term::literal("c"));
+        to.push_back(added);
+        const Patch patch = diff(from, to);
+        CHECK_EQUAL(patch.deletes.size(), 5u);
+        CHECK_EQUAL(patch.adds.size(), 2u);
+
+        // The blank node of a keeps its label, only its value changes
+        const std::string text = patch.to_string();
+        std::string rows[2];
+        for (size_t i = 0; i < patch.adds.size(); ++i)
+        {
+            CHECK(text.find(row("A", patch.adds[i])) != std::string::npos);
+            if (patch.adds[i].object.is_literal())
+                rows[patch.adds[i].subject.is_blank() ? 0 : 1] = patch.adds[i].object.value;
+        }
+        CHECK_EQUAL(rows[0], "2.5");
+        CHECK_EQUAL(rows[1], "c");
+        bool deletedA = false;
+        for (size_t i = 0; i < patch.deletes.size(); ++i)
+        {
+            CHECK(text.find(row("D", patch.deletes[i])) != std::string::npos);
+            deletedA = deletedA || patch.deletes[i].object.value == "1.5";
+            CHECK(patch.deletes[i].subject.value != BASE + "a");
+        }
+        CHECK(deletedA);
+
+        // One transaction, deletes before adds
+        CHECK_EQUAL(text.compare(0, 5, "TX .\n"), 0);
+        CHECK(text.size() > 5 && text.compare(text.size() - 5, 5, "TC .\n") == 0);
+        CHECK(text.rfind("\nD ") < text.find("\nA "));
+        size_t lines = 0;
+        for (size_t i = 0; i < text.size(); ++i)
+            lines += text[i] == '\n' ? 1 : 0;
+        CHECK_EQUAL(lines, patch.deletes.size() + patch.adds.size() + 2);
+    }
+
+    // Duplicate triples are written once
+    {
+        TermTriples from, to;
+        const TermTriple triple(Term::uri(BASE + "a"), Term::uri(SCENE + "name"), Term::literal("a"));
+        to.push_back(triple);
+        to.push_back(triple);
+        const Patch patch = diff(from, to);
+        CHECK_EQUAL(patch.adds.size(), 1u);
+        CHECK_EQUAL(patch.to_string(), "TX .\n" + row("A", triple) + "TC .\n");
+    }
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,153 @@
+/*  ARVIDAPP - ARVIDA C++ Preprocessor
+ *
+ *  Copyright (C) 2015-2019 German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+// Bulk loading into Redland models. Transactions are checked in a sqlite
+// storage, that part is skipped when Redland was built without it.
+
+#include "Test.hpp"
+#include "Scene_redland.hpp"
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+
+using namespace Arvida::RDF;
+
+static const std::string BASE = "http://example.com/scene/";
+
+static Group group(const std::string &name)
+{
+    Group result;
+    result.setName(name);
+    Items items;
+    items.push_back(std::make_shared<Item>("x", 1.5));
+    result.setItems(items);
+    return result;
+}
+
+int main()
+{
+    // The hashes storage has no transactions, statements are added directly
+    {
+        WorldModel wm;
+        wm.namespaces.add_prefix("rdf", "http://www.w3.org/1999/02/22-rdf-syntax-ns#");
+        wm.namespaces.add_prefix("scene", "http://example.com/scene#");
+        const std::string path = "group";
+        {
+            Batch batch(wm.world, wm.model);
+            CHECK(!batch.in_transaction());
+            Context ctx(wm.world, wm.namespaces, wm.model, BASE, path);
+            ctx.batch = &batch;
+            Redland::Node node(wm.world, BASE + "a");
+            toRDF(ctx, node, group("a"));
+            CHECK(!batch.commit());
+        }
+        CHECK(wm.model.size() > 0);
+        Context ctx(wm.world, wm.namespaces, wm.model, BASE, path);
+        Redland::Node node(wm.world, BASE + "a");
+        Group read;
+        CHECK(fromRDF(ctx, node, read));
+        CHECK_EQUAL(read.getName(), "a");
+    }
+
+    Redland::World world;
+    Redland::Namespaces namespaces;
+    namespaces.add_prefix("rdf", "http://www.w3.org/1999/02/22-rdf-syntax-ns#");
+    namespaces.add_prefix("scene", "http://example.com/scene#");
+
+    const std::string file = "/tmp/arvida_redland_batch_" + std::to_string(getpid()) + ".db";
+    std::unique_ptr<Redland::Storage> storage;
+    try
+    {
+        storage.reset(new Redland::Storage(world, "sqlite", file.c_str(), "new='yes'"));
+    }
+    catch (const Redland::Exception &)
+    {
+        std::cout << "sqlite storage not available, skipped" << std::endl;
+        return TEST_RESULT();
+    }
+
+    {
+        Redland::Model model(world, *storage, "");
+        const std::string path = "group";
+
+        // Committed statements are in the model
+        {
+            Batch batch(world, model);
+            CHECK(batch.in_transaction());
+            Context ctx(world, namespaces, model, BASE, path);
+            ctx.batch = &batch;
+            Redland::Node node(world, BASE + "a");
+            toRDF(ctx, node, group("a"));
+            CHECK(batch.commit());
+            CHECK(!batch.in_transaction());
+        }
+        const int size = model.size();
+        CHECK(size > 0);
+        {
+            Context ctx(world, namespaces, model, BASE, path);
+            Redland::Node node(world, BASE + "a");
+            Group read;
+            CHECK(fromRDF(ctx, node, read));
+            CHECK_EQUAL(read.getName(), "a");
+            CHECK_EQUAL(read.getItems().size(), 1u);
+        }
+
+        // The destructor commits
+        {
+            Batch batch(world, model);
+            Context ctx(world, namespaces, model, BASE, path);
+            ctx.batch = &batch;
+            Redland::Node node(world, BASE + "b");
+            toRDF(ctx, node, group("b"));
+        }
+        const int size2 = model.size();
+        CHECK(size2 > size);
+
+        // Rolled back statements are not
+        {
+            Batch batch(world, model);
+            Context ctx(world, namespaces, model, BASE, path);
+            ctx.batch = &batch;
+            Redland::Node node(world, BASE + "c");
+            toRDF(ctx, node, group("c"));
+            CHECK(batch.rollback());
+        }
+        CHECK_EQUAL(model.size(), size2);
+
+        // An exception rolls back
+        try
+        {
+            Batch batch(world, model);
+            Context ctx(world, namespaces, model, BASE, path);
+            ctx.batch = &batch;
+            Redland::Node node(world, BASE + "d");
+            toRDF(ctx, node, group("d"));
+            throw std::runtime_error("failed");
+        }
+        catch (const std::runtime_error &)
+        {
+        }
+        CHECK_EQUAL(model.size(), size2);
+    }
+
+    storage.reset();
+    std::remove(file.c_str());
+    return TEST_RESULT();
+}
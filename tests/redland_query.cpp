@@ -0,0 +1,128 @@
+/*  ARVIDAPP - ARVIDA C++ Preprocessor
+ *
+ *  Copyright (C) 2015-2019 German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+// Streamed queries of the Redland wrapper and the generated Redland readers
+// which use them, time of a lookup with and without copying the statement
+
+#include "Test.hpp"
+#include "Scene_redland.hpp"
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+using namespace Arvida::RDF;
+
+static const std::string BASE = "http://example.com/scene/";
+static const std::string NAME = "http://example.com/scene#name";
+static const std::string WEIGHT = "http://example.com/scene#weight";
+
+// Average time of fn in microseconds
+template <class F>
+static double measure(int runs, F fn)
+{
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int i = 0; i < runs; ++i)
+        fn();
+    const std::chrono::duration<double, std::micro> time = std::chrono::steady_clock::now() - start;
+    return time.count() / runs;
+}
+
+int main()
+{
+    Redland::World world;
+    Redland::Namespaces namespaces;
+    namespaces.add_prefix("rdf", "http://www.w3.org/1999/02/22-rdf-syntax-ns#");
+    namespaces.add_prefix("scene", "http://example.com/scene#");
+    Redland::Storage storage = Redland::Storage::make_memory_hashes(world, "test");
+    Redland::Model model(world, storage, "");
+    const std::string path = "group";
+    Context ctx(world, namespaces, model, BASE, path);
+
+    // Patterns match without a copy of the statements
+    const std::string a = BASE + "a";
+    const std::string b = BASE + "b";
+    Redland::Node nodeA(world, a);
+    Redland::Node nodeB(world, b);
+    Redland::Node name(world, NAME);
+    Redland::Node literal = Redland::Node::make_literal_node(world, "a");
+    CHECK(model.add_statement(world, nodeA, name, literal));
+    CHECK(model.add_statement(world, nodeB, name, Redland::Node::make_literal_node(world, "b")));
+    {
+        int count = 0;
+        Redland::StatementRef pattern(world, Redland::Node(), name, Redland::Node());
+        for (Redland::Stream stream = model.find_statements(pattern); !stream.end(); stream.next())
+        {
+            CHECK(stream.current() != NULL);
+            ++count;
+        }
+        CHECK_EQUAL(count, 2);
+    }
+    {
+        Redland::Stream stream;
+        TripleView triple = find_triple_view(ctx, stream, nodeA, name, Redland::Node());
+        CHECK(triple.is_valid());
+        CHECK(triple.subject == NodeView(nodeA));
+        CHECK(triple.object == NodeView(literal));
+
+        // Reusing the stream releases the previous query
+        triple = find_triple_view(ctx, stream, nodeA, Redland::Node(world, WEIGHT), Redland::Node());
+        CHECK(!triple.is_valid());
+        CHECK(stream.current() == NULL);
+    }
+    CHECK_EQUAL(find_triples(ctx, Redland::Node(), name, Redland::Node()).size(), 2u);
+    CHECK(find_triple(ctx, nodeB, name, Redland::Node()).object.c_obj() != NULL);
+
+    // Time of the lookups with a reused stream compared with copying the
+    // matched statement
+    {
+        const int runs = 10000;
+        size_t found = 0;
+        Redland::Stream stream;
+        const double viewTime = measure(runs, [&]() {
+            found += find_triple_view(ctx, stream, nodeA, name, Redland::Node()).is_valid() ? 1 : 0;
+        });
+        const double copyTime = measure(runs, [&]() {
+            found += find_triple(ctx, nodeA, name, Redland::Node()).object.c_obj() ? 1 : 0;
+        });
+        std::printf("per lookup: find_triple_view %.3f us, find_triple %.3f us\n", viewTime, copyTime);
+        CHECK_EQUAL(found, static_cast<size_t>(2 * runs));
+    }
+
+    // The generated readers find their members with find_triple_view
+    {
+        Group group;
+        group.setName("g");
+        Items items;
+        items.push_back(std::make_shared<Item>("x", 1.5));
+        items.push_back(std::make_shared<Item>("y", 2));
+        group.setItems(items);
+
+        Redland::Node node(world, BASE + "group");
+        toRDF(ctx, node, group);
+
+        Group read;
+        CHECK(fromRDF(ctx, node, read));
+        CHECK_EQUAL(read.getName(), "g");
+        CHECK_EQUAL(read.getItems().size(), 2u);
+        double weight = 0;
+        for (const std::shared_ptr<Item> &item : read.getItems())
+            weight += item->getWeight();
+        CHECK_EQUAL(weight, 3.5);
+    }
+
+    return TEST_RESULT();
+}
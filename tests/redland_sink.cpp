@@ -0,0 +1,109 @@
+/*  ARVIDAPP - ARVIDA C++ Preprocessor
+ *
+ *  Copyright (C) 2015-2019 German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+// Serialization into a Raptor serializer without a model
+
+#include "Test.hpp"
+#include "Scene_redland.hpp"
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace Arvida::RDF;
+
+static const std::string BASE = "http://example.com/scene/";
+
+static std::vector<std::string> lines(const std::string &text)
+{
+    std::vector<std::string> result;
+    std::istringstream in(text);
+    std::string line;
+    while (std::getline(in, line))
+    {
+        if (!line.empty())
+            result.push_back(line);
+    }
+    return result;
+}
+
+static size_t count(const std::vector<std::string> &lines, const std::string &part)
+{
+    size_t result = 0;
+    for (size_t i = 0; i < lines.size(); ++i)
+        result += lines[i].find(part) != std::string::npos ? 1 : 0;
+    return result;
+}
+
+// Output of toRDF through a sink in N-Triples
+static std::string serialize(Redland::World &world, Redland::Namespaces &namespaces, Redland::Model &model, const Group &group)
+{
+    Raptor::Serializer serializer(world, "ntriples");
+    CHECK(serializer.start_to_string());
+    Sink sink(world, serializer);
+    const std::string path = "group";
+    Context ctx(world, namespaces, model, BASE, path);
+    ctx.sink = &sink;
+    Redland::Node node(world, BASE + "group");
+    toRDF(ctx, node, group);
+    CHECK(serializer.end());
+    return serializer.str();
+}
+
+int main()
+{
+    Redland::World world;
+    Redland::Namespaces namespaces;
+    namespaces.add_prefix("rdf", "http://www.w3.org/1999/02/22-rdf-syntax-ns#");
+    namespaces.add_prefix("scene", "http://example.com/scene#");
+    Redland::Storage storage = Redland::Storage::make_memory_hashes(world, "test");
+    Redland::Model model(world, storage, "");
+
+    Group group;
+    group.setName("g");
+    Items items;
+    items.push_back(std::make_shared<Item>("x", 1.5));
+    items.push_back(std::make_shared<Item>("y", 2));
+    group.setItems(items);
+
+    // The statements written into a model are written to the serializer,
+    // the model is not used
+    const std::vector<std::string> written = lines(serialize(world, namespaces, model, group));
+    CHECK_EQUAL(model.size(), 0);
+    {
+        const std::string path = "group";
+        Context ctx(world, namespaces, model, BASE, path);
+        Redland::Node node(world, BASE + "group");
+        toRDF(ctx, node, group);
+    }
+    CHECK_EQUAL(written.size(), static_cast<size_t>(model.size()));
+    CHECK_EQUAL(count(written, "<http://example.com/scene#Group>"), 1u);
+    CHECK_EQUAL(count(written, "<http://example.com/scene#item>"), 2u);
+    CHECK_EQUAL(count(written, "<http://example.com/scene#weight>"), 2u);
+
+    // An object referenced twice is written once
+    {
+        Group twice;
+        twice.setName("t");
+        Items same(2, items[0]);
+        twice.setItems(same);
+        const std::vector<std::string> once = lines(serialize(world, namespaces, model, twice));
+        CHECK_EQUAL(count(once, "<http://example.com/scene#Item>"), 1u);
+        CHECK_EQUAL(count(once, "<http://example.com/scene#weight>"), 1u);
+    }
+
+    return TEST_RESULT();
+}
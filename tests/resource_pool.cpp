@@ -0,0 +1,140 @@
+/*  ARVIDAPP - ARVIDA C++ Preprocessor
+ *
+ *  Copyright (C) 2015-2019 German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+// Pool of reusable objects: reset on return, limit of idle objects and
+// leases of several threads
+
+#include "Test.hpp"
+#include "RDFPool.hpp"
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace Arvida::RDF;
+
+// Stands for a model, the world is kept and the statements are cleared
+struct Buffer
+{
+    int world;
+    std::vector<int> statements;
+    bool failing;
+
+    explicit Buffer(int world) : world(world), failing(false) { }
+
+    void clear()
+    {
+        if (failing)
+            throw std::runtime_error("cannot clear");
+        statements.clear();
+    }
+};
+
+int main()
+{
+    std::atomic<int> created(0);
+    ResourcePool<Buffer>::Factory factory = [&created]() {
+        return std::unique_ptr<Buffer>(new Buffer(++created));
+    };
+
+    // Returned objects are cleared and reused
+    {
+        ResourcePool<Buffer> pool(factory, 1);
+        CHECK_EQUAL(created.load(), 1);
+        CHECK_EQUAL(pool.idle(), 1u);
+        Buffer *first = 0;
+        {
+            ResourcePool<Buffer>::Lease lease = pool.checkout();
+            CHECK_EQUAL(pool.idle(), 0u);
+            first = lease.get();
+            lease->statements.push_back(1);
+        }
+        CHECK_EQUAL(pool.idle(), 1u);
+        ResourcePool<Buffer>::Lease lease = pool.checkout();
+        CHECK(lease.get() == first);
+        CHECK(lease->statements.empty());
+        CHECK_EQUAL(lease->world, 1);
+        CHECK_EQUAL(created.load(), 1);
+
+        // A moved lease returns the object once
+        ResourcePool<Buffer>::Lease moved(std::move(lease));
+        CHECK(!lease);
+        CHECK(moved.get() == first);
+        lease.release();
+        CHECK_EQUAL(pool.idle(), 0u);
+        moved.release();
+        CHECK_EQUAL(pool.idle(), 1u);
+    }
+
+    // A custom reset
+    {
+        created = 0;
+        ResourcePool<Buffer> pool(factory, [](Buffer &buffer) { buffer.statements.assign(1, -1); });
+        {
+            ResourcePool<Buffer>::Lease lease = pool.checkout();
+        }
+        CHECK_EQUAL(pool.checkout()->statements.size(), 1u);
+    }
+
+    // At most maxIdle objects are kept, objects which cannot be reset are
+    // dropped
+    {
+        created = 0;
+        ResourcePool<Buffer> pool(factory, 0, 2);
+        {
+            std::vector<ResourcePool<Buffer>::Lease> leases;
+            for (int i = 0; i < 4; ++i)
+                leases.push_back(pool.checkout());
+            CHECK_EQUAL(created.load(), 4);
+        }
+        CHECK_EQUAL(pool.idle(), 2u);
+        {
+            ResourcePool<Buffer>::Lease lease = pool.checkout();
+            lease->failing = true;
+        }
+        CHECK_EQUAL(pool.idle(), 1u);
+    }
+
+    // Threads lease objects concurrently, no object is used twice
+    {
+        created = 0;
+        ResourcePool<Buffer> pool(factory, 0, 4);
+        std::atomic<int> errors(0);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 8; ++t)
+        {
+            threads.emplace_back([&pool, &errors, t]() {
+                for (int i = 0; i < 1000; ++i)
+                {
+                    ResourcePool<Buffer>::Lease lease = pool.checkout();
+                    if (!lease->statements.empty())
+                        ++errors;
+                    lease->statements.push_back(t);
+                    std::this_thread::yield();
+                    if (lease->statements.size() != 1 || lease->statements[0] != t)
+                        ++errors;
+                }
+            });
+        }
+        for (size_t i = 0; i < threads.size(); ++i)
+            threads[i].join();
+        CHECK_EQUAL(errors.load(), 0);
+        CHECK(pool.idle() <= 4u);
+    }
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,104 @@
+#!/bin/sh
+# Builds and runs the tests
+#
+# Usage: tests/run_tests.sh [BUILD_DIR] [TEST...]
+#
+# Tests named sord_* and redland_* are linked with Sord resp. Redland and are
+# skipped when the library is not found by pkg-config. Code generated from a
+# header <Name>.h of the tests directory is written to BUILD_DIR (included as
+# "<Name>_<template>.hpp", or "<Name>_<template>_tables.hpp" for code
+# generated with --schema-tables).
+#
+# Environment:
+#   CXX, CXXFLAGS             compiler and flags (default: c++ -std=c++11 -O1 -g)
+#   ARVIDAPP_GEN              generator command (default: python3 arvidapp_gen.py)
+#   ARVIDAPP_CLANG_FLAGS      additional flags for clang in the generator
+#   SORD_CFLAGS, SORD_LIBS    flags for Sord (default: pkg-config sord-0)
+#   REDLAND_CFLAGS, REDLAND_LIBS  flags for Redland (default: pkg-config redland)
+
+TESTS_DIR=$(cd "$(dirname "$0")" && pwd)
+ROOT_DIR=$(dirname "$TESTS_DIR")
+BUILD_DIR=${1:-"$ROOT_DIR/_test_build"}
+[ $# -gt 0 ] && shift
+
+CXX=${CXX:-c++}
+CXXFLAGS=${CXXFLAGS:-"-std=c++11 -O1 -g"}
+ARVIDAPP_GEN=${ARVIDAPP_GEN:-"python3 $ROOT_DIR/arvidapp_gen.py"}
+
+if [ -z "$SORD_LIBS" ] && pkg-config --exists sord-0 2>/dev/null; then
+    SORD_CFLAGS=$(pkg-config --cflags sord-0)
+    SORD_LIBS=$(pkg-config --libs sord-0)
+fi
+if [ -z "$REDLAND_LIBS" ] && pkg-config --exists redland 2>/dev/null; then
+    REDLAND_CFLAGS=$(pkg-config --cflags redland)
+    REDLAND_LIBS=$(pkg-config --libs redland)
+fi
+
+mkdir -p "$BUILD_DIR" || exit 1
+
+if [ $# -gt 0 ]; then
+    TESTS="$*"
+else
+    TESTS=$(cd "$TESTS_DIR" && ls *.cpp | sed 's/\.cpp$//')
+fi
+
+passed=0
+failed=0
+skipped=0
+
+for test in $TESTS; do
+    source="$TESTS_DIR/$test.cpp"
+    cflags=""
+    libs=""
+    case "$test" in
+        sord_*)
+            if [ -z "$SORD_LIBS" ]; then
+                echo "SKIP $test (Sord not found)"
+                skipped=$((skipped + 1))
+                continue
+            fi
+            cflags="$SORD_CFLAGS"
+            libs="$SORD_LIBS"
+            ;;
+        redland_*)
+            if [ -z "$REDLAND_LIBS" ]; then
+                echo "SKIP $test (Redland not found)"
+                skipped=$((skipped + 1))
+                continue
+            fi
+            cflags="$REDLAND_CFLAGS"
+            libs="$REDLAND_LIBS"
+            ;;
+    esac
+
+    # Generate the code included by the test
+    ok=1
+    for name in $(sed -n 's/^#include "\([A-Za-z]*_[a-z]*\(_tables\)\{0,1\}\)\.hpp"/\1/p' "$source"); do
+        base=${name%_tables}
+        flags=""
+        [ "$base" != "$name" ] && flags="--schema-tables"
+        header="$TESTS_DIR/${base%_*}.h"
+        template=${base##*_}
+        [ -f "$header" ] || continue
+        generated="$BUILD_DIR/$name.hpp"
+        if [ ! -f "$generated" ] || [ "$header" -nt "$generated" ]; then
+            if ! $ARVIDAPP_GEN -t "$template" $flags -- -I"$ROOT_DIR/include" -I"$TESTS_DIR" \
+                    $ARVIDAPP_CLANG_FLAGS "$header" > "$generated"; then
+                rm -f "$generated"
+                ok=0
+            fi
+        fi
+    done
+
+    if [ $ok = 1 ] && $CXX $CXXFLAGS -I"$ROOT_DIR/include" -I"$TESTS_DIR" -I"$BUILD_DIR" $cflags \
+            -o "$BUILD_DIR/$test" "$source" $libs -lpthread && "$BUILD_DIR/$test"; then
+        echo "PASS $test"
+        passed=$((passed + 1))
+    else
+        echo "FAIL $test"
+        failed=$((failed + 1))
+    fi
+done
+
+echo "$passed passed, $failed failed, $skipped skipped"
+[ $failed = 0 ]
@@ -0,0 +1,111 @@
+/*  ARVIDAPP - ARVIDA C++ Preprocessor
+ *
+ *  Copyright (C) 2015-2019 German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+// Lazy members: loading on first access, owner of the model, failed loads
+
+#include "Test.hpp"
+#include "Library_sord.hpp"
+#include <memory>
+#include <string>
+
+using namespace Arvida::RDF;
+
+static const std::string BASE = "http://example.com/library/shelf";
+
+static std::shared_ptr<WorldModel> writeShelf(bool withBook)
+{
+    Prefixes prefixes;
+    prefixes["rdf"] = "http://www.w3.org/1999/02/22-rdf-syntax-ns#";
+    prefixes["lib"] = "http://example.com/library#";
+    std::shared_ptr<WorldModel> wm = std::make_shared<WorldModel>(BASE, prefixes);
+
+    Sord::Node node = Sord::URI(wm->world, BASE);
+    if (!withBook)
+    {
+        // The book node is referenced but has no statements
+        wm->model.add_statement(node, Sord::Curie(wm->world, "rdf:type"), Sord::Curie(wm->world, "lib:Shelf"));
+        wm->model.add_statement(node, Sord::Curie(wm->world, "lib:label"), Sord::Literal(wm->world, "shelf"));
+        wm->model.add_statement(node, Sord::Curie(wm->world, "lib:book"), Sord::URI(wm->world, BASE + "/book"));
+        return wm;
+    }
+
+    std::shared_ptr<Book> book = std::make_shared<Book>();
+    book->setTitle("title");
+    Shelf shelf;
+    shelf.setLabel("shelf");
+    shelf.setBook(book);
+    Context ctx(wm->model, BASE);
+    toRDF(ctx, node, shelf);
+    return wm;
+}
+
+static bool readShelf(const std::shared_ptr<WorldModel> &wm, const std::shared_ptr<const void> &owner, Shelf &shelf)
+{
+    Context ctx(wm->model, BASE);
+    ctx.owner = owner;
+    Sord::Node node = Sord::URI(wm->world, BASE);
+    return fromRDF(ctx, node, shelf);
+}
+
+int main()
+{
+    // The book is read on first access, isValidValue does not load it
+    {
+        std::shared_ptr<WorldModel> wm = writeShelf(true);
+        Shelf shelf;
+        CHECK(readShelf(wm, unownedModel(wm->model), shelf));
+        CHECK_EQUAL(shelf.getLabel(), "shelf");
+        CHECK(!shelf.getBook().is_loaded());
+        CHECK(isValidValue(shelf.getBook()));
+        CHECK(!shelf.getBook().is_loaded());
+        CHECK(shelf.getBook().get());
+        CHECK(shelf.getBook().is_loaded());
+        CHECK_EQUAL(shelf.getBook()->getTitle(), "title");
+    }
+
+    // The owner keeps the model alive
+    {
+        Shelf shelf;
+        {
+            std::shared_ptr<WorldModel> wm = writeShelf(true);
+            CHECK(readShelf(wm, wm, shelf));
+        }
+        CHECK(shelf.getBook().get());
+        CHECK(shelf.getBook().get() && shelf.getBook()->getTitle() == "title");
+    }
+
+    // Errors of the book are detected on access
+    {
+        std::shared_ptr<WorldModel> wm = writeShelf(false);
+        Shelf shelf;
+        CHECK(readShelf(wm, wm, shelf));
+        CHECK(isValidValue(shelf.getBook()));
+        CHECK(!shelf.getBook().get());
+        CHECK(!isValidValue(shelf.getBook()));
+    }
+
+#ifdef NDEBUG
+    // Lazy members are not read without an owner
+    {
+        std::shared_ptr<WorldModel> wm = writeShelf(true);
+        Shelf shelf;
+        CHECK(!readShelf(wm, std::shared_ptr<const void>(), shelf));
+    }
+#endif
+
+    return TEST_RESULT();
+}
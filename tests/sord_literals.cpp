@@ -0,0 +1,119 @@
+/*  ARVIDAPP - ARVIDA C++ Preprocessor
+ *
+ *  Copyright (C) 2015-2019 German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+// Numeric and string literals of the Sord traits, and node views
+
+#include "Test.hpp"
+#include "Library_sord.hpp"
+#include <string>
+
+using namespace Arvida::RDF;
+
+static const std::string BASE = "http://example.com/library/book";
+
+static Sord::Node typedLiteral(Sord::World &world, const char *lexical, const char *datatype)
+{
+    const SerdNode val = serd_node_from_string(SERD_LITERAL, (const uint8_t*) lexical);
+    const SerdNode type = serd_node_from_string(SERD_URI, (const uint8_t*) datatype);
+    return Sord::Node(world, sord_node_from_serd_node(world.c_obj(), world.prefixes().c_obj(), &val, &type, NULL), false);
+}
+
+int main()
+{
+    Prefixes prefixes;
+    prefixes["rdf"] = "http://www.w3.org/1999/02/22-rdf-syntax-ns#";
+    prefixes["lib"] = "http://example.com/library#";
+
+    // Floats are written as xsd:float and read back
+    {
+        WorldModel wm(BASE, prefixes);
+        Book book;
+        book.setTitle("title");
+        book.setRating(2.75f);
+        Context ctx(wm.model, BASE);
+        Sord::Node node = Sord::URI(wm.world, BASE);
+        toRDF(ctx, node, book);
+
+        Book read;
+        CHECK(fromRDF(ctx, node, read));
+        CHECK_EQUAL(read.getTitle(), "title");
+        CHECK_EQUAL(read.getRating(), 2.75f);
+    }
+
+    // Views reference the nodes of the statements without copying them
+    {
+        WorldModel wm(BASE, prefixes);
+        Book book;
+        book.setTitle("viewed");
+        book.setRating(0.5f);
+        Context ctx(wm.model, BASE);
+        Sord::Node node = Sord::URI(wm.world, BASE);
+        toRDF(ctx, node, book);
+
+        const Sord::Node rating = Sord::URI(wm.world, "http://example.com/library#rating");
+        TripleView triple = find_triple_view(wm.model, node, rating, Sord::Node());
+        CHECK(triple.is_valid());
+        CHECK(triple.subject.is_uri() && triple.subject.c_obj() == node.c_obj());
+        CHECK(triple.predicate == NodeView(wm.world, rating.c_obj()));
+        CHECK(triple.object.is_literal_type(SORD_NS_XSD "float"));
+        CHECK(!triple.object.is_literal_type(SORD_NS_XSD "double"));
+        float value = 0;
+        CHECK(fromRDF(ctx, triple.object, value) && value == 0.5f);
+        const Sord::Node copy = triple.object;
+        CHECK(copy.c_obj() == triple.object.c_obj());
+
+        const Sord::Node title = Sord::URI(wm.world, "http://example.com/library#title");
+        triple = find_triple_view(wm.model, node, title, Sord::Node());
+        StringRef ref;
+        CHECK(readStringRef(triple.object, ref) && ref == StringRef("viewed"));
+
+        CHECK_EQUAL(find_triples_view(wm.model, node, Sord::Node(), Sord::Node()).size(), 3u);
+        CHECK(!find_triple_view(wm.model, rating, Sord::Node(), Sord::Node()).is_valid());
+        CHECK(!NodeView().is_valid() && !NodeView().is_literal());
+    }
+
+    // Numeric datatypes are accepted, other datatypes and invalid lexical
+    // forms are not
+    {
+        WorldModel wm(BASE, prefixes);
+        Context ctx(wm.model, BASE);
+        float f = 0;
+        double d = 0;
+        Sord::Node node = typedLiteral(wm.world, "1.5", SORD_NS_XSD "float");
+        CHECK(fromRDF(ctx, node, f) && f == 1.5f);
+        node = typedLiteral(wm.world, "7", SORD_NS_XSD "integer");
+        CHECK(fromRDF(ctx, node, f) && f == 7);
+        node = typedLiteral(wm.world, "-0.25", SORD_NS_XSD "decimal");
+        CHECK(fromRDF(ctx, node, d) && d == -0.25);
+        node = typedLiteral(wm.world, "1e3", SORD_NS_XSD "double");
+        CHECK(fromRDF(ctx, node, d) && d == 1000);
+        node = typedLiteral(wm.world, "heavy", SORD_NS_XSD "float");
+        CHECK(!fromRDF(ctx, node, f));
+        node = typedLiteral(wm.world, "1.5abc", SORD_NS_XSD "double");
+        CHECK(!fromRDF(ctx, node, d));
+        node = typedLiteral(wm.world, "2 3", SORD_NS_XSD "float");
+        CHECK(!fromRDF(ctx, node, f));
+        node = typedLiteral(wm.world, " ", SORD_NS_XSD "double");
+        CHECK(!fromRDF(ctx, node, d));
+        node = typedLiteral(wm.world, "2.5 ", SORD_NS_XSD "double");
+        CHECK(fromRDF(ctx, node, d) && d == 2.5);
+        node = typedLiteral(wm.world, "1.5", SORD_NS_XSD "string");
+        CHECK(!fromRDF(ctx, node, d));
+    }
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,138 @@
+/*  ARVIDAPP - ARVIDA C++ Preprocessor
+ *
+ *  Copyright (C) 2015-2019 German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+// Code generated with --schema-tables, and the backend of the schema
+// engine: skeletons with a cache shared by models of different worlds
+
+#include "Test.hpp"
+#include "Scene_sord_tables.hpp"
+#include <string>
+
+using namespace Arvida::RDF;
+
+static const std::string BASE = "http://example.com/scene/";
+static const char *TYPE = "http://www.w3.org/1999/02/22-rdf-syntax-ns#type";
+static const char *GROUP = "http://example.com/scene#Group";
+static const char *KIND = "http://example.com/scene#kind";
+
+static const SchemaTriple TRIPLES[] = {
+    { { SCHEMA_THIS, 0, 0 }, { SCHEMA_IRI, TYPE, 0 }, { SCHEMA_IRI, GROUP, 0 } },
+    { { SCHEMA_THIS, 0, 0 }, { SCHEMA_IRI, KIND, 0 }, { SCHEMA_BLANK, "k", 0 } },
+};
+static const SchemaSkeleton SKELETON = { "Group", TRIPLES, 2 };
+
+static bool hasSkeleton(WorldModel &wm, const std::string &subject)
+{
+    Sord::URI node(wm.world, subject);
+    Sord::URI type(wm.world, TYPE);
+    Sord::URI group(wm.world, GROUP);
+    Sord::URI kind(wm.world, KIND);
+    return !wm.model.find(node, type, group).end() && !wm.model.find(node, kind, Sord::Node()).end();
+}
+
+static bool hasStatement(WorldModel &wm, const std::string &subject, const char *predicate, const Sord::Node &object)
+{
+    Sord::URI node(wm.world, subject);
+    Sord::URI property(wm.world, predicate);
+    return !wm.model.find(node, property, object).end();
+}
+
+int main()
+{
+    // Item and Tag are described by tables, Group with its container is
+    // generated inline and uses them for its elements
+    {
+        const SchemaClass &item = Schema<Item>::get();
+        CHECK_EQUAL(std::string(item.name), "::Item");
+        CHECK_EQUAL(item.memberCount, 5u);
+        CHECK_EQUAL(item.members[0].tripleCount, 1u);
+        CHECK_EQUAL(std::string(item.members[0].triples[0].object.value), "http://example.com/scene#Item");
+        const SchemaClass &tag = Schema<Tag>::get();
+        CHECK_EQUAL(std::string(tag.path), "tag/{$this->getId()}");
+
+        WorldModel wm(BASE);
+        Context ctx(wm.model, BASE, &wm.cache);
+        Group group;
+        group.setName("g");
+        Items items;
+        items.push_back(std::make_shared<Item>("x", 1.5));
+        items.push_back(std::make_shared<Item>("y", -2));
+        group.setItems(items);
+        Sord::Node node = Sord::URI(wm.world, BASE + "g");
+        toRDF(ctx, node, group);
+        CHECK(hasStatement(wm, BASE + "x", TYPE, Sord::URI(wm.world, "http://example.com/scene#Item")));
+        CHECK(hasStatement(wm, BASE + "x", "http://example.com/scene#weight", Sord::Node()));
+
+        Group read;
+        CHECK(fromRDF(ctx, node, read));
+        CHECK_EQUAL(read.getName(), "g");
+        CHECK_EQUAL(read.getItems().size(), 2u);
+        double weight = 0;
+        for (size_t i = 0; i < read.getItems().size(); ++i)
+            weight += read.getItems()[i]->getWeight();
+        CHECK_EQUAL(weight, -0.5);
+
+        // The path of the table
+        const std::shared_ptr<Tag> tag7 = std::make_shared<Tag>(7, "seven");
+        createRDFNodeAndSerialize<const std::shared_ptr<Tag> &>(ctx, tag7, NO_PATH, "");
+        CHECK(hasStatement(wm, BASE + "tag/7", "http://example.com/scene#label", Sord::Node()));
+
+        // A missing member fails the read
+        Sord::Node itemNode = Sord::URI(wm.world, BASE + "z");
+        wm.model.add_statement(itemNode, Sord::URI(wm.world, TYPE), Sord::URI(wm.world, "http://example.com/scene#Item"));
+        wm.model.add_statement(itemNode, Sord::URI(wm.world, "http://example.com/scene#name"), Sord::Literal(wm.world, "z"));
+        CHECK(hasStatement(wm, BASE + "z", "http://example.com/scene#name", Sord::Node()));
+        Item partial;
+        CHECK(!fromRDF(ctx, itemNode, partial));
+
+        // unless the mask does not include it
+        CHECK(fromRDF(ctx, itemNode, partial, Members<Item>::setName));
+        CHECK_EQUAL(partial.getName(), "z");
+    }
+
+    // The cache holds nodes of both worlds, so it is destroyed first
+    WorldModel first(BASE);
+    WorldModel second(BASE);
+    Cache cache;
+    WorldModel *models[] = { &first, &second, &first };
+    for (int i = 0; i < 3; ++i)
+    {
+        WorldModel &wm = *models[i];
+        Context ctx(wm.model, BASE, &cache);
+        const std::string subject = BASE + std::to_string(i);
+        Node _this = Sord::URI(wm.world, subject);
+        Node blank = Node::blank_id(wm.world);
+        Node *const blanks[] = { &blank };
+        addSkeleton(ctx, SKELETON, _this, blanks);
+        CHECK(hasSkeleton(wm, subject));
+    }
+    CHECK_EQUAL(first.model.num_quads(), 4u);
+    CHECK_EQUAL(second.model.num_quads(), 2u);
+
+    // Without a cache
+    {
+        WorldModel wm(BASE);
+        Context ctx(wm.model, BASE);
+        Node _this = Sord::URI(wm.world, BASE);
+        Node blank = Node::blank_id(wm.world);
+        Node *const blanks[] = { &blank };
+        addSkeleton(ctx, SKELETON, _this, blanks);
+        CHECK(hasSkeleton(wm, BASE));
+    }
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,116 @@
+/*  ARVIDAPP - ARVIDA C++ Preprocessor
+ *
+ *  Copyright (C) 2015-2019 German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+// Several readers use the snapshots of one holder while a writer publishes
+
+#include "Test.hpp"
+#include "Scene_sord.hpp"
+#include "SordRDFSnapshot.hpp"
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Arvida::RDF;
+
+static const std::string BASE = "http://example.com/scene/";
+
+static void writeVersion(WorldModel &wm, int version)
+{
+    Group group;
+    group.setName("v" + std::to_string(version));
+    Items items;
+    for (int i = 0; i <= version % 7; ++i)
+        items.push_back(std::make_shared<Item>("i" + std::to_string(i), version));
+    group.setItems(items);
+
+    Context ctx(wm.model, BASE);
+    Sord::Node node = Sord::URI(wm.world, BASE);
+    toRDF(ctx, node, group);
+}
+
+int main()
+{
+    ModelSnapshotHolder holder;
+
+    // A reader without a published snapshot has no model
+    {
+        SnapshotReader reader(holder, BASE);
+        CHECK(!reader.update());
+    }
+
+    // The model is only read again when a new snapshot is published
+    {
+        WorldModel wm(BASE);
+        writeVersion(wm, 3);
+        holder.emplace(wm.model);
+        SnapshotReader reader(holder, BASE);
+        std::shared_ptr<WorldModel> first = reader.update();
+        CHECK(first);
+        CHECK(reader.update() == first);
+        CHECK_EQUAL(first->model.num_quads(), wm.model.num_quads());
+        holder.emplace(wm.model);
+        CHECK(reader.update() != first);
+    }
+
+    const int versions = 200;
+    std::atomic<bool> stop(false);
+    std::atomic<long> reads(0);
+    std::atomic<long> errors(0);
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 4; ++r)
+    {
+        readers.emplace_back([&]() {
+            SnapshotReader reader(holder, BASE);
+            do
+            {
+                const std::shared_ptr<WorldModel> &wm = reader.update();
+                if (!wm)
+                    continue;
+                Group group;
+                Context ctx(wm->model, BASE);
+                Sord::Node node = Sord::URI(wm->world, BASE);
+                if (!fromRDF(ctx, node, group) || group.getName().size() < 2)
+                {
+                    ++errors;
+                    continue;
+                }
+                const int version = std::stoi(group.getName().substr(1));
+                const Items &items = group.getItems();
+                if (items.size() != size_t(version % 7 + 1) || items.back()->getWeight() != version)
+                    ++errors;
+                ++reads;
+            } while (!stop.load());
+        });
+    }
+
+    for (int version = 1; version <= versions; ++version)
+    {
+        WorldModel wm(BASE);
+        writeVersion(wm, version);
+        holder.emplace(wm.model);
+    }
+    stop = true;
+    for (size_t i = 0; i < readers.size(); ++i)
+        readers[i].join();
+
+    CHECK(reads.load() >= long(readers.size()));
+    CHECK_EQUAL(errors.load(), 0);
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,291 @@
+/*  ARVIDAPP - ARVIDA C++ Preprocessor
+ *
+ *  Copyright (C) 2015-2019 German Research Center for Artificial Intelligence (DFKI)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+// Traversal orders and resumption of the resumable serializer, and
+// serialization and deserialization of object graphs deeper than the
+// recursion limit
+
+#include "Test.hpp"
+#include "Scene_sord.hpp"
+#include "SordRDFSerializer.hpp"
+#include <algorithm>
+#include <chrono>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace Arvida::RDF;
+
+static const std::string BASE = "http://example.com/scene/";
+static const char *NEXT = "http://example.com/scene#next";
+
+static SceneNodePtr node(const std::string &name, const SceneNodes &children = SceneNodes())
+{
+    SceneNodePtr result = std::make_shared<SceneNode>();
+    result->setName(name);
+    result->setChildren(children);
+    return result;
+}
+
+// Names of the objects in the order in which the serializer wrote them
+static std::vector<std::string> serializationOrder(const SceneNode &root, TraversalOrder order)
+{
+    Sord::World world;
+    Sord::Model model(world, BASE);
+    Serializer serializer(model, BASE, 0, 0, order);
+    serializer.start(root);
+
+    std::vector<std::string> names;
+    std::set<std::string> seen;
+    const Sord::URI name(world, "http://example.com/scene#name");
+    bool done = false;
+    while (!done)
+    {
+        done = serializer.step(1);
+        for (Sord::Iter it = model.find(Sord::Node(), name, Sord::Node()); !it.end(); ++it)
+        {
+            const std::string value = it.get_object().to_string();
+            if (seen.insert(value).second)
+                names.push_back(value);
+        }
+    }
+    return names;
+}
+
+struct Chain;
+
+namespace Arvida {
+namespace RDF {
+
+template<>
+inline PathType pathTypeOf(const Context &ctx, const Chain &value)
+{
+    return NO_PATH;
+}
+
+template<>
+inline std::string pathOf(const Context &ctx, const Chain &value)
+{
+    return std::string();
+}
+
+} // namespace RDF
+} // namespace Arvida
+
+// Chain of blank nodes with hand-written toRDF and fromRDF, which record the
+// depth of native recursion
+struct Chain
+{
+    std::shared_ptr<Chain> next;
+
+    static int depth;
+    static int maxDepth;
+
+    struct Nesting
+    {
+        Nesting() { maxDepth = std::max(maxDepth, ++depth); }
+        ~Nesting() { --depth; }
+    };
+
+    NodeRef toRDF(const Context &ctx, NodeRef _this) const
+    {
+        Nesting nesting;
+        if (next)
+            ctx.model.add_statement(_this, Sord::URI(ctx.model.world(), NEXT),
+                                    createRDFNodeAndSerialize<const std::shared_ptr<Chain> &>(ctx, next, NO_PATH, ""));
+        return _this;
+    }
+
+    bool fromRDF(const Context &ctx, NodeRef _this)
+    {
+        Nesting nesting;
+        TripleView triple = find_triple_view(ctx.model, _this, Sord::URI(ctx.model.world(), NEXT), Sord::Node());
+        if (!triple.is_valid())
+            return true;
+        next = std::make_shared<Chain>();
+        Node object = triple.object;
+        return Arvida::RDF::fromRDF(ctx, object, next);
+    }
+
+    size_t length() const
+    {
+        size_t result = 1;
+        for (const Chain *chain = next.get(); chain; chain = chain->next.get())
+            ++result;
+        return result;
+    }
+};
+
+int Chain::depth = 0;
+int Chain::maxDepth = 0;
+
+static std::shared_ptr<Chain> makeChain(size_t length)
+{
+    std::shared_ptr<Chain> head = std::make_shared<Chain>();
+    Chain *tail = head.get();
+    for (size_t i = 1; i < length; ++i)
+    {
+        tail->next = std::make_shared<Chain>();
+        tail = tail->next.get();
+    }
+    return head;
+}
+
+// Releases a long chain without recursion
+static void releaseChain(std::shared_ptr<Chain> chain)
+{
+    while (chain)
+        chain = std::move(chain->next);
+}
+
+int main()
+{
+    SceneNode root;
+    root.setName("root");
+    SceneNodes children;
+    children.push_back(node("a", SceneNodes{node("a1"), node("a2", SceneNodes{node("a21")})}));
+    children.push_back(node("b", SceneNodes{node("b1")}));
+    root.setChildren(children);
+
+    // Depth-first serializes in pre-order like recursive serialization
+    const std::vector<std::string> depthFirst = serializationOrder(root, DEPTH_FIRST);
+    const std::vector<std::string> preOrder = { "root", "a", "a1", "a2", "a21", "b", "b1" };
+    CHECK(depthFirst == preOrder);
+
+    // Breadth-first serializes level by level
+    const std::vector<std::string> breadthFirst = serializationOrder(root, BREADTH_FIRST);
+    const std::vector<std::string> levelOrder = { "root", "a", "b", "a1", "a2", "b1", "a21" };
+    CHECK(breadthFirst == levelOrder);
+
+    // Both write the same statements as recursive serialization
+    {
+        Sord::World world;
+        Sord::Model recursive(world, BASE), depth(world, BASE), breadth(world, BASE);
+        Context ctx(recursive, BASE);
+        Sord::Node node = Sord::URI(world, BASE);
+        toRDF(ctx, node, root);
+        Context depthCtx(depth, BASE);
+        toRDFIterative(depthCtx, node, root, DEPTH_FIRST);
+        Context breadthCtx(breadth, BASE);
+        toRDFIterative(breadthCtx, node, root, BREADTH_FIRST);
+        CHECK_EQUAL(depth.num_quads(), recursive.num_quads());
+        CHECK_EQUAL(breadth.num_quads(), recursive.num_quads());
+    }
+
+    // Stepping resumes where the previous step stopped, a step adds at least
+    // its budget of triples unless the serializer is done
+    {
+        SceneNodes wide;
+        for (int i = 0; i < 30; ++i)
+        {
+            const std::string name = "n" + std::to_string(i);
+            wide.push_back(node(name, SceneNodes{node(name + "a"), node(name + "b"), node(name + "c")}));
+        }
+        SceneNode wideRoot;
+        wideRoot.setName("wide");
+        wideRoot.setChildren(wide);
+
+        Sord::World world;
+        Sord::Model recursive(world, BASE);
+        Context ctx(recursive, BASE);
+        Sord::Node node = Sord::URI(world, BASE);
+        toRDF(ctx, node, wideRoot);
+
+        Sord::Model stepped(world, BASE);
+        Serializer serializer(stepped, BASE);
+        serializer.start(wideRoot);
+        CHECK(!serializer.done());
+        int steps = 0;
+        bool budgetKept = true;
+        for (bool done = false; !done; ++steps)
+        {
+            const size_t before = stepped.num_quads();
+            done = serializer.step(20);
+            budgetKept = budgetKept && (done || stepped.num_quads() - before >= 20);
+        }
+        CHECK(budgetKept);
+        CHECK(steps > 2);
+        CHECK(serializer.done());
+        CHECK_EQUAL(serializer.pending(), 0u);
+        CHECK_EQUAL(stepped.num_quads(), recursive.num_quads());
+
+        // An exhausted time budget still runs one object per step
+        Sord::Model timed(world, BASE);
+        Serializer timedSerializer(timed, BASE);
+        timedSerializer.start(wideRoot);
+        int timedSteps = 0;
+        while (!timedSerializer.stepFor(std::chrono::nanoseconds(0)))
+            ++timedSteps;
+        CHECK(timedSteps > 30);
+        CHECK_EQUAL(timed.num_quads(), recursive.num_quads());
+
+        // reset() drops the remaining work
+        Sord::Model dropped(world, BASE);
+        Serializer droppedSerializer(dropped, BASE);
+        droppedSerializer.start(wideRoot);
+        CHECK(!droppedSerializer.step(1));
+        CHECK(droppedSerializer.pending() > 0);
+        droppedSerializer.reset();
+        CHECK(droppedSerializer.done());
+        CHECK(dropped.num_quads() < recursive.num_quads());
+    }
+
+    const size_t length = 20000;
+    std::shared_ptr<Chain> chain = makeChain(length);
+    Sord::World world;
+    Sord::Model model(world, BASE);
+    Sord::Node head = Sord::Node::blank_id(world);
+
+    // toRDF switches to a work queue beyond the recursion limit
+    {
+        Context ctx(model, BASE);
+        Chain::maxDepth = 0;
+        toRDF(ctx, head, *chain);
+        CHECK_EQUAL(model.num_quads(), length - 1);
+        CHECK(Chain::maxDepth <= ARVIDA_RDF_MAX_RECURSION_DEPTH + 2);
+    }
+    releaseChain(std::move(chain));
+
+    // fromRDF recurses, so nested objects are read before they are passed
+    // on; deep object graphs are read with fromRDFIterative
+    {
+        const size_t shortLength = 2 * ARVIDA_RDF_MAX_RECURSION_DEPTH;
+        std::shared_ptr<Chain> shortChain = makeChain(shortLength);
+        Sord::Model shortModel(world, BASE);
+        Sord::Node shortHead = Sord::Node::blank_id(world);
+        Context ctx(shortModel, BASE);
+        toRDF(ctx, shortHead, *shortChain);
+        Chain read;
+        Chain::maxDepth = 0;
+        CHECK(fromRDF(ctx, shortHead, read));
+        CHECK_EQUAL(read.length(), shortLength);
+        CHECK_EQUAL(Chain::maxDepth, static_cast<int>(shortLength));
+    }
+
+    // fromRDFIterative does not recurse at all
+    {
+        Context ctx(model, BASE);
+        Chain read;
+        Chain::maxDepth = 0;
+        CHECK(fromRDFIterative(ctx, head, read));
+        CHECK_EQUAL(read.length(), length);
+        CHECK_EQUAL(Chain::maxDepth, 1);
+        releaseChain(std::move(read.next));
+    }
+
+    return TEST_RESULT();
+}